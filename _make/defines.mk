@@ -435,7 +435,7 @@ endif
 
 ifeq ($(PTHREAD),1)
 CXXFLAGS  += -DRAI_PTHREAD
-LIBS += -lpthread
+LIBS += -lpthread -lrt
 endif
 
 ifeq ($(SWIFT),1)
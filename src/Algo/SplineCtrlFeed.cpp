@@ -14,7 +14,14 @@ void BSplineCtrlReference::waitForInitialized(){
 
 void BSplineCtrlReference::getReference(arr& q_ref, arr& qDot_ref, arr& qDDot_ref, const arr& q_real, const arr& qDot_real, double ctrlTime){
   if(!spline.get()->ctrlPoints.N) initialize(q_real, qDot_real, ctrlTime);
-  spline.get() -> eval(q_ref, qDot_ref, qDDot_ref, ctrlTime);
+  {
+    auto splineGet = spline.get();
+    if(spline.last_read_revision!=ctrlEvalRevision){ //only compile when the spline changed
+      ctrlEval.compile(splineGet());
+      ctrlEvalRevision = spline.last_read_revision;
+    }
+  }
+  ctrlEval.eval(q_ref, qDot_ref, qDDot_ref, ctrlTime);
 }
 
 void BSplineCtrlReference::append(const arr& x, const arr& t, double ctrlTime){
@@ -95,7 +102,14 @@ void CubicSplineCtrlReference::waitForInitialized(){
 
 void CubicSplineCtrlReference::getReference(arr& q_ref, arr& qDot_ref, arr& qDDot_ref, const arr& q_real, const arr& qDot_real, double ctrlTime){
   if(!spline.get()->times.N) initialize(q_real, qDot_real, ctrlTime);
-  spline.get() -> eval(q_ref, qDot_ref, qDDot_ref, ctrlTime);
+  {
+    auto splineGet = spline.get();
+    if(spline.last_read_revision!=ctrlEvalRevision){ //only compile when the spline changed
+      ctrlEval.compile(splineGet());
+      ctrlEvalRevision = spline.last_read_revision;
+    }
+  }
+  ctrlEval.eval(q_ref, qDot_ref, qDDot_ref, ctrlTime);
 }
 
 void CubicSplineCtrlReference::append(const arr& x, const arr& v, const arr& t, double ctrlTime){
@@ -13,6 +13,8 @@ struct ReferenceFeed {
 
 struct BSplineCtrlReference : ReferenceFeed {
   Var<BSpline> spline;
+  SplineEvaluator ctrlEval; ///< spline compiled for the control loop, recompiled on new spline revisions
+  int ctrlEvalRevision=-1;
   uint degree=3;
 
   /// initializes to constant (q_real, zero-vel) spline
@@ -39,6 +41,8 @@ struct BSplineCtrlReference : ReferenceFeed {
 
 struct CubicSplineCtrlReference : ReferenceFeed {
   Var<CubicSpline> spline;
+  SplineEvaluator ctrlEval; ///< spline compiled for the control loop, recompiled on new spline revisions
+  int ctrlEvalRevision=-1;
 
   /// initializes to constant (q_real, zero-vel) spline
   void initialize(const arr& q_real, const arr& qDot_real, double time);
@@ -62,22 +62,56 @@ void GaussianProcess::recompute(const arr& _XX, const arr& _YY) {
   recompute();
 }
 
+void GaussianProcess::kernelMatrix(arr& K, const arr& A, const arr& B) {
+  CHECK_EQ(A.nd, 2, "");
+  CHECK_EQ(B.nd, 2, "");
+  CHECK_EQ(A.d1, B.d1, "");
+  uint m=A.d0, n=B.d0, d=A.d1;
+  K.resize(m, n);
+  if(cov==GaussKernel) { //fast path: squared distances on contiguous rows, then exp over the whole row
+    GaussKernelParams& P = *((GaussKernelParams*)kernelP);
+    double c=-.5/P.widthVar;
+    for(uint i=0; i<m; i++) {
+      const double* a=A.p+i*d;
+      double* Ki=K.p+i*n;
+      for(uint j=0; j<n; j++) {
+        const double* b=B.p+j*d;
+        double dist=0.;
+        for(uint k=0; k<d; k++) { double t=a[k]-b[k]; dist+=t*t; }
+        Ki[j]=c*dist;
+      }
+      for(uint j=0; j<n; j++) Ki[j] = P.priorVar*::exp(Ki[j]);
+    }
+    return;
+  }
+  arr ai, bj;
+  for(uint i=0; i<m; i++) {
+    ai.referToDim(A, i);
+    for(uint j=0; j<n; j++) { bj.referToDim(B, j); K.p[i*n+j] = cov(kernelP, ai, bj); }
+  }
+}
+
+arr GaussianProcess::priorResiduals() {
+  uint N=Y.N, dN=dY.N;
+  arr res(N+dN), xi;
+  for(uint i=0; i<N; i++) { xi.referToDim(X, i); res(i) = Y(i) - mu_func(xi, priorP) - mu; }
+  for(uint i=0; i<dN; i++) res(N+i) = dY(i);
+  return res;
+}
+
+void GaussianProcess::updateGinvY() {
+  GinvY = r;
+  if(GinvY.N) solve_upperTriangular(GinvY, U);
+}
+
 void GaussianProcess::recompute() {
   uint i, j, N=Y.N, dN=dY.N;
-  arr gram, xi, xj, Mu_func;
-  gram.resize(N+dN, N+dN);
-  if(!gram.N) return;
-  for(i=0; i<N; i++) {
-    xi.referToDim(X, i);
-    gram(i, i) = cov(kernelP, xi, xi);
-    Mu_func.append(mu_func(xi, priorP));
-  }
-  for(i=1; i<N; i++) {
-    xi.referToDim(X, i);
-    for(j=0; j<i; j++) {
-      xj.referToDim(X, j);
-      gram(i, j) = gram(j, i) = cov(kernelP, xi, xj);
-    }
+  if(!N && !dN) { U.clear(); r.clear(); GinvY.clear(); return; }
+  arr gram(N+dN, N+dN), xi, xj;
+  if(N) {
+    arr Kff;
+    kernelMatrix(Kff, X, X);
+    gram.setMatrixBlock(Kff, 0, 0);
   }
   if(dN) { //derivative observations
     for(i=0; i<dN; i++) { xi.referToDim(dX, i); gram(N+i, N+i) = covD_D(dI(i), dI(i), kernelP, xi, xi); }
@@ -93,52 +127,86 @@ void GaussianProcess::recompute() {
       }
     }
   }
-  gram = gram + obsVar * eye(gram.d0);
-  inverse_SymPosDef(Ginv, gram);
-  if(!dN) {
-    if(N) GinvY = Ginv * (Y-Mu_func-mu); else GinvY.clear();
-  } else {
-    arr Yfull; Yfull.append(Y-Mu_func-mu); Yfull.append(dY);
-    GinvY = Ginv * Yfull;
-  }
-  //cout <<"gram=" <<gram <<" Ginv=" <<Ginv <<endl;
+  for(i=0; i<gram.d0; i++) gram(i, i) += obsVar;
+  lapack_cholesky(U, gram);
+  r = priorResiduals();
+  solve_upperTriangular(r, U, true);
+  updateGinvY();
+}
+
+void GaussianProcess::appendGramRow(const arr& k, double kk, double y) {
+  uint n=U.d0;
+  cholesky_appendRow(U, k, kk);
+  double rn=y;
+  for(uint i=0; i<n; i++) rn -= U.p[i*(n+1)+n]*r.p[i];
+  r.append(rn/U.p[n*(n+1)+n]);
 }
 
 void GaussianProcess::appendObservation(const arr& x, double y) {
   uint N=X.d0;
+  bool incremental = (U.d0==Y.N+dY.N && !dY.N); //function values precede derivative observations in the gram matrix
   X.append(x); //append it to the data
   Y.append(y);
   X.reshape(N+1, x.N);
   Y.reshape(N+1);
+  if(!incremental) { recompute(); return; }
+
+  arr k(N), xi;
+  for(uint i=0; i<N; i++) { xi.referToDim(X, i); k(i) = cov(kernelP, x, xi); }
+  appendGramRow(k, cov(kernelP, x, x)+obsVar, y - mu_func(x, priorP) - mu);
+  updateGinvY();
 #if RAI_GP_DEBUG
-  arr iG=Ginv;
+  arr U1=U;
   recompute();
-  double err=maxDiff(iG, Ginv);
-  CHECK(err<1e-6, "mis-updated inverse Gram matrix" <<err <<endl <<iG <<Ginv);
+  double err=maxDiff(U1, U);
+  CHECK(err<1e-6, "mis-updated Cholesky factor" <<err <<endl <<U1 <<U);
 #endif
 }
 
 void GaussianProcess::appendDerivativeObservation(const arr& x, double y, uint i) {
-  uint N=dX.d0;
+  uint N=dX.d0, fN=Y.N;
+  bool incremental = (U.d0==fN+N);
   dX.append(x); //append it to the data
   dY.append(y);
   dI.append(i);
   dX.reshape(N+1, x.N);
   dY.reshape(N+1);
   dI.reshape(N+1);
+  if(!incremental) { recompute(); return; }
+
+  arr k(fN+N), xj;
+  for(uint j=0; j<fN; j++) { xj.referToDim(X, j); k(j) = covF_D(i, kernelP, xj, x); }
+  for(uint j=0; j<N; j++) { xj.referToDim(dX, j); k(fN+j) = covD_D(i, dI(j), kernelP, x, xj); }
+  appendGramRow(k, covD_D(i, i, kernelP, x, x)+obsVar, y);
+  updateGinvY();
 }
 
 void GaussianProcess::appendGradientObservation(const arr& x, const arr& nabla) {
   for(uint i=0; i<nabla.N; i++) appendDerivativeObservation(x, nabla(i), i);
 }
 
+void GaussianProcess::removeObservation(uint i) {
+  CHECK_LE(i+1, Y.N, "");
+  uint n=U.d0;
+  bool incremental = (n==Y.N+dY.N);
+  X.delRows(i);
+  Y.remove(i);
+  if(!incremental) { recompute(); return; }
+
+  cholesky_removeRow(U, i);
+
+  r = priorResiduals();
+  if(r.N) solve_upperTriangular(r, U, true);
+  updateGinvY();
+}
+
 double GaussianProcess::max_var() {
   return cov(kernelP, arr{0.}, arr{0.});
 }
 
 void GaussianProcess::evaluate(const arr& x, double& y, double& sig, bool calcSig) {
   uint i, N=Y.N, dN=dY.N;
-  /*static*/ arr k, xi, Ginvk; //danny: why was there a static
+  /*static*/ arr k, xi; //danny: why was there a static
   if(N+dN==0) { //no data
     y = mu_func(x, priorP) + mu;
     sig=::sqrt(cov(kernelP, x, x));
@@ -151,8 +219,8 @@ void GaussianProcess::evaluate(const arr& x, double& y, double& sig, bool calcSi
 
   y = scalarProduct(k, GinvY) + mu_func(x, priorP) + mu;
   if(calcSig) {
-    op_innerProduct(Ginvk, Ginv, k);
-    sig = cov(kernelP, x, x) - scalarProduct(k, Ginvk);
+    solve_upperTriangular(k, U, true); //k^T G^{-1} k = |U^{-T} k|^2
+    sig = cov(kernelP, x, x) - sumOfSqr(k);
     //if(sig<=10e-10) {
     //cout << "---" << endl;
     //cout << "x==" << x << endl;
@@ -168,9 +236,10 @@ void GaussianProcess::evaluate(const arr& x, double& y, double& sig, bool calcSi
 }
 
 double GaussianProcess::log_likelihood() {
-  arr gram;
-  inverse_SymPosDef(gram, Ginv);
-  return (-.5*~Y*GinvY - .5*log(length(gram)) - (X.N+dX.N)/2 * log(2*RAI_PI))(0); // actually a degenerated array of size 1x1
+  double logDet=0.;
+  for(uint i=0; i<U.d0; i++) logDet += 2.*::log(U(i, i));
+  //r = U^{-T} (Y-prior, dY), so r^T r = (Y-prior, dY)^T G^{-1} (Y-prior, dY) also covers derivative observations
+  return -.5*sumOfSqr(r) - .5*logDet - .5*U.d0*::log(2*RAI_PI);
 }
 
 /** vector of covariances between test point and N+dN observation points */
@@ -375,12 +444,43 @@ void GaussianProcess::gradientV(arr& grad, const arr& x) {
   arr k, dk;
   k_star(x, k);
   dk_star(x, dk);
-  grad = -2.0*~k*Ginv*dk;
+  solve_upperTriangular(k, U, true);
+  solve_upperTriangular(dk, U, true);
+  grad = -2.0*~k*dk;
 }
 
-void GaussianProcess::evaluate(const arr& X, arr& Y, arr& S) {
-  uint i;
-  arr xi;
-  Y.resize(X.d0); S.resize(X.d0);
-  for(i=0; i<X.d0; i++) { xi.referToDim(X, i); evaluate(xi, Y(i), S(i)); }
+void GaussianProcess::evaluate(const arr& _X, arr& _Y, arr& S) {
+  uint i, q, N=Y.N, dN=dY.N, M=_X.d0;
+  arr xq, xi;
+  _Y.resize(M); S.resize(M);
+  if(!M) return;
+  if(N+dN==0) { //no data
+    for(q=0; q<M; q++) { xq.referToDim(_X, q); evaluate(xq, _Y(q), S(q)); }
+    return;
+  }
+
+  //-- all query-data covariances at once
+  arr K(M, N+dN);
+  if(!dN) kernelMatrix(K, _X, X);
+  else {
+    if(N) { arr Kf; kernelMatrix(Kf, _X, X); K.setMatrixBlock(Kf, 0, 0); }
+    for(q=0; q<M; q++) {
+      xq.referToDim(_X, q);
+      for(i=0; i<dN; i++) { xi.referToDim(dX, i); K(q, N+i)=covF_D(dI(i), kernelP, xq, xi); }
+    }
+  }
+
+  //-- means
+  _Y = K*GinvY;
+  for(q=0; q<M; q++) { xq.referToDim(_X, q); _Y(q) += mu_func(xq, priorP) + mu; }
+
+  //-- variances: V = U^{-T} K^T for all queries at once
+  arr V = ~K;
+  solve_upperTriangular(V, U, true);
+  arr v = zeros(M);
+  for(i=0; i<N+dN; i++) { const double* Vi=V.p+i*M; for(q=0; q<M; q++) v.p[q] += Vi[q]*Vi[q]; }
+  for(q=0; q<M; q++) {
+    xq.referToDim(_X, q);
+    S(q) = ::sqrt(rai::MAX(cov(kernelP, xq, xq) - v.p[q], 0.)); //roundoff can make the posterior variance slightly negative
+  }
 }
@@ -22,7 +22,9 @@ struct GaussianProcess {
   arr X, Y;   ///< data
   arr dX, dY; ///< derivative data
   uintA dI;  ///< derivative data (derivative indexes)
-  arr Ginv, GinvY, ig2;  ///< inverse gram matrix (and a second buffer for push/pop)
+  arr U;      ///< upper Cholesky factor of the gram matrix, G = U^T U (updated incrementally on append/remove)
+  arr r;      ///< U^{-T} (Y-prior, dY), updated together with U
+  arr GinvY;  ///< G^{-1} (Y-prior, dY)
 
   //--prior function
   double mu; ///< const bias of the GP
@@ -58,18 +60,18 @@ struct GaussianProcess {
 
   GaussianProcess(const GaussianProcess& f) {
     X=f.X; Y=f.Y; dX=f.dX; dY=f.dY; dI=f.dI;
-    Ginv=f.Ginv; GinvY=f.GinvY; ig2=f.ig2;
+    U=f.U; r=f.r; GinvY=f.GinvY;
     mu=f.mu; mu_func=f.mu_func; priorP=f.priorP;
     cov=f.cov; dcov=f.dcov; covF_D=f.covF_D;
     covD_D=f.covD_D; covDD_F=f.covDD_F; covDD_D=f.covDD_D;
     kernelP=f.kernelP; obsVar=f.obsVar;
   }
 
-  void clear() { X.clear(); Y.clear(); dX.clear(); dY.clear(); dI.clear(); Ginv.clear(); GinvY.clear(); ig2.clear(); }
+  void clear() { X.clear(); Y.clear(); dX.clear(); dY.clear(); dI.clear(); U.clear(); r.clear(); GinvY.clear(); }
 
   void copyFrom(GaussianProcess& f) {
     X=f.X; Y=f.Y; dX=f.dX; dY=f.dY; dI=f.dI;
-    Ginv=f.Ginv; GinvY=f.GinvY; ig2=f.ig2;
+    U=f.U; r=f.r; GinvY=f.GinvY;
     mu=f.mu; mu_func=f.mu_func; priorP=f.priorP;
     cov=f.cov; dcov=f.dcov; covF_D=f.covF_D;
     covD_D=f.covD_D; covDD_F=f.covDD_F; covDD_D=f.covDD_D;
@@ -115,14 +117,16 @@ struct GaussianProcess {
   void setGaussKernelGP(void* _kernelP, double(*_mu)(const arr&, const void*), void*);
   void setGaussKernelGP(void* _kernelP, double _mu);
 
-  void recompute(const arr& X, const arr& Y);             ///< calculates the inv Gram matrix for the given data
-  void recompute();                                      ///< recalculates the inv Gram matrix for the current data
-  void appendObservation(const arr& x, double y);     ///< add a new datum to the data and updates the inv Gram matrix
+  void recompute(const arr& X, const arr& Y);             ///< calculates the Cholesky factor for the given data
+  void recompute();                                      ///< recalculates the Cholesky factor for the current data (O(n^3))
+  void appendObservation(const arr& x, double y);     ///< add a new datum to the data and updates the Cholesky factor (O(n^2))
   void appendDerivativeObservation(const arr& x, double dy, uint i);
   void appendGradientObservation(const arr& x, const arr& dydx);
+  void removeObservation(uint i);                     ///< remove the i-th datum, rank-one update of the Cholesky factor (O(n^2))
 
+  void kernelMatrix(arr& K, const arr& A, const arr& B); ///< K(i,j) = cov(A[i], B[j]) for all rows, evaluated blockwise (fast path for GaussKernel)
   void evaluate(const arr& x, double& y, double& sig, bool calcSig = true);   ///< evaluate the GP at some point - returns y and sig (=standard deviation)
-  void evaluate(const arr& X, arr& Y, arr& S);   ///< evaluate the GP at some array of points - returns all y's and sig's
+  void evaluate(const arr& X, arr& Y, arr& S);   ///< evaluate the GP at some array of points - returns all y's and sig's (batched)
   double log_likelihood();
   double max_var(); // the variance when no data present
   void gradient(arr& grad, const arr& x);           ///< evaluate the gradient dy/dx of the mean at some point
@@ -131,8 +135,13 @@ struct GaussianProcess {
   void k_star(const arr& x, arr& k);
   void dk_star(const arr& x, arr& k);
 
-  void push(const arr& x, double y) { ig2=Ginv; appendObservation(x, y); recompute(); }
-  void pop() { Ginv=ig2; X.resizeCopy(X.d0-1, X.d1); Y.resizeCopy(Y.N-1); }
+  void push(const arr& x, double y) { appendObservation(x, y); }
+  void pop() { removeObservation(Y.N-1); }
+
+private:
+  arr priorResiduals(); ///< (Y-prior, dY)
+  void appendGramRow(const arr& k, double kk, double y); ///< extend U and r by one (last) row of the gram matrix
+  void updateGinvY();
 };
 
 #define KRONEKER(a, b)   ( ((a)==(b)) ? 1 : 0 )
@@ -262,7 +271,6 @@ inline void randomFunction(GaussianProcess& gp, arr& Xbase, bool illustrate, boo
     gp.evaluate(x, y, sig);      //sample it from the GP itself
     y+=sig*rnd.gauss();        //with standard deviation..
     gp.appendObservation(x, y);
-    gp.recompute();
   }
 
   gp.obsVar=orgObsVar;
@@ -13,6 +13,8 @@
 template<class T> struct PriorityQueueEntry {
   double f_prio;
   T x;
+  int64_t tie;   ///< tie-breaker for equal f_prio: +insertion count (FIFO) or -insertion count (LIFO)
+  uint handle;   ///< stable id of this entry, see PriorityQueue::update/erase
 
   void write(std::ostream& os) const { os <<'[' <<f_prio <<": " <<*x <<']'; }
   static bool cmp(const PriorityQueueEntry<T>& a, const PriorityQueueEntry<T>& b);
@@ -20,41 +22,108 @@ template<class T> struct PriorityQueueEntry {
 
 template<class T> stdOutPipe(PriorityQueueEntry<T>)
 
+/// strict order of the heap: lower f_prio first, equal f_prio resolved by the tie-breaker
 template<class T> bool PriorityQueueEntry<T>::cmp(const PriorityQueueEntry<T>& a, const PriorityQueueEntry<T>& b) {
-  return a.f_prio <= b.f_prio;
+  return a.f_prio < b.f_prio || (a.f_prio == b.f_prio && a.tie < b.tie);
 }
 
 template<class T> bool operator<=(const PriorityQueueEntry<T>& a, const PriorityQueueEntry<T>& b) {
   return a.f_prio <= b.f_prio;
 }
 
-template<class T> struct PriorityQueue : rai::Array<PriorityQueueEntry<T>> {
+/** An indexed D-ary min-heap (stored in the array itself, so the array is NOT sorted). push/pop/update/erase are
+ *  O(log n). Every add returns a handle that remains valid until the entry is popped or erased; afterwards the
+ *  handle is recycled by later adds, so the handle table is bounded by the maximal queue size. */
+template<class T, uint D=4> struct PriorityQueue : rai::Array<PriorityQueueEntry<T>> {
+  typedef rai::Array<PriorityQueueEntry<T>> Base;
+  uintA handlePos;   ///< for each handle, its current index in the heap (UINT_MAX if popped/erased)
+  uintA freeHandles; ///< popped/erased handles, reused by add
+  int64_t count=0;   ///< number of insertions so far
+
   PriorityQueue() {
-    rai::Array<PriorityQueueEntry<T>>::memMove = 1;
+    Base::memMove = 1;
   }
 
-  void add(double f_prio, const T& x, bool FIFOifEqual=false) { //'FIFOifEqual=true' makes it a FIFO (breadth first search); otherwise LIFO (depth first search)
-    PriorityQueueEntry<T> e = {f_prio, x};
-    rai::Array<PriorityQueueEntry<T>>::insertInSorted(e, PriorityQueueEntry<T>::cmp, FIFOifEqual);
+  uint add(double f_prio, const T& x, bool FIFOifEqual=false) { //'FIFOifEqual=true' makes it a FIFO (breadth first search); otherwise LIFO (depth first search)
+    count++;
+    uint handle;
+    if(freeHandles.N) { handle = freeHandles.popLast(); handlePos.p[handle] = Base::N; }
+    else { handle = handlePos.N; handlePos.append(Base::N); }
+    PriorityQueueEntry<T> e = {f_prio, x, (FIFOifEqual ? count : -count), handle};
+    Base::append(e);
+    siftUp(Base::N-1);
+    return e.handle;
   }
 
-  void append(const T& x){
-    PriorityQueueEntry<T> e = {0., x};
-    rai::Array<PriorityQueueEntry<T>>::append(e);
-  }
+  uint append(const T& x) { return add(0., x, true); } ///< FIFO queue when used exclusively
+
+  const T& top() const { CHECK(Base::N, "queue is empty"); return Base::elem(0).x; }
 
   T pop() {
-    T x=rai::Array<PriorityQueueEntry<T>>::first().x;
-    rai::Array<PriorityQueueEntry<T>>::remove(0);
+    CHECK(Base::N, "queue is empty");
+    T x = Base::elem(0).x;
+    removeAt(0);
     return x;
   }
 
-  //  void add_replace(double p, const T& x){
-  //    PriorityQueueEntry<T> e = {p, x};
-  //    uint pos = rankInSorted(e, cmp_PriorityQueueEntry);
-  //    PriorityQueueEntry<T>& e_after = elem(pos);
-  //    if(e_after.x==e.x){
-  //      if(e_after)
-  //      e_after.p =
-  //  }
+  bool contains(uint handle) const { return handle<handlePos.N && handlePos.p[handle]!=UINT_MAX; }
+
+  /// change the priority of an entry (decrease-key or increase-key)
+  void update(uint handle, double f_prio) {
+    CHECK(contains(handle), "handle " <<handle <<" is not in the queue");
+    uint i = handlePos.p[handle];
+    double old = Base::p[i].f_prio;
+    Base::p[i].f_prio = f_prio;
+    if(f_prio<old) siftUp(i); else siftDown(i);
+  }
+
+  void erase(uint handle) {
+    CHECK(contains(handle), "handle " <<handle <<" is not in the queue");
+    removeAt(handlePos.p[handle]);
+  }
+
+  void clear() { Base::clear(); handlePos.clear(); freeHandles.clear(); count=0; }
+
+private:
+  void place(uint i, const PriorityQueueEntry<T>& e) { Base::p[i] = e; handlePos.p[e.handle] = i; }
+
+  void siftUp(uint i) {
+    PriorityQueueEntry<T> e = Base::p[i];
+    while(i) {
+      uint parent = (i-1)/D;
+      if(!PriorityQueueEntry<T>::cmp(e, Base::p[parent])) break;
+      place(i, Base::p[parent]);
+      i = parent;
+    }
+    place(i, e);
+  }
+
+  void siftDown(uint i) {
+    PriorityQueueEntry<T> e = Base::p[i];
+    uint n = Base::N;
+    for(;;) {
+      uint c = D*i+1;
+      if(c>=n) break;
+      uint best = c;
+      for(uint k=c+1; k<c+D && k<n; k++) if(PriorityQueueEntry<T>::cmp(Base::p[k], Base::p[best])) best = k;
+      if(!PriorityQueueEntry<T>::cmp(Base::p[best], e)) break;
+      place(i, Base::p[best]);
+      i = best;
+    }
+    place(i, e);
+  }
+
+  void removeAt(uint i) {
+    handlePos.p[Base::p[i].handle] = UINT_MAX;
+    freeHandles.append(Base::p[i].handle);
+    uint last = Base::N-1;
+    if(i!=last) {
+      PriorityQueueEntry<T> moved = Base::p[last];
+      Base::resizeCopy(last);
+      place(i, moved);
+      if(i && PriorityQueueEntry<T>::cmp(moved, Base::p[(i-1)/D])) siftUp(i); else siftDown(i);
+    } else {
+      Base::resizeCopy(last);
+    }
+  }
 };
@@ -552,6 +552,136 @@ arr CubicSpline::eval(const arr& T, uint diff) const{
   return x;
 }
 
+//==============================================================================
+
+void SplineEvaluator::compile(const BSpline& S){
+  CHECK_EQ(S.ctrlPoints.nd, 2, "");
+  degree = S.degree;
+  n = S.ctrlPoints.d1;
+  uint P = degree+1;
+  lastPiece = 0;
+  holdVel = false;
+
+  //segments are the non-zero knot intervals
+  times.clear();
+  for(uint i=0;i+1<S.knotTimes.N;i++) if(S.knotTimes(i+1)>S.knotTimes(i)) times.append(S.knotTimes(i));
+  if(!times.N){ //degenerate (single time) spline: hold the first point
+    times = {S.knotTimes.first(), S.knotTimes.first()};
+    coeffs.resize(1, P, n).setZero();
+    coeffs[0][0] = S.ctrlPoints[0];
+    return;
+  }
+  times.append(S.knotTimes.last());
+
+  //within each segment the spline is a polynomial: interpolate P interior samples (Newton form) and expand to power basis
+  uint K = times.N-1;
+  coeffs.resize(K, P, n);
+  arr s(P), Y(P, n), a(P, n);
+  for(uint k=0;k<K;k++){
+    double h = times(k+1)-times(k);
+    for(uint j=0;j<P;j++){
+      s(j) = h*double(j+1)/double(P+1);
+      Y[j] = S.eval(times(k)+s(j));
+    }
+    for(uint i=1;i<P;i++) for(uint j=P-1;j>=i;j--) Y[j] = (Y[j]-Y[j-1])/(s(j)-s(j-i));
+    a.setZero();
+    a[0] = Y[P-1];
+    for(uint i=P-1;i--;){
+      for(uint p=P-1;p>0;p--) a[p] = a[p-1] - s(i)*a[p];
+      a[0] = Y[i] - s(i)*a[0];
+    }
+    coeffs[k] = a;
+  }
+}
+
+void SplineEvaluator::compile(const CubicSpline& S){
+  CHECK_GE(S.times.N, 2, "spline is empty");
+  degree = 3;
+  n = S.pieces.first().d.N;
+  lastPiece = 0;
+  holdVel = true;
+  times = S.times;
+  uint K = S.pieces.N;
+  coeffs.resize(K, 4, n);
+  for(uint k=0;k<K;k++){
+    const CubicPiece& piece = S.pieces(k);
+    coeffs(k, 0, {}) = piece.d;
+    coeffs(k, 1, {}) = piece.c;
+    coeffs(k, 2, {}) = piece.b;
+    coeffs(k, 3, {}) = piece.a;
+  }
+}
+
+uint SplineEvaluator::getPiece(double t){
+  uint K = times.N-1;
+  uint k = lastPiece;
+  if(k>=K) k=0;
+  //control loops query increasing times: try the cached segment and its successor first
+  if(t>=times.p[k]){
+    if(k+1>=K || t<times.p[k+1]) return lastPiece=k;
+    if(k+2>=K || t<times.p[k+2]) return lastPiece=k+1;
+  }
+  //bisection for the last segment with times(k)<=t
+  uint lo=0, hi=K;
+  while(lo+1<hi){
+    uint mi = (lo+hi)/2;
+    if(times.p[mi]<=t) lo=mi; else hi=mi;
+  }
+  return lastPiece=lo;
+}
+
+void SplineEvaluator::eval(double* x, double* xDot, double* xDDot, double t){
+  CHECK_GE(times.N, 2, "spline evaluator is not compiled");
+  uint k = getPiece(t);
+  double s = t-times.p[k];
+  bool hold = false;
+  if(t<times.first()){ s=0.; hold=true; }
+  else if(t>=times.last()){ s=times.p[k+1]-times.p[k]; hold=true; }
+
+  //Horner schemes over contiguous coefficient rows (one row per power, all joints)
+  const double *c = coeffs.p + k*(degree+1)*n, *cp;
+  if(x){
+    cp = c+degree*n;
+    for(uint j=0;j<n;j++) x[j] = cp[j];
+    for(uint p=degree;p--;){
+      cp = c+p*n;
+      for(uint j=0;j<n;j++) x[j] = x[j]*s + cp[j];
+    }
+  }
+  if(xDot){
+    if((hold && !holdVel) || degree<1){
+      for(uint j=0;j<n;j++) xDot[j] = 0.;
+    } else {
+      cp = c+degree*n;
+      for(uint j=0;j<n;j++) xDot[j] = degree*cp[j];
+      for(uint p=degree-1;p>=1;p--){
+        cp = c+p*n;
+        for(uint j=0;j<n;j++) xDot[j] = xDot[j]*s + p*cp[j];
+      }
+    }
+  }
+  if(xDDot){
+    if(hold || degree<2){
+      for(uint j=0;j<n;j++) xDDot[j] = 0.;
+    } else {
+      cp = c+degree*n;
+      for(uint j=0;j<n;j++) xDDot[j] = (degree*(degree-1))*cp[j];
+      for(uint p=degree-1;p>=2;p--){
+        cp = c+p*n;
+        for(uint j=0;j<n;j++) xDDot[j] = xDDot[j]*s + (p*(p-1))*cp[j];
+      }
+    }
+  }
+}
+
+void SplineEvaluator::eval(arr& x, arr& xDot, arr& xDDot, double t){
+  //resize is a no-op (no allocation) when outputs are already of size n
+  if(!!x) x.resize(n);
+  if(!!xDot) xDot.resize(n);
+  if(!!xDDot) xDDot.resize(n);
+  eval((!!x?x.p:0), (!!xDot?xDot.p:0), (!!xDDot?xDDot.p:0), t);
+}
+
 arr CubicSplineLeapCost(const arr& x0, const arr& v0, const arr& x1, const arr& v1, double tau, const arr& tauJ) {
   arr D = (x1-x0) - (.5*tau)*(v0+v1);
   if(tauJ.N){
@@ -96,6 +96,29 @@ struct CubicSpline{
 
 //==============================================================================
 
+/// a BSpline or CubicSpline compiled to per-segment polynomial coefficients, for evaluation in real-time loops:
+/// eval does no heap allocation (given pre-sized outputs) and searches the segment starting from the last queried one
+struct SplineEvaluator {
+  uint degree=0, n=0;
+  arr times;  ///< segment start times, plus the final end time
+  arr coeffs; ///< (#segments, degree+1, n) power-basis coefficients in (t-times(k))
+  uint lastPiece=0;
+  bool holdVel=false; ///< outside [begin,end] keep the boundary velocity (as CubicSpline::eval does) instead of zero
+
+  void compile(const BSpline& S);
+  void compile(const CubicSpline& S);
+
+  uint getPiece(double t);
+  /// outside [begin,end] the boundary point is held with zero acceleration and zero (BSpline) or boundary (CubicSpline) velocity
+  void eval(double* x, double* xDot, double* xDDot, double t);
+  void eval(arr& x, arr& xDot, arr& xDDot, double t);
+
+  double begin() const { return times.first(); }
+  double end() const { return times.last(); }
+};
+
+//==============================================================================
+
 arr CubicSplineLeapCost(const arr& x0, const arr& v0, const arr& x1, const arr& v1, double tau, const arr& tauJ={});
 arr CubicSplineMaxJer(const arr& x0, const arr& v0, const arr& x1, const arr& v1, double tau, const arr& tauJ={});
 arr CubicSplineMaxAcc(const arr& x0, const arr& v0, const arr& x1, const arr& v1, double tau, const arr& tauJ={});
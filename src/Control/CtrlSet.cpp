@@ -46,7 +46,8 @@ bool isFeasible(const CtrlSet& CS, const rai::Configuration& pathConfig, bool in
     if(o->type==OT_ineq || o->type==OT_eq) {
       if(!initOnly && o->transientStep>0. && o->movingTarget->isTransient) { isFeasible=false; break; }
       if(!initOnly || o->transientStep<=0.) {
-        arr y = o->feat->eval(o->feat->getFrames(pathConfig));
+        uint s = (pathConfig.frames.nd==2 ? pathConfig.frames.d0-1 : 0); //the current (last) slice; order>0 features refer to its predecessors
+        arr y = o->feat->eval(o->feat->getFrames(pathConfig, s));
         if(o->type==OT_ineq) {
           for(double& yi : y) if(yi>eqPrecision) { isFeasible=false; break; }
         }
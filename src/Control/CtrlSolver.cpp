@@ -115,6 +115,19 @@ void CtrlSolver::report(std::ostream& os) {
 static int animate=0;
 
 arr CtrlSolver::solve() {
+  if(useQP) {
+    qp.ground(*this);
+    qp.setup(*this);
+    arr dq = qp.solve();
+    komo.pathConfig.setJointState(komo.pathConfig.getJointState() + dq);
+    optReport.clear();
+    optReport.add<double>("sos", qp.sos);
+    optReport.add<double>("ineq", qp.ineq);
+    optReport.add<double>("eq", qp.eq);
+    optReport.add<double>("activeSet", qp.activeSet.N);
+    optReport.add<double>("iters", qp.iters);
+    return komo.getConfiguration_qOrg(0);
+  }
 #if 0
   TaskControlMethods M(komo.getConfiguration_t(0).getHmetric());
   arr q = komo.getConfiguration_t(0).getJointState();
@@ -152,3 +165,234 @@ arr CtrlSolver::solve() {
   return solve_optim(*this);
 #endif
 }
+
+//===========================================================================
+
+//-- column support of a Jacobian, and where each of its sparse entries goes in the compact Jacobian
+static void setJacobianPattern(CtrlQP::Grounded& gr, const arr& J, uint n) {
+  gr.cols.clear();
+  gr.pattern.clear();
+  gr.pos.clear();
+  if(isSparseMatrix(J)) {
+    const intA& elems = J.sparse().elems;
+    intA colIdx = rai::consts<int>(-1, n);
+    for(uint k=0; k<elems.d0; k++) colIdx(elems(k, 1)) = 0;
+    for(uint j=0; j<n; j++) if(colIdx(j)>=0) { colIdx(j) = gr.cols.N; gr.cols.append(j); }
+    gr.pos.resize(elems.d0);
+    for(uint k=0; k<elems.d0; k++) gr.pos(k) = elems(k, 0)*gr.cols.N + colIdx(elems(k, 1));
+    gr.pattern = elems;
+  } else {
+    gr.cols.setStraightPerm(n);
+  }
+}
+
+//-- scatter the (sparse) Jacobian into gr.Jc over the support columns; the pattern is only recomputed when it changed
+static void compactJacobian(CtrlQP::Grounded& gr, const arr& J, uint n) {
+  if(isSparseMatrix(J)) {
+    if(J.sparse().elems!=gr.pattern) setJacobianPattern(gr, J, n);
+    gr.Jc.resize(gr.dim, gr.cols.N).setZero();
+    for(uint k=0; k<gr.pos.N; k++) gr.Jc.p[gr.pos.p[k]] += J.p[k];
+  } else {
+    if(gr.pattern.N || gr.cols.N!=n) setJacobianPattern(gr, J, n);
+    gr.Jc = J;
+  }
+}
+
+bool CtrlQP::ground(CtrlSolver& CP) {
+  //-- keep the grounding as long as the same objectives (with the same features) are active
+  uint k=0;
+  bool same=true;
+  for(auto& o: CP.objectives) if(o->active) {
+    if(k>=grounded.N || grounded(k).ob!=o.get() || grounded(k).feat!=o->feat.get()) { same=false; break; }
+    k++;
+  }
+  if(same && k==grounded.N) return false;
+
+  grounded.clear();
+  activeSet.clear();
+  nEq=nIneq=0;
+  rai::Configuration& C = CP.komo.pathConfig;
+  uint n = C.getJointStateDimension();
+  auto jacMode = C.jacMode;
+  C.jacMode = rai::Configuration::JM_sparse;
+  for(auto& o: CP.objectives) if(o->active) {
+    Grounded& gr = grounded.append();
+    gr.ob = o.get();
+    gr.feat = o->feat.get();
+    gr.F = o->feat->getFrames(C, CP.komo.k_order);
+    arr y = gr.feat->eval(gr.F);
+    arr J = y.J_reset();
+    gr.dim = y.N;
+    setJacobianPattern(gr, J, n);
+
+    if(o->type==OT_eq) { gr.row=nEq; nEq+=gr.dim; }
+    else if(o->type==OT_ineq) { gr.row=nIneq; nIneq+=gr.dim; }
+    else gr.row=0;
+  }
+  C.jacMode = jacMode;
+  return true;
+}
+
+void CtrlQP::setup(CtrlSolver& CP) {
+  KOMO& komo = CP.komo;
+  rai::Configuration& C = komo.pathConfig;
+  arr x = C.getJointState();
+  komo.set_x(x); //recomputes proxies, if collisions are computed
+  auto jacMode = C.jacMode;
+  C.jacMode = rai::Configuration::JM_sparse;
+
+  uint n=x.N;
+  H.resize(n, n).setZero();
+  g.resize(n).setZero();
+  A.resize(nEq+nIneq+2*n, n).setZero();
+  b.resize(A.d0).setZero();
+  sos=eq=ineq=0.;
+
+  //-- features, linearized at the current state: phi(dq) = y + J dq
+  for(Grounded& gr: grounded) {
+    arr y = gr.feat->eval(gr.F);
+    arr J = y.J_reset();
+    if(y.N!=gr.dim) { //the feature changed its dimensionality (e.g. collision pairs): reground
+      C.jacMode = jacMode;
+      grounded.clear();
+      ground(CP);
+      setup(CP);
+      return;
+    }
+    CHECK_EQ(J.d1, n, "");
+    compactJacobian(gr, J, n);
+    const arr& Jc = gr.Jc; //dim x cols.N
+    uint m = gr.cols.N;
+    ObjectiveType type = gr.ob->type;
+    if(type==OT_sos) {
+      sos += sumOfSqr(y);
+      for(uint i=0; i<y.N; i++) {
+        const double* Ji = Jc.p+i*m;
+        for(uint a=0; a<m; a++) if(Ji[a]) {
+          g.p[gr.cols.p[a]] += 2.*y.p[i]*Ji[a];
+          double* Ha = &H(gr.cols.p[a], 0);
+          for(uint c=0; c<m; c++) Ha[gr.cols.p[c]] += 2.*Ji[a]*Ji[c];
+        }
+      }
+    } else if(type==OT_f) {
+      for(uint i=0; i<y.N; i++) for(uint a=0; a<m; a++) g.p[gr.cols.p[a]] += Jc.p[i*m+a];
+    } else if(type==OT_eq || type==OT_ineq) {
+      uint r = (type==OT_eq ? gr.row : nEq+gr.row);
+      for(uint i=0; i<y.N; i++) {
+        for(uint a=0; a<m; a++) A(r+i, gr.cols.p[a]) = Jc.p[i*m+a];
+        b(r+i) = -y.p[i];
+        if(type==OT_eq) eq += fabs(y.p[i]);
+        else if(y.p[i]>0.) ineq += y.p[i];
+      }
+    }
+  }
+  C.jacMode = jacMode;
+  for(uint i=0; i<n; i++) H(i, i) += damping;
+
+  //-- box on the step: joint limits, velocity and acceleration bounds
+  arr lo = rai::consts<double>(-CP.maxVel*CP.tau, n);
+  arr up = rai::consts<double>(CP.maxVel*CP.tau, n);
+  arr limits = ~C.getLimits();
+  for(uint i=0; i<n; i++) if(limits(1, i)>=limits(0, i)) {
+    lo(i) = rai::MAX(lo(i), limits(0, i)-x(i));
+    up(i) = rai::MIN(up(i), limits(1, i)-x(i));
+  }
+  if(komo.k_order>=2) {
+    arr dq_1 = komo.getConfiguration_qAll(-1) - komo.getConfiguration_qAll(-2);
+    CHECK_EQ(dq_1.N, n, "");
+    lo = elemWiseMax(lo, dq_1 - CP.maxAcc*CP.tau*CP.tau);
+    up = elemWiseMin(up, dq_1 + CP.maxAcc*CP.tau*CP.tau);
+  }
+  for(uint i=0; i<n; i++) {
+    if(lo(i)>up(i)) lo(i) = up(i) = .5*(lo(i)+up(i)); //inconsistent bounds (e.g. beyond a joint limit)
+    uint r = nEq+nIneq+2*i;
+    A(r, i) = 1.;    b(r) = up(i);
+    A(r+1, i) = -1.; b(r+1) = -lo(i);
+  }
+}
+
+arr CtrlQP::solve() {
+  uint n=H.d0, m=A.d0;
+
+  //-- dual: lambda = argmin 1/2 lambda^T M lambda + c^T lambda, lambda_i>=0 for all but the equality rows,
+  //   with M = A H^{-1} A^T + I/constraintStiffness, c = A H^{-1} g + b, and the primal dq = -H^{-1}(g + A^T lambda)
+  arr U;
+  lapack_cholesky(U, H);
+  arr V = ~A;
+  solve_upperTriangular(V, U, true); //V = U^{-T} A^T
+  arr u = g;
+  solve_upperTriangular(u, U, true); //u = U^{-T} g
+  arr M = ~V*V;
+  for(uint i=0; i<m; i++) M(i, i) += 1./constraintStiffness;
+  arr c = ~V*u + b;
+
+  //-- free (active) set F with the Cholesky factor L of M_FF
+  uintA F;
+  arr L, k;
+  boolA isFree = rai::consts<byte>(false, m);
+  auto add = [&](uint i) {
+    k.resize(F.N);
+    for(uint j=0; j<F.N; j++) k.p[j] = M(F.p[j], i);
+    arr l = k;
+    if(F.N) solve_upperTriangular(l, L, true);
+    if(M(i, i)-sumOfSqr(l) <= 1e-12*M(i, i)) return false; //linearly dependent on the free set
+    cholesky_appendRow(L, k, M(i, i));
+    F.append(i);
+    isFree(i) = true;
+    return true;
+  };
+  for(uint i=0; i<nEq; i++) add(i);
+  for(uint i: activeSet) if(i>=nEq && i<m) add(i); //warm start
+
+  arr lambda = zeros(m), lF;
+  for(iters=0; iters<maxIters;) {
+    //-- minimize over the free set
+    lF.resize(F.N);
+    for(uint j=0; j<F.N; j++) lF.p[j] = -c(F.p[j]);
+    if(F.N) { solve_upperTriangular(lF, L, true); solve_upperTriangular(lF, L, false); }
+
+    //-- step from the feasible lambda towards lF, until a multiplier hits zero
+    double alpha=1.;
+    int block=-1;
+    for(uint j=0; j<F.N; j++) if(F.p[j]>=nEq && lF.p[j]<0.) {
+      double l = lambda(F.p[j]);
+      double a = l/(l-lF.p[j]);
+      if(a<alpha) { alpha=a; block=j; }
+    }
+    for(uint j=0; j<F.N; j++) lambda(F.p[j]) += alpha*(lF.p[j]-lambda(F.p[j]));
+    if(block>=0) {
+      lambda(F(block)) = 0.;
+      isFree(F(block)) = false;
+      cholesky_removeRow(L, block);
+      F.remove(block);
+      iters++;
+      continue;
+    }
+
+    //-- add the inequality with the most negative dual gradient
+    int worst=-1;
+    double wMin=-1e-10;
+    for(uint i=nEq; i<m; i++) if(!isFree(i)) {
+      double w = c(i);
+      for(uint j=0; j<F.N; j++) w += M(i, F.p[j])*lambda(F.p[j]);
+      if(w<wMin) { wMin=w; worst=i; }
+    }
+    if(worst<0) break;
+    if(!add(worst)) break;
+    iters++;
+  }
+
+  activeSet.clear();
+  for(uint i: F) if(i>=nEq) activeSet.append(i);
+
+  //-- primal step, clipped to the box
+  arr dq = u + V*lambda;
+  solve_upperTriangular(dq, U, false);
+  dq *= -1.;
+  for(uint i=0; i<n; i++) {
+    uint r = nEq+nIneq+2*i;
+    if(dq(i)>b(r)) dq(i)=b(r);
+    if(dq(i)<-b(r+1)) dq(i)=-b(r+1);
+  }
+  return dq;
+}
@@ -15,12 +15,49 @@
 
 //===========================================================================
 
+/** Persistent reactive-control QP over the joint step dq = q - q_real. The active objectives are grounded once
+ *  (frames, row blocks and Jacobian column supports) and only regrounded when the set of active objectives changes;
+ *  per tick their features are re-evaluated in place, so that changed targets and activations enter without
+ *  rebuilding anything. sos objectives define the cost, eq/ineq objectives linearized constraints, joint limits and
+ *  maxVel/maxAcc a box. The QP is solved in its dual (a bound-constrained QP in the multipliers) by an active-set
+ *  method with an incrementally updated Cholesky factor, warm-started with the previous active set. Constraints are
+ *  elastic with stiffness 'constraintStiffness' (so the QP is always feasible) and the number of active-set changes
+ *  per tick is bounded by 'maxIters'. */
+struct CtrlQP {
+  double damping=1e-4;             ///< regularization of the step (H += damping*I)
+  double constraintStiffness=1e6;  ///< quadratic penalty on violations of the (linearized) constraints
+  uint maxIters=100;               ///< bound on active-set changes per solve (bounded worst-case latency)
+
+  struct Grounded {
+    CtrlObjective* ob; Feature* feat; FrameL F; uint dim, row;
+    uintA cols;     ///< Jacobian column support
+    intA pattern;   ///< sparsity pattern (elems) of the sparse Jacobian the support was taken from
+    uintA pos;      ///< for each pattern entry, its index in the compact (dim x cols.N) Jacobian
+    arr Jc;         ///< compact Jacobian of the last setup
+  };
+  rai::Array<Grounded> grounded;   ///< the grounded active objectives
+  uint nEq=0, nIneq=0;             ///< number of equality and inequality feature rows
+  arr H, g;                        ///< cost 1/2 dq^T H dq + g^T dq
+  arr A, b;                        ///< constraints A dq <= b: nEq equality rows, nIneq inequality rows, then the 2n box rows
+  uintA activeSet;                 ///< active inequality rows of the last solve (warm start)
+  uint iters=0;                    ///< active-set changes in the last solve
+  double sos=0., eq=0., ineq=0.;   ///< objective values at the current state
+
+  bool ground(CtrlSolver& CP);     ///< (re)grounds if the active objectives changed; returns true if so
+  void setup(CtrlSolver& CP);      ///< evaluates all grounded features (sparse Jacobians) at the current state and fills H, g, A, b
+  arr solve();                     ///< returns the optimal step dq
+};
+
+//===========================================================================
+
 struct CtrlSolver : NonCopyable {
   KOMO komo;
   double tau;
   double maxVel=1.;
   double maxAcc=1.;
   rai::Graph optReport;
+  bool useQP=false;   ///< solve each tick as a single persistent QP (see CtrlQP) instead of a full KOMO optimization
+  CtrlQP qp;
 
   rai::Array<shared_ptr<CtrlObjective>> objectives;    ///< list of objectives
 
@@ -47,16 +47,26 @@ void SecMPC::updateWaypoints(const rai::Configuration& C){
 
   if(!waypointMPC.feasible) wayInfeasible++; else wayInfeasible=0;
 
-  msg <<" WAY #" <<waypointMPC.komo.pathConfig.setJointStateCount;
-  msg <<' ' <<waypointMPC.komo.sos <<'|' <<waypointMPC.komo.ineq + waypointMPC.komo.eq;
-  if(!waypointMPC.feasible) msg <<'!' <<wayInfeasible <<"\n  " <<waypointMPC.msg;
+  rai::String m;
+  m <<std::setprecision(3);
+  m <<" WAY #" <<waypointMPC.komo.pathConfig.setJointStateCount;
+  m <<' ' <<waypointMPC.komo.sos <<'|' <<waypointMPC.komo.ineq + waypointMPC.komo.eq;
+  if(!waypointMPC.feasible) m <<'!' <<wayInfeasible.load() <<"\n  " <<waypointMPC.msg;
+  appendMsg(m);
 }
 
 //===========================================================================
 
 void SecMPC::updateTiming(const rai::Configuration& C, const ObjectiveL& phi, const arr& q_real){
+  updateTiming(C, phi, q_real, waypointMPC.path({subSeqStart, subSeqStop}));
+}
+
+void SecMPC::updateTiming(const rai::Configuration& C, const ObjectiveL& phi, const arr& q_real, const arr& waypoints){
+  rai::String m;
+  m <<std::setprecision(3);
+
   //-- adopt the new path
-  timingMPC.set_updatedWaypoints(waypointMPC.path({subSeqStart, subSeqStop}), setNextWaypointTangent);
+  timingMPC.set_updatedWaypoints(waypoints, setNextWaypointTangent);
 
   //-- progress time (potentially phase)
   if(!timingMPC.done() && ctrlTimeDelta>0.){
@@ -83,7 +93,7 @@ void SecMPC::updateTiming(const rai::Configuration& C, const ObjectiveL& phi, co
     }
   }
 
-  msg <<" \tTIMING";
+  m <<" \tTIMING";
   //-- re-optimize the timing
   if(!timingMPC.done()){
     if(timingMPC.tau(timingMPC.phase) > opt.tauCutoff){
@@ -100,10 +110,10 @@ void SecMPC::updateTiming(const rai::Configuration& C, const ObjectiveL& phi, co
         q_refAdapted = q_ref_atLastUpdate;
         ret = timingMPC.solve(q_ref_atLastUpdate, qDot_ref_atLastUpdate, opt.verbose-3);
       }
-      msg <<" #" <<ret->evals;
-      //      msg <<" T:" <<ret->time <<" f:" <<ret->f;
+      m <<" #" <<ret->evals;
+      //      m <<" T:" <<ret->time <<" f:" <<ret->f;
     }else{
-      msg <<" skip";
+      m <<" skip";
     }
   }
 
@@ -111,8 +121,9 @@ void SecMPC::updateTiming(const rai::Configuration& C, const ObjectiveL& phi, co
   if(max(timingMPC.tau - tauExpected) > .8*ctrlTimeDelta) tauStalling++;
   else tauStalling=0;
 
-  msg <<" ph:" <<timingMPC.phase <<" tau:" <<timingMPC.tau;
-  msg <<timingMPC.tau - tauExpected;
+  m <<" ph:" <<timingMPC.phase <<" tau:" <<timingMPC.tau;
+  m <<timingMPC.tau - tauExpected;
+  appendMsg(m);
 
 //  msg <<ctrlTime_atLastUpdate + timingMPC.getTimes(); // <<' ' <<F.vels;
   if(phaseSwitch && opt.verbose>0) LOG(0) <<"phase switch to ph: " <<timingMPC.phase;
@@ -121,24 +132,23 @@ void SecMPC::updateTiming(const rai::Configuration& C, const ObjectiveL& phi, co
 //===========================================================================
 
 void SecMPC::updateShortPath(const rai::Configuration& C){
+  shortMPC.shift(ctrlTimeDelta);
+//  timingMPC.getCubicSpline(S, q_ref_atLastUpdate, qDot_ref_atLastUpdate);
+  updateShortPath(C, getSpline(ctrlTime_atLastUpdate, true), q_refAdapted, qDot_ref_atLastUpdate);
+}
+
+void SecMPC::updateShortPath(const rai::Configuration& C, const rai::CubicSplineCtor& sp, const arr& q0, const arr& qDot0){
   shortMPC.reinit(C); //adopt all frames in C as prefix (also positions of objects)
-  shortMPC.reinit(q_refAdapted, qDot_ref_atLastUpdate);
+  shortMPC.reinit(q0, qDot0);
   rai::CubicSpline S;
-#if 0
-  timingMPC.getCubicSpline(S, q_ref, qDot_ref);
-  if(!S.pieces.N) return;
-#else
-//  timingMPC.getCubicSpline(S, q_ref_atLastUpdate, qDot_ref_atLastUpdate);
-  auto sp = getSpline(ctrlTime_atLastUpdate, true);
   if(!sp.pts.N){ shortMPC.feasible=false; return; }
   S.set(sp.pts, sp.vels, sp.times);
-#endif
   arr times = shortMPC.komo.getPath_times();
   arr pts = S.eval(times);
   CHECK_EQ(times.N, shortMPC.komo.T, "");
   CHECK_EQ(pts.d0, shortMPC.komo.T, "");
   for(int t=0;t<(int)pts.d0;t++){
-    shortMPC.komo.setConfiguration_qOrg(t, q_refAdapted); //pts[t]);
+    shortMPC.komo.setConfiguration_qOrg(t, q0); //pts[t]);
     std::shared_ptr<GroundedObjective> ob = shortMPC.komo.objs.elem(t - (int)pts.d0);
     ob->feat->setTarget(pts[t]);
 //    cout <<off <<' ' <<t <<' ' <<ob->feat->shortTag(C) <<ob->feat->scale <<ob->feat->target <<ob->timeSlices <<endl;
@@ -164,21 +174,34 @@ void SecMPC::updateShortPath(const rai::Configuration& C){
 //  rai::wait();
 //  shortMPC.komo.reportProblem();
 
-  msg <<" \tPATH #" <<shortMPC.komo.pathConfig.setJointStateCount;
-  msg <<' ' <<shortMPC.komo.sos <<'|' <<shortMPC.komo.ineq + shortMPC.komo.eq;
-  if(!shortMPC.feasible) msg <<'!' <<wayInfeasible;
+  rai::String m;
+  m <<std::setprecision(3);
+  m <<" \tPATH #" <<shortMPC.komo.pathConfig.setJointStateCount;
+  m <<' ' <<shortMPC.komo.sos <<'|' <<shortMPC.komo.ineq + shortMPC.komo.eq;
+  if(!shortMPC.feasible) m <<'!' <<wayInfeasible.load();
+  appendMsg(m);
 }
 
 //===========================================================================
 
-void SecMPC::cycle(const rai::Configuration& C, const arr& q_ref, const arr& qDot_ref, const arr& q_real, const arr& qDot_real, double ctrlTime){
-  //-- store ctrl state at start of this cycle
+void SecMPC::storeCtrlState(const arr& q_ref, const arr& qDot_ref, double ctrlTime){
   if(ctrlTime_atLastUpdate>0.){
     ctrlTimeDelta = ctrlTime - ctrlTime_atLastUpdate;
   }
   ctrlTime_atLastUpdate = ctrlTime;
   q_ref_atLastUpdate = q_ref;
   qDot_ref_atLastUpdate = qDot_ref;
+}
+
+void SecMPC::appendMsg(const rai::String& m){
+  auto lock = msgMutex(RAI_HERE);
+  if(msg.N>(1<<16)) msg.clear(); //threaded layers only append; don't grow unboundedly when nobody reports
+  msg <<m;
+}
+
+void SecMPC::cycle(const rai::Configuration& C, const arr& q_ref, const arr& qDot_ref, const arr& q_real, const arr& qDot_real, double ctrlTime){
+  //-- store ctrl state at start of this cycle
+  storeCtrlState(q_ref, qDot_ref, ctrlTime);
 
   msg.clear();
   msg <<std::setprecision(3);
@@ -192,6 +215,10 @@ void SecMPC::cycle(const rai::Configuration& C, const arr& q_ref, const arr& qDo
 rai::CubicSplineCtor SecMPC::getSpline(double realtime, bool prependRef){
   if(!waypointMPC.feasible) return {};
 //  if(timingMPC.done() || !waypointMPC.feasible) return {};
+  return getTimingSpline(realtime, prependRef);
+}
+
+rai::CubicSplineCtor SecMPC::getTimingSpline(double realtime, bool prependRef){
   arr pts = timingMPC.getWaypoints();
   arr vels = timingMPC.getVels();
   arr times = timingMPC.getTimes();
@@ -262,5 +289,110 @@ void SecMPC::report(const rai::Configuration& C) {
     <<' ' <<phi.maxError(C, 1.5+timingMPC.phase)
    <<' ' <<phi.maxError(C, 2.+timingMPC.phase);
 #endif
+  auto lock = msgMutex(RAI_HERE);
   cout <<msg <<endl;
 }
+
+//===========================================================================
+
+SecMPC_Threaded::SecMPC_Threaded(SecMPC& _mpc, const rai::Configuration& C, double wayBeat, double timingBeat, double shortBeat)
+  : mpc(_mpc), C_way(C), C_timing(C), C_short(C) {
+  //the waypoint thread evaluates its KOMO's features while solving -> the timing thread checks its own copies
+  for(shared_ptr<Objective>& o:mpc.waypointMPC.komo.objectives){
+    if(o->feat->order!=0 || (o->type!=OT_eq && o->type!=OT_ineq)) continue; //maxError only checks these
+    phi_timing.append(make_shared<Objective>(o->feat->deepCopy(), o->type, o->name, o->times));
+  }
+
+  wayThread = run([this](){ return stepWaypoints(); }, wayBeat);
+  timingThread = run([this](){ return stepTiming(); }, timingBeat);
+  shortThread = run([this](){ return stepShortPath(); }, shortBeat);
+}
+
+SecMPC_Threaded::~SecMPC_Threaded(){
+  shortThread.reset();
+  timingThread.reset();
+  wayThread.reset();
+}
+
+void SecMPC_Threaded::setCtrlState(const rai::Configuration& C, const arr& q_ref, const arr& qDot_ref, const arr& q_real, double ctrlTime){
+  auto x = ctrlState.set();
+  x->frameState = C.getFrameState();
+  x->q_ref = q_ref;
+  x->qDot_ref = qDot_ref;
+  x->q_real = q_real;
+  x->ctrlTime = ctrlTime;
+}
+
+int SecMPC_Threaded::stepWaypoints(){
+  SecMPC_CtrlState x = ctrlState.get();
+  if(x.ctrlTime<0.) return AS_running; //no ctrl state yet
+
+  C_way.setFrameState(x.frameState);
+  mpc.updateWaypoints(C_way);
+  if(mpc.waypointMPC.feasible) waypoints.set() = mpc.waypointMPC.path({mpc.subSeqStart, mpc.subSeqStop});
+  else waypoints.set()->clear();
+  return AS_running;
+}
+
+int SecMPC_Threaded::stepTiming(){
+  SecMPC_CtrlState x = ctrlState.get();
+  arr way = waypoints.get();
+  if(x.ctrlTime<0. || !way.N){ spline.set()->pts.clear(); return AS_running; }
+
+  C_timing.setFrameState(x.frameState);
+  SecMPC_Spline sp;
+  {
+    auto lock = mpc.ctrlMutex(RAI_HERE);
+    mpc.storeCtrlState(x.q_ref, x.qDot_ref, x.ctrlTime);
+    rai::String m;
+    m <<std::setprecision(3) <<"\nSecMPC d:" <<mpc.ctrlTimeDelta;
+    mpc.appendMsg(m);
+    mpc.updateTiming(C_timing, phi_timing, x.q_real, way);
+    (rai::CubicSplineCtor&)sp = mpc.getTimingSpline(x.ctrlTime, true);
+  }
+  sp.ctrlTime = x.ctrlTime;
+  spline.set() = sp;
+  return AS_running;
+}
+
+int SecMPC_Threaded::stepShortPath(){
+  SecMPC_CtrlState x = ctrlState.get();
+  SecMPC_Spline sp = spline.get();
+  if(!sp.pts.N){ shortPath.set()->pts.clear(); return AS_running; }
+
+  C_short.setFrameState(x.frameState);
+  if(shortCtrlTime>=0.) mpc.shortMPC.shift(sp.ctrlTime - shortCtrlTime); //as in the sequential cycle: warm start from the shifted last solution
+  shortCtrlTime = sp.ctrlTime;
+  mpc.updateShortPath(C_short, sp, sp.pts[0], sp.vels[0]);
+
+  auto p = shortPath.set();
+  if(mpc.shortMPC.feasible){
+    p->pts = mpc.shortMPC.path;
+    p->vels = mpc.shortMPC.vels;
+    p->times = mpc.shortMPC.times;
+  }else{
+    p->pts.clear();
+  }
+  p->ctrlTime = sp.ctrlTime;
+  return AS_running;
+}
+
+void SecMPC_Threaded::report(){
+  auto lock = mpc.msgMutex(RAI_HERE);
+  cout <<mpc.msg <<endl;
+  mpc.msg.clear();
+}
+
+rai::CubicSplineCtor SecMPC_Threaded::getSpline(double realtime){
+  SecMPC_Spline sp = spline.get();
+  if(!sp.pts.N) return {};
+  sp.times -= realtime - sp.ctrlTime; //shift spline to stich it at realtime
+  return {sp.pts, sp.vels, sp.times};
+}
+
+rai::CubicSplineCtor SecMPC_Threaded::getShortPath(double realtime){
+  SecMPC_Spline sp = shortPath.get();
+  if(!sp.pts.N) return {};
+  sp.times -= realtime - sp.ctrlTime; //shift spline to stich it at realtime
+  return {sp.pts, sp.vels, sp.times};
+}
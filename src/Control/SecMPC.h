@@ -4,6 +4,8 @@
 #include "ShortPathMPC.h"
 #include "TimingMPC.h"
 
+#include "../Core/thread.h"
+
 //===========================================================================
 
 namespace rai {
@@ -24,13 +26,15 @@ struct SecMPC{
   int subSeqStart=0, subSeqStop=-1;
   bool setNextWaypointTangent;
   rai::String msg;
+  Mutex msgMutex;
+  Mutex ctrlMutex; ///< guards the ctrl state and timing layer below when SecMPC_Threaded runs the layers concurrently
 
   double ctrlTimeDelta = 0.;
   double ctrlTime_atLastUpdate = -1.;
   arr q_ref_atLastUpdate, qDot_ref_atLastUpdate, q_refAdapted;
   bool phaseSwitch=false;
   int tauStalling=0;
-  int wayInfeasible=0;
+  std::atomic<int> wayInfeasible={0}; ///< written by the waypoint layer, read by the short path layer (possibly another thread)
 
   rai::SecMPC_Options opt;
 
@@ -38,12 +42,63 @@ struct SecMPC{
 
   void updateWaypoints(const rai::Configuration& C);
   void updateTiming(const rai::Configuration& C, const ObjectiveL& phi, const arr& q_real);
+  void updateTiming(const rai::Configuration& C, const ObjectiveL& phi, const arr& q_real, const arr& waypoints);
   void updateShortPath(const rai::Configuration& C);
+  void updateShortPath(const rai::Configuration& C, const rai::CubicSplineCtor& sp, const arr& q0, const arr& qDot0);
+  void storeCtrlState(const arr& q_ref, const arr& qDot_ref, double ctrlTime);
   void cycle(const rai::Configuration& C, const arr& q_ref, const arr& qDot_ref, const arr& q_real, const arr& qDot_real, double ctrlTime);
   rai::CubicSplineCtor getSpline(double realtime, bool prependRef=false);
+  rai::CubicSplineCtor getTimingSpline(double realtime, bool prependRef=false); ///< same as getSpline, without checking waypoint feasibility
   rai::CubicSplineCtor getShortPath(double realtime);
   rai::CubicSplineCtor getShortPath_debug(double realtime);
   void report(const rai::Configuration& C);
+  void appendMsg(const rai::String& m);
+};
+
+//===========================================================================
+
+/// the controller state as input to the threaded SecMPC
+struct SecMPC_CtrlState{
+  arr frameState; ///< frame state of the world (e.g. moved objects)
+  arr q_ref, qDot_ref, q_real;
+  double ctrlTime=-1.;
+};
+
+/// a spline (or path) published by one layer, stamped with the ctrl time its times are relative to
+struct SecMPC_Spline : rai::CubicSplineCtor{
+  double ctrlTime=-1.;
+};
+
+/// runs the three SecMPC layers in separate threads, each at its own rate; the layers exchange
+/// results only via Var snapshots (the Var revision is the snapshot version), so the slow waypoint
+/// solve delays neither the timing and short path updates, nor the controller fetching the latest spline
+struct SecMPC_Threaded{
+  SecMPC& mpc;
+
+  //input (set by the controller)
+  Var<SecMPC_CtrlState> ctrlState;
+  //layer outputs
+  Var<arr> waypoints;            ///< latest waypoints; empty if infeasible
+  Var<SecMPC_Spline> spline;     ///< latest timed spline, starting at the reference
+  Var<SecMPC_Spline> shortPath;  ///< latest short path
+
+  //-- internal (private)
+  rai::Configuration C_way, C_timing, C_short; //each layer's own copy of the world
+  ObjectiveL phi_timing; //timing layer's own (deep) copy of the waypoint constraints, for phase backtracking
+  shared_ptr<ScriptThread> wayThread, timingThread, shortThread;
+  double shortCtrlTime=-1.; //ctrl time of the spline the short path was last solved for (short thread only)
+
+  SecMPC_Threaded(SecMPC& _mpc, const rai::Configuration& C, double wayBeat=.1, double timingBeat=.01, double shortBeat=.05);
+  ~SecMPC_Threaded();
+
+  void setCtrlState(const rai::Configuration& C, const arr& q_ref, const arr& qDot_ref, const arr& q_real, double ctrlTime);
+  rai::CubicSplineCtor getSpline(double realtime);
+  rai::CubicSplineCtor getShortPath(double realtime);
+  void report(); ///< print and flush the messages the layers appended since the last report
+
+  int stepWaypoints();
+  int stepTiming();
+  int stepShortPath();
 };
 
 
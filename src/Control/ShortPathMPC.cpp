@@ -38,12 +38,14 @@ void ShortPathMPC::reinit_taus(double timeToConstraint){
 //  komo.pathConfig.setTaus(taus);
   LOG(0) <<timeToConstraint <<' ' <<sliceOfConstraint; // <<' ' <<taus;
 
-  komo.objs.popLast();
-  komo.objs.popLast();
-  shared_ptr<Objective> ob2 = komo.objectives.popLast();
-  shared_ptr<Objective> ob1 = komo.objectives.popLast();
-  komo._addObjective(ob1, intA{{1,1},{sliceOfConstraint}});
-  komo._addObjective(ob2, intA{{1,2},{sliceOfConstraint, sliceOfConstraint+1}});
+  //re-ground the last two objectives at the new slice in place: same features and dimensions, so the warm start is kept
+  shared_ptr<GroundedObjective>& ob1 = komo.objs(-2);
+  shared_ptr<GroundedObjective>& ob2 = komo.objs(-1);
+  if(ob1->timeSlices.N==1 && ob1->timeSlices(0)==sliceOfConstraint) return;
+  ob1->timeSlices = {sliceOfConstraint};
+  ob2->timeSlices = {sliceOfConstraint, sliceOfConstraint+1};
+  komo._groundFrames(*ob1);
+  komo._groundFrames(*ob2);
 #endif
 
 //  komo.reportProblem();  rai::wait();
@@ -66,6 +68,12 @@ void ShortPathMPC::reinit(const rai::Configuration& C){
   komo.updateRootObjects(C);
 }
 
+void ShortPathMPC::shift(double timeDelta){
+  if(!warmStart) return;
+  int steps = floor(timeDelta/defaultTau + .5);
+  komo.shift_warmStart(steps);
+}
+
 void ShortPathMPC::solve(bool alsoVels, int verbose){
   iters++;
 
@@ -77,7 +85,12 @@ void ShortPathMPC::solve(bool alsoVels, int verbose){
   komo.timeTotal=0.;
   komo.pathConfig.setJointStateCount=0;
 //  komo.initWithConstant(qHome);
-  komo.optimize(0., opt);
+  if(warmStart){
+    komo.run_prepare(0.);
+    komo.run_warmStart(opt, maxNewtonSteps);
+  }else{
+    komo.optimize(0., opt);
+  }
   //komo.checkGradients();
 
   //is feasible?
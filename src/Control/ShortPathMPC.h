@@ -10,6 +10,10 @@ struct ShortPathMPC{
   double defaultTau;
   int sliceOfConstraint;
 
+  //receding-horizon re-solve: keep NLP structure, duals and penalty across cycles; cap Newton steps per cycle
+  bool warmStart=false;
+  int maxNewtonSteps=-1;
+
   arr x0, v0;
 
   //results
@@ -25,6 +29,7 @@ struct ShortPathMPC{
   void reinit_taus(double timeToConstraint);
   void reinit(const arr& x, const arr& v);  //update robot state
   void reinit(const rai::Configuration& C); //update object movements
+  void shift(double timeDelta); //time-shift previous path & duals by timeDelta (warm start only)
 
   void solve(bool alsoVels, int verbose);
   arr getPath();
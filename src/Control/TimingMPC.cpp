@@ -26,16 +26,22 @@ shared_ptr<SolverReturn> TimingMPC::solve(const arr& x0, const arr& v0, int verb
                    true, false,
                    vels({phase, -1}), tau({phase, -1}));
 
-  NLP_Solver S;
-  if(warmstart_dual.N){
+  shared_ptr<SolverReturn> ret;
+  if(useTimingSolver && !tangents.N){
+    TimingSolver S(nlp, opt);
+    ret = S.solve({}, warmstart_dual);
+  }else{
+    NLP_Solver S;
+    if(warmstart_dual.N){
 //    S.setWarmstart({}, warmstart_dual);
 //    opt.muInit = 25;
-  }
-  S.setOptions(opt)
-      .setProblem(nlp.ptr())
-      .setSolver(NLPS_augmentedLag);
+    }
+    S.setOptions(opt)
+        .setProblem(nlp.ptr())
+        .setSolver(NLPS_augmentedLag);
 
-  auto ret = S.solve();
+    ret = S.solve();
+  }
 
   if(verbose>1){
     LOG(0) <<*ret <<endl
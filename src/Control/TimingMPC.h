@@ -24,6 +24,8 @@ struct TimingMPC{
   //tangent options
   bool useNextWaypointTangent=true;
 
+  bool useTimingSolver=false; ///< use the structured O(K) TimingSolver (with dual warm start) instead of the generic NLP_Solver
+
   //phase management
   uint phase=0;
   uintA backtrackingTable;
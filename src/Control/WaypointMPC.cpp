@@ -35,7 +35,12 @@ void WaypointMPC::solve(int verbose){
 //  komo.reportProblem();
 //  komo.initWithConstant(qHome);
 //  komo.opt.animateOptimization=2;
-  komo.optimize(.0, opt);
+  if(warmStart){
+    komo.run_prepare(.0);
+    komo.run_warmStart(opt, maxNewtonSteps);
+  }else{
+    komo.optimize(.0, opt);
+  }
 //  komo.checkGradients();
 //  cout <<komo.getReport(false) <<endl;
 
@@ -10,6 +10,9 @@ struct WaypointMPC{
 
   arr qHome;
   uint steps=0;
+  //receding-horizon re-solve: keep NLP structure, duals and penalty across cycles; cap Newton steps per cycle
+  bool warmStart=false;
+  int maxNewtonSteps=-1;
   //result
   arr path;
   arr tau;
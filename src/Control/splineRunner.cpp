@@ -18,6 +18,7 @@ void SplineRunner::set(const arr& x, const arr& t, const arr& x0, bool append) {
     double last = refTimes.last();
     refTimes.append(t+last);
     refSpline.set(2, refPoints, refTimes);
+    refEval.compile(refSpline);
   } else {
     refPoints = x;
     refTimes = t;
@@ -26,24 +27,25 @@ void SplineRunner::set(const arr& x, const arr& t, const arr& x0, bool append) {
       refPoints.prepend(x0);
     }
     refSpline.set(2, refPoints, refTimes);
+    refEval.compile(refSpline);
     phase=0.;
   }
 }
 
-arr SplineRunner::run(double dt, arr& qref_dot) {
+const arr& SplineRunner::run(double dt, arr& qref_dot) {
   if(refSpline.ctrlPoints.N) {
     //read out the new reference
     phase += dt;
     double maxPhase = refSpline.knotTimes.last();
-    arr q_ref = refSpline.eval(phase);
-    if(!!qref_dot) qref_dot = refSpline.eval(phase, 1);
+    refEval.eval(q_ref, qref_dot, NoArr, phase);
     if(phase>maxPhase) { //clear spline buffer
       q_ref = refPoints[-1];
       stop();
     }
-    return q_ref;
+  } else {
+    q_ref.clear();
   }
-  return {};
+  return q_ref;
 }
 
 double SplineRunner::timeToGo() {
@@ -14,11 +14,13 @@ namespace rai {
 
 struct SplineRunner {
   rai::BSpline refSpline; // reference spline constructed from ref
+  rai::SplineEvaluator refEval; // refSpline compiled for allocation-free evaluation in run
   arr refPoints, refTimes; // the knot points and times of the spline
   double phase=0.; // current phase in the spline
+  arr q_ref; // output buffer of run (reused, no allocation per call)
 
   void set(const arr& x, const arr& t, const arr& x0, bool append);
-  arr run(double dt, arr& qref_dot=NoArr);
+  const arr& run(double dt, arr& qref_dot=NoArr);
   double timeToGo();
   void stop();
 };
@@ -1,6 +1,9 @@
 #include "timingOpt.h"
 #include "../Core/util.h"
 
+#include <iomanip>
+#include <math.h>
+
 TimingProblem::TimingProblem(const arr& _waypoints, const arr& _tangents,
                              const arr& _x0, const arr& _v0,
                              double _timeCost, double _ctrlCost,
@@ -486,3 +489,227 @@ arr TimingProblem::Jtau(int k){
   }
   return tauJ;
 }
+
+//===========================================================================
+
+/// solves A x = b in place (b becomes x) for symmetric pos-def A stored as upper band, A(i,j) = A_{i,i+j}; O(n*band^2)
+static bool bandedCholeskySolve(arr& A, arr& b){
+  uint n=A.d0, m=A.d1;
+  for(uint i=0;i<n;i++){
+    double *Ai=&A(i,0);
+    if(Ai[0]<=0.) return false;
+    Ai[0] = ::sqrt(Ai[0]);
+    for(uint j=1;j<m && i+j<n;j++) Ai[j] /= Ai[0];
+    for(uint j=1;j<m && i+j<n;j++){
+      double *Aj=&A(i+j,0);
+      for(uint l=j;l<m && i+l<n;l++) Aj[l-j] -= Ai[j]*Ai[l];
+    }
+  }
+  for(uint i=0;i<n;i++){ //U^T y = b
+    b(i) /= A(i,0);
+    for(uint j=1;j<m && i+j<n;j++) b(i+j) -= A(i,j)*b(i);
+  }
+  for(uint i=n;i--;){ //U x = y
+    for(uint j=1;j<m && i+j<n;j++) b(i) -= A(i,j)*b(i+j);
+    b(i) /= A(i,0);
+  }
+  return true;
+}
+
+TimingSolver::TimingSolver(TimingProblem& _P, const rai::OptOptions& _opt)
+  : P(_P), opt(_opt){
+  uint K = P.waypoints.d0;
+  uint d = P.waypoints.d1;
+  CHECK_EQ(P.v.nd, 2, "");
+  uint vIdx = P.optTau?K:0;
+  uint wIdx = vIdx + P.v.N;
+
+  //-- interleave the decision variables per waypoint: (tau_k, v_k, free waypoint k)
+  perm.resize(P.getDimension());
+  uint i=0;
+  for(uint k=0;k<K;k++){
+    if(P.optTau) perm(k) = i++;
+    if(k<P.v.d0) for(uint j=0;j<d;j++) perm(vIdx+k*d+j) = i++;
+    for(uint w=0;w<P.wayFree.N;w++) if(P.wayFree(w)==k) for(uint j=0;j<d;j++) perm(wIdx+w*d+j) = i++;
+  }
+  CHECK_EQ(i, P.getDimension(), "");
+}
+
+void TimingSolver::evaluate(const arr& _x){
+  P.evaluate(phi_x, J_x, _x);
+  evals++;
+  CHECK(isSparseMatrix(J_x), "");
+}
+
+double TimingSolver::lagrangian(){
+  double L=0.;
+  for(uint i=0;i<phi_x.N;i++){
+    double y = phi_x(i);
+    switch(P.featureTypes(i)){
+      case OT_f:  L += y;  break;
+      case OT_sos:  L += y*y;  break;
+      case OT_eq:  L += mu*y*y + dual(i)*y;  break;
+      case OT_ineq:
+      case OT_ineqB:  if(y>0. || dual(i)>0.) L += mu*y*y + dual(i)*y;  break;
+      default: break;
+    }
+  }
+  return L;
+}
+
+void TimingSolver::gradientAndBandedHessian(arr& g, arr& H){
+  uint n = P.getDimension();
+  const rai::SparseMatrix& S = J_x.sparse();
+  uint nnz = S.elems.d0;
+
+  //-- coefficients of L = sum_i (w_i phi_i + c_i) phi_i
+  arr w(phi_x.N), c(phi_x.N);
+  for(uint i=0;i<phi_x.N;i++){
+    double y = phi_x(i);
+    w(i)=c(i)=0.;
+    switch(P.featureTypes(i)){
+      case OT_f:  c(i)=1.;  break;
+      case OT_sos:  w(i)=1.;  break;
+      case OT_eq:  w(i)=mu;  c(i)=dual(i);  break;
+      case OT_ineq:
+      case OT_ineqB:  if(y>0. || dual(i)>0.){ w(i)=mu;  c(i)=dual(i); }  break;
+      default: break;
+    }
+  }
+
+  //-- bucket nonzeros by rows, and get the bandwidth in the interleaved ordering
+  uintA start(phi_x.N+1), idx(nnz);
+  start.setZero();
+  for(uint k=0;k<nnz;k++) start(S.elems(k,0)+1)++;
+  for(uint i=0;i<phi_x.N;i++) start(i+1) += start(i);
+  uintA fill = start;
+  for(uint k=0;k<nnz;k++) idx(fill(S.elems(k,0))++) = k;
+  uint band=0;
+  for(uint i=0;i<phi_x.N;i++) if(w(i)){
+    uint lo=n, hi=0;
+    for(uint a=start(i);a<start(i+1);a++){ uint p=perm(S.elems(idx(a),1)); lo=std::min(lo,p); hi=std::max(hi,p); }
+    if(hi>lo) band=std::max(band, hi-lo);
+  }
+
+  //-- g = sum_i (2 w_i phi_i + c_i) J_i,  H = sum_i 2 w_i J_i^T J_i (upper band)
+  g.resize(n).setZero();
+  H.resize(n, band+1).setZero();
+  for(uint i=0;i<phi_x.N;i++){
+    double gi = 2.*w(i)*phi_x(i) + c(i);
+    for(uint a=start(i);a<start(i+1);a++){
+      uint ka=idx(a);
+      double va = J_x.p[ka];
+      g(S.elems(ka,1)) += gi*va;
+      if(!w(i)) continue;
+      uint pa = perm(S.elems(ka,1));
+      for(uint b=start(i);b<start(i+1);b++){
+        uint kb=idx(b);
+        uint pb = perm(S.elems(kb,1));
+        if(pa<=pb) H(pa, pb-pa) += 2.*w(i)*va*J_x.p[kb];
+      }
+    }
+  }
+}
+
+shared_ptr<SolverReturn> TimingSolver::solve(const arr& x_init, const arr& dual_init){
+  auto ret = make_shared<SolverReturn>();
+  double time = -rai::cpuTime();
+  uint n = P.getDimension();
+  const arr& lo=P.bounds_lo, &up=P.bounds_up;
+  auto clip = [&](arr& y){ for(uint i=0;i<n;i++) if(up(i)>=lo(i)) y(i) = rai::MAX(lo(i), rai::MIN(up(i), y(i))); };
+
+  x = x_init.N ? x_init : P.getInitializationSample();
+  CHECK_EQ(x.N, n, "");
+  clip(x);
+  dual = dual_init;
+  if(dual.N!=P.featureTypes.N) dual = zeros(P.featureTypes.N); //e.g. after a phase change
+  mu = opt.muInit;
+  evals = 0;
+  bool hasConstraints=false;
+  for(ObjectiveType ot:P.featureTypes) if(ot==OT_eq || ot==OT_ineq || ot==OT_ineqB) hasConstraints=true;
+
+  arr g, H, b(n), delta(n), y;
+  evaluate(x);
+  for(uint outer=0;;outer++){
+    arr x_before = x;
+
+    //-- inner loop: damped Gauss-Newton with bound clamping and backtracking
+    double L = lagrangian();
+    double alpha = 1.;
+    for(uint it=0;it<(uint)opt.stopIters;it++){
+      gradientAndBandedHessian(g, H);
+      for(uint i=0;i<n;i++){
+        uint p = perm(i);
+        if(up(i)>=lo(i) && ((x(i)<=lo(i) && g(i)>0.) || (x(i)>=up(i) && g(i)<0.))){ //clamp at active bound
+          for(uint j=1;j<H.d1;j++){ H(p,j)=0.; if(p>=j) H(p-j,j)=0.; }
+          H(p,0) = 1.;
+          b(p) = 0.;
+        }else{
+          H(p,0) += opt.damping;
+          b(p) = -g(i);
+        }
+      }
+      if(!bandedCholeskySolve(H, b)){ //not pos-def -> plain gradient step
+        for(uint i=0;i<n;i++) b(perm(i)) = -g(i);
+      }
+      for(uint i=0;i<n;i++) delta(i) = b(perm(i));
+      double dmax = absMax(delta);
+      if(opt.maxStep>0. && dmax>opt.maxStep) delta *= opt.maxStep/dmax;
+
+      bool accepted=false;
+      arr phi_x0=phi_x, J_x0=J_x;
+      for(uint l=0;l<(uint)opt.stopLineSteps;l++){
+        y = x + alpha*delta;
+        clip(y);
+        evaluate(y);
+        double Ly = lagrangian();
+        if(Ly <= L + opt.wolfe*scalarProduct(g, y-x)){ L=Ly; accepted=true; break; }
+        alpha *= opt.stepDec;
+      }
+      if(!accepted){ phi_x=phi_x0; J_x=J_x0; break; }
+      double step = absMax(y-x);
+      x = y;
+      alpha = rai::MIN(1., alpha*opt.stepInc);
+      if(step<opt.stopTolerance) break;
+      if(opt.stopEvals>0 && evals>=(uint)opt.stopEvals) break;
+    }
+
+    double step = absMax(x_before-x);
+    if(opt.verbose>0){
+      cout <<"==timing== it:" <<std::setw(4) <<outer <<"  evals:" <<std::setw(4) <<evals <<"  A(x):" <<std::setw(11) <<L <<"  mu:" <<mu <<"  |x-x'|:" <<std::setw(11) <<step <<endl;
+    }
+
+    //-- stopping criteria (as in OptConstrained)
+    if(!hasConstraints) break;
+    if(outer>=1 && step<opt.stopTolerance) break;
+    if(opt.stopOuters>0 && outer+1>=(uint)opt.stopOuters) break;
+    if(opt.stopEvals>0 && evals>=(uint)opt.stopEvals) break;
+
+    //-- augmented Lagrangian update
+    for(uint i=0;i<dual.N;i++){
+      ObjectiveType ot = P.featureTypes(i);
+      if(ot==OT_eq) dual(i) += 2.*mu*phi_x(i);
+      if(ot==OT_ineq || ot==OT_ineqB){ dual(i) += 2.*mu*phi_x(i); if(dual(i)<0.) dual(i)=0.; }
+    }
+    if(opt.muInc>0.){ mu *= opt.muInc; if(mu>opt.muMax) mu=opt.muMax; }
+  }
+
+  //-- make P's decision variables consistent with x and fill the return
+  evaluate(x);
+  ret->f = ret->sos = ret->ineq = ret->eq = 0.;
+  for(uint i=0;i<phi_x.N;i++){
+    ObjectiveType ot = P.featureTypes(i);
+    if(ot==OT_f) ret->f += phi_x(i);
+    if(ot==OT_sos) ret->sos += rai::sqr(phi_x(i));
+    if(ot==OT_ineq || ot==OT_ineqB) if(phi_x(i)>0.) ret->ineq += phi_x(i);
+    if(ot==OT_eq) ret->eq += ::fabs(phi_x(i));
+  }
+  ret->feasible = (ret->ineq<.5) && (ret->eq<.5);
+  time += rai::cpuTime();
+  ret->x = x;
+  ret->dual = dual;
+  ret->evals = evals;
+  ret->time = time;
+  ret->done = true;
+  return ret;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Optim/NLP.h"
+#include "../Optim/options.h"
 #include "../Algo/spline.h"
 
 //===========================================================================
@@ -53,3 +54,28 @@ private:
   arr vJ(int k);
   arr Jtau(int k);
 };
+
+//===========================================================================
+
+/** Dedicated solver for a TimingProblem (same augmented Lagrangian as NLP_Solver, but exploiting the structure):
+ *  all features of segment k only depend on tau_k, v_{k-1}, v_k (and the free waypoints k-1, k), so after
+ *  interleaving the variables per waypoint the Gauss-Newton system is block-tridiagonal (block-pentadiagonal with
+ *  accCont) and is solved by a banded Cholesky in O(K). Pass the previous cycle's solution/dual for warm starts. */
+struct TimingSolver {
+  TimingProblem& P;
+  rai::OptOptions opt;
+  arr x, dual;  ///< solution and Lagrange multipliers (one per feature)
+  uint evals=0;
+
+  TimingSolver(TimingProblem& _P, const rai::OptOptions& _opt);
+
+  shared_ptr<SolverReturn> solve(const arr& x_init={}, const arr& dual_init={}); ///< empty x_init -> P.getInitializationSample()
+
+private:
+  uintA perm;  ///< position of each decision variable in the interleaved ordering
+  double mu=1.;
+  arr phi_x, J_x;
+  void evaluate(const arr& _x);
+  double lagrangian();
+  void gradientAndBandedHessian(arr& g, arr& H);
+};
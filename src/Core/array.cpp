@@ -62,6 +62,7 @@ const bool lapackSupported=true;
 const bool lapackSupported=false;
 #endif
 int64_t globalMemoryTotal=0, globalMemoryBound=1ull<<32; //this is 1GB
+thread_local int64_t globalMemoryAllocs=0; //number of (re)allocations in this thread, read by ProfileScope
 bool globalMemoryStrict=false;
 const char* arrayElemsep=", ";
 const char* arrayLinesep=",\n ";
@@ -529,6 +530,88 @@ void inverse_SymPosDef(arr& Ainv, const arr& A) {
   lapack_inverseSymPosDef(Ainv, A);
 }
 
+void solve_upperTriangular(arr& B, const arr& U, bool transpose) {
+  uint n=U.d0, m=(n?B.N/n:0);
+  CHECK_EQ(U.d1, n, "");
+  CHECK_EQ(B.N, n*m, "");
+  if(transpose) { //forward substitution with U^T
+    for(uint j=0; j<n; j++) {
+      double* bj=B.p+j*m;
+      for(uint k=0; k<j; k++) {
+        double u=U.p[k*n+j];
+        if(!u) continue;
+        const double* bk=B.p+k*m;
+        for(uint l=0; l<m; l++) bj[l] -= u*bk[l];
+      }
+      double ujj=U.p[j*n+j];
+      for(uint l=0; l<m; l++) bj[l] /= ujj;
+    }
+  } else { //backward substitution with U
+    for(uint j=n; j--;) {
+      double* bj=B.p+j*m;
+      for(uint k=j+1; k<n; k++) {
+        double u=U.p[j*n+k];
+        if(!u) continue;
+        const double* bk=B.p+k*m;
+        for(uint l=0; l<m; l++) bj[l] -= u*bk[l];
+      }
+      double ujj=U.p[j*n+j];
+      for(uint l=0; l<m; l++) bj[l] /= ujj;
+    }
+  }
+}
+
+void cholesky_appendRow(arr& U, const arr& k, double kk) {
+  uint n=U.d0;
+  CHECK_EQ(k.N, n, "");
+  arr u = k;
+  if(n) solve_upperTriangular(u, U, true);
+  double d = kk - sumOfSqr(u);
+  CHECK_GE(d, 0., "matrix not positive definite");
+
+  arr Unew(n+1, n+1);
+  Unew.setZero();
+  for(uint i=0; i<n; i++) {
+    memmove(Unew.p+i*(n+1)+i, U.p+i*n+i, (n-i)*sizeof(double));
+    Unew.p[i*(n+1)+n] = u.p[i];
+  }
+  Unew.p[n*(n+1)+n] = ::sqrt(d);
+  U = Unew;
+}
+
+void cholesky_removeRow(arr& U, uint i) {
+  uint n=U.d0;
+  CHECK_LE(i+1, n, "");
+  //removing row/column i of A = U^T U leaves U's upper-left and upper-right blocks;
+  //the trailing block gets the rank-one update U33'^T U33' = U33^T U33 + u^T u, u = U(i, i+1:)
+  arr u(n);
+  for(uint j=i+1; j<n; j++) u.p[j] = U.p[i*n+j];
+  for(uint k=i+1; k<n; k++) {
+    double& ukk = U.p[k*n+k];
+    double r = ::sqrt(ukk*ukk + u.p[k]*u.p[k]);
+    double c = r/ukk, s = u.p[k]/ukk;
+    ukk = r;
+    for(uint j=k+1; j<n; j++) {
+      double& ukj = U.p[k*n+j];
+      ukj = (ukj + s*u.p[j])/c;
+      u.p[j] = c*u.p[j] - s*ukj;
+    }
+  }
+
+  arr Unew(n-1, n-1);
+  Unew.setZero();
+  for(uint k=0, kk=0; k<n; k++) {
+    if(k==i) continue;
+    for(uint j=k, jj=kk; j<n; j++) {
+      if(j==i) continue;
+      Unew.p[kk*(n-1)+jj] = U.p[k*n+j];
+      jj++;
+    }
+    kk++;
+  }
+  U = Unew;
+}
+
 arr pseudoInverse(const arr& A, const arr& Winv, double eps) {
   arr AAt;
   arr At = ~A;
@@ -2565,10 +2648,21 @@ arr rai::comp_A_At(const arr& A) {
 //  return NoArr;
 //}
 
+//sparse (transposed) matrix-vector product directly over the nonzeros, without Eigen conversion
+static arr sparse_A_x(const arr& A, const arr& x, bool transpose) {
+  const rai::SparseMatrix& S = A.sparse();
+  CHECK_EQ(x.N, (transpose?A.d0:A.d1), "");
+  arr y = zeros(transpose?A.d1:A.d0);
+  const int* e=S.elems.p;
+  if(transpose) for(uint k=0; k<S.elems.d0; k++, e+=2) y.p[e[1]] += A.p[k]*x.p[e[0]];
+  else for(uint k=0; k<S.elems.d0; k++, e+=2) y.p[e[0]] += A.p[k]*x.p[e[1]];
+  return y;
+}
+
 arr rai::comp_At_x(const arr& A, const arr& x) {
   if(!isSpecial(A)) { arr y; op_innerProduct(y, ~A, x); return y; }
   if(isRowShifted(A)) return ((rai::RowShifted*)A.special)->At_x(x);
-  if(isSparseMatrix(A)) return ((rai::SparseMatrix*)A.special)->At_x(x);
+  if(isSparseMatrix(A)) return sparse_A_x(A, x, true);
   return NoArr;
 }
 
@@ -2581,6 +2675,7 @@ arr rai::comp_At(const arr& A) {
 arr rai::comp_A_x(const arr& A, const arr& x) {
   if(!isSpecial(A)) { arr y; op_innerProduct(y, A, x); return y; }
   if(isRowShifted(A)) return ((rai::RowShifted*)A.special)->A_x(x);
+  if(isSparseMatrix(A)) return sparse_A_x(A, x, false);
   return NoArr;
 }
 
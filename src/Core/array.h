@@ -266,6 +266,9 @@ template<class T> struct Array {
   void readJson(std::istream& is, bool skipType=false);
   void writeBase64(std::ostream& os) const;
   void readBase64(std::istream& is);
+  void writeArchive(std::ostream& os) const; ///< versioned binary record (type, shape, raw data aligned to 8 bytes)
+  Array<T>& readArchive(std::istream& is);
+  size_t readArchive(const char* data, size_t size, size_t pos=0, bool view=false); ///< parse a record at data+pos; view: refer into data (zero-copy, data must outlive this); returns the end position
 
   /// modifiers
   ArrayModRaw<T> modRaw() const;
@@ -11,6 +11,7 @@
 #include "array.h"
 
 #include <algorithm>
+#include <type_traits>
 
 #define ARRAY_flexiMem true
 
@@ -22,6 +23,7 @@ namespace rai {
 
 //fwd declarations
 extern int64_t globalMemoryTotal, globalMemoryBound;
+extern thread_local int64_t globalMemoryAllocs;
 extern bool globalMemoryStrict;
 
 extern uint lineCount;
@@ -298,6 +300,7 @@ template<class T> void Array<T>::resizeMEM(uint n, bool copy, int Mforce) {
   if(Mnew!=Mold) {  //if M changed, allocate the memory
     globalMemoryTotal -= Mold*sizeT;
     globalMemoryTotal += Mnew*sizeT;
+    if(Mnew) globalMemoryAllocs++;
     if(globalMemoryTotal>globalMemoryBound){
       if(globalMemoryStrict){
         globalMemoryTotal -= Mnew*sizeT;
@@ -1714,6 +1717,118 @@ template<class T> void Array<T>::readBase64(std::istream& is) {
   free(code);
 }
 
+/** write a versioned binary record: "rArr" uint8(version) uint8(len) type-name uint32(sizeof(T)) uint32(nd) uint32(dim)*nd
+ *  uint64(N) uint8(pad) pad*0 then the raw data. The pad aligns the data to 8 bytes relative to the stream start, so that a
+ *  memory-mapped file can be viewed without copying. Only for trivially copyable T. */
+template<class T> void Array<T>::writeArchive(std::ostream& os) const {
+  if constexpr(!std::is_trivially_copyable<T>::value) {
+    HALT("binary archive only for arrays of trivially copyable types, not '" <<typeid(T).name() <<"'");
+  } else {
+    const char* name = rai::atomicTypeidName(typeid(T)); //portable across compilers, unlike typeid(T).name()
+    uint8_t len = strlen(name), version=1, pad=0;
+    uint32_t s=sizeof(T), n=nd;
+    uint64_t NN=N;
+    os.write("rArr", 4);
+    os.write((char*)&version, 1);
+    os.write((char*)&len, 1);
+    os.write(name, len);
+    os.write((char*)&s, 4);
+    os.write((char*)&n, 4);
+    for(uint i=0; i<nd; i++) { s=dim(i); os.write((char*)&s, 4); }
+    os.write((char*)&NN, 8);
+    std::streamoff at = os.tellp();
+    if(at>=0) pad = (8-(at+1)%8)%8; //non-seekable streams: no alignment
+    os.write((char*)&pad, 1);
+    uint64_t zero=0;
+    os.write((char*)&zero, pad);
+    if(N) os.write((char*)p, N*sizeof(T));
+  }
+}
+
+/// read a record written with writeArchive
+template<class T> Array<T>& Array<T>::readArchive(std::istream& is) {
+  if constexpr(!std::is_trivially_copyable<T>::value) {
+    HALT("binary archive only for arrays of trivially copyable types, not '" <<typeid(T).name() <<"'");
+  } else {
+    char tag[4];
+    uint8_t version=0, len=0, pad=0;
+    uint32_t s=0, n=0;
+    uint64_t NN=0;
+    is.read(tag, 4);
+    is.read((char*)&version, 1);
+    is.read((char*)&len, 1);
+    std::string name(len, 0);
+    is.read(&name[0], len);
+    is.read((char*)&s, 4);
+    is.read((char*)&n, 4);
+    CHECK(is.good() && !memcmp(tag, "rArr", 4) && version==1, "not an array archive (version 1)");
+    CHECK(name==rai::atomicTypeidName(typeid(T)) && s==sizeof(T), "archive type '" <<name <<"' does not match '" <<rai::atomicTypeidName(typeid(T)) <<"'");
+    CHECK_LE(n, 32, "corrupt dimensionality");
+    uintA dims(n);
+    for(uint i=0; i<n; i++) { is.read((char*)&s, 4); dims.elem(i)=s; }
+    is.read((char*)&NN, 8);
+    is.read((char*)&pad, 1);
+    is.ignore(pad);
+    uint64_t prod=1;
+    for(uint d:dims) prod*=d;
+    CHECK(is.good() && (n ? prod==NN : NN==0), "corrupt array archive header");
+    resize(NN);
+    if(NN) is.read((char*)p, NN*sizeof(T));
+    CHECK(is.good(), "could not read array archive data");
+    if(n>1) reshape(dims);
+    else if(n==0) clear();
+  }
+  return *this;
+}
+
+template<class T> size_t Array<T>::readArchive(const char* data, size_t size, size_t pos, bool view) {
+  if constexpr(!std::is_trivially_copyable<T>::value) {
+    HALT("binary archive only for arrays of trivially copyable types, not '" <<typeid(T).name() <<"'");
+  } else {
+#define ARCHERR(cond, msg) CHECK(cond, "array archive at position " <<pos <<": " <<msg)
+    auto get = [&](void* x, size_t n) { ARCHERR(pos+n<=size, "unexpected end of data"); memcpy(x, data+pos, n); pos+=n; };
+    char tag[4];
+    uint8_t version, len, pad;
+    uint32_t s, n;
+    uint64_t NN;
+    get(tag, 4);
+    ARCHERR(!memcmp(tag, "rArr", 4), "not an array record");
+    get(&version, 1);
+    ARCHERR(version==1, "unknown version " <<(int)version);
+    get(&len, 1);
+    ARCHERR(pos+len<=size, "unexpected end of data");
+    const char* name = rai::atomicTypeidName(typeid(T));
+    ARCHERR(len==strlen(name) && !memcmp(data+pos, name, len),
+            "type '" <<std::string(data+pos, len) <<"' does not match '" <<name <<"'");
+    pos+=len;
+    get(&s, 4);
+    ARCHERR(s==sizeof(T), "element size mismatch");
+    get(&n, 4);
+    ARCHERR(n<=32, "corrupt dimensionality " <<n);
+    uintA dims(n);
+    for(uint i=0; i<n; i++) { get(&s, 4); dims.elem(i)=s; }
+    get(&NN, 8);
+    get(&pad, 1);
+    pos += pad;
+    ARCHERR(NN<=(size-pos)/sizeof(T), "unexpected end of data");
+    uint64_t prod=1;
+    for(uint d:dims) prod*=d;
+    ARCHERR(n ? prod==NN : NN==0, "shape does not match number of elements");
+    const T* x = (const T*)(data+pos);
+    if(view && NN && !((size_t)x%alignof(T))) {
+      referTo(x, NN);
+    } else {
+      resize(NN);
+      if(NN) memcpy(p, x, NN*sizeof(T));
+    }
+    if(n>1) reshape(dims);
+    else if(n==0) clear();
+    pos += NN*sizeof(T);
+#undef ARCHERR
+    return pos;
+  }
+}
+
 /// write a json dict
 template<class T> void Array<T>::writeJson(std::ostream& os) const {
   os <<"[ \"" <<rai::atomicTypeidName(typeid(T)) <<"\", [";
@@ -938,6 +938,7 @@ void op_innerProduct(arr& x, const arr& y, const arr& z) {
       if(isSparseMatrix(z)) { x = z.sparse().B_A(y); return; }
       if(isRowShifted(y)) { x = y.rowShifted().A_B(z); return; }
       if(isRowShifted(z)) { x = z.rowShifted().B_A(y); return; }
+      if(!y.jac && !z.jac && fixed_innerProduct(x, y, z)) return;
       if(rai::useLapack){ blas_MM(x, y, z); return; }
     }
     double* a, *astop, *b, *c;
@@ -1178,6 +1179,12 @@ void op_crossProduct(arr& x, const arr& y, const arr& z) {
   }
   if(y.nd==2 && z.nd==1) { //every COLUMN of y is cross-product'd with z!
     CHECK(y.d0==3 && z.N==3, "cross product only works for 3D vectors!");
+    if(!isSpecial(y) && !y.jac && !z.jac) {
+      if(&x==&y) { arr tmp; op_crossProduct(tmp, y, z); x=tmp; return; }
+      x.resize(3, y.d1);
+      fixed_crossColumns(x.p, y.p, z.p, y.d1);
+      return;
+    }
     x = skew(-z) * y;
     if(y.jac || z.jac){
       //above should do autoDiff;
@@ -1187,6 +1194,22 @@ void op_crossProduct(arr& x, const arr& y, const arr& z) {
   HALT("cross product - not yet implemented for these dimensions");
 }
 
+bool fixed_innerProduct(arr& x, const arr& y, const arr& z) {
+  if(isSpecial(y) || isSpecial(z) || y.nd!=2 || z.nd!=2 || y.d0>4 || y.d1>4 || &x==&y || &x==&z) return false;
+  uint n=z.d1;
+#define FIXED_CASE(M, K) if(y.d0==M && y.d1==K) { x.resize(M, n); fixed_MM<M, K>(x.p, y.p, z.p, n); return true; }
+  FIXED_CASE(3, 3)
+  FIXED_CASE(4, 4)
+  FIXED_CASE(3, 4)
+  FIXED_CASE(4, 3)
+  FIXED_CASE(1, 3)
+  FIXED_CASE(3, 1)
+  FIXED_CASE(2, 3)
+  FIXED_CASE(3, 2)
+#undef FIXED_CASE
+  return false;
+}
+
 /// \f$\sum_i v_i\, w_i\f$, or \f$\sum_{ij} v_{ij}\, w_{ij}\f$, etc.
 double scalarProduct(const arr& v, const arr& w) {
   double t(0);
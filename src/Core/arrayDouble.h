@@ -408,6 +408,9 @@ uint inverse_SVD(arr& inverse, const arr& A);
 void inverse_LU(arr& Xinv, const arr& X);
 void inverse_SymPosDef(arr& Ainv, const arr& A);
 inline arr inverse_SymPosDef(const arr& A) { arr Ainv; inverse_SymPosDef(Ainv, A); return Ainv; }
+void solve_upperTriangular(arr& B, const arr& U, bool transpose=false); ///< B <- U^{-1} B (or U^{-T} B) in place; B may hold several right-hand sides as columns
+void cholesky_appendRow(arr& U, const arr& k, double kk); ///< extend the upper Cholesky factor of A=U^T U by a last row/column (k, kk) in O(n^2)
+void cholesky_removeRow(arr& U, uint i); ///< remove row/column i of A=U^T U from its upper Cholesky factor by a rank-one update in O(n^2)
 arr pseudoInverse(const arr& A, const arr& Winv=NoArr, double robustnessEps=1e-10);
 void gaussFromData(arr& a, arr& A, const arr& X);
 void rotationFromAtoB(arr& R, const arr& a, const arr& v);
@@ -527,6 +530,34 @@ void op_outerProduct(arr& x, const arr& y, const arr& z);
 void op_indexWiseProduct(arr& x, const arr& y, const arr& z);
 void op_crossProduct(arr& x, const arr& y, const arr& z); //only for 3 x 3 or (3,n) x 3
 inline arr crossProduct(const arr& y, const arr& z){ arr x; op_crossProduct(x,y,z); return x; }
+
+// fixed-size kernels for small dense (Jacobian) algebra on row-major raw data: the row dimensions are
+// compile-time; the inner loops run over the n contiguous columns (no CHECKs, no allocation) and vectorize
+template<uint M, uint K> inline void fixed_MM(double* C, const double* A, const double* B, uint n) { ///< C(M,n) = A(M,K) * B(K,n)
+  for(uint i=0; i<M; i++) {
+    double* c=C+i*n;
+    const double* b=B;
+    double a=A[i*K];
+    for(uint j=0; j<n; j++) c[j] = a*b[j];
+    for(uint k=1; k<K; k++) {
+      a=A[i*K+k];
+      b=B+k*n;
+      for(uint j=0; j<n; j++) c[j] += a*b[j];
+    }
+  }
+}
+inline void fixed_crossColumns(double* C, const double* B, const double* v, uint n) { ///< C(3,n): column j = B(:,j) x v
+  const double *b0=B, *b1=B+n, *b2=B+2*n;
+  double *c0=C, *c1=C+n, *c2=C+2*n;
+  for(uint j=0; j<n; j++) {
+    double x=b0[j], y=b1[j], z=b2[j];
+    c0[j] = y*v[2] - z*v[1];
+    c1[j] = z*v[0] - x*v[2];
+    c2[j] = x*v[1] - y*v[0];
+  }
+}
+bool fixed_innerProduct(arr& x, const arr& y, const arr& z); ///< dispatch small dense y (up to 4x4) to fixed_MM; returns false if not applicable
+
 double scalarProduct(const arr& v, const arr& w);
 double scalarProduct(const arr& g, const arr& v, const arr& w);
 
@@ -23,6 +23,9 @@ const char* atomicTypeidName(const std::type_info& type){
   if(type==typeid(int16_t)) return "int16";
   if(type==typeid(uint)) return "uint32";
   if(type==typeid(uint16_t)) return "uint16";
+  if(type==typeid(unsigned char)) return "uint8";
+  if(type==typeid(int64_t)) return "int64";
+  if(type==typeid(uint64_t)) return "uint64";
   if(type==typeid(float)) return "float32";
   if(type==typeid(double)) return "float64";
   THROW("not yet defined string for type" <<type.name())
@@ -83,13 +83,39 @@ Node::Node(const std::type_info& _type, Graph& _container, const char* _key)
   container.NodeL::append(this);
 }
 
+void Node::setKey(const char* _key) {
+  Graph& G = container;
+  if(G.keyIndexN && (!G.isIndexed || index<G.keyIndexN)) { //the node is covered by the key index: move it to its new key
+    auto it = G.keyIndex.find(key.p?key.p:"");
+    if(G.isIndexed && it!=G.keyIndex.end() && it->second.removeValue(this, false)) {
+      NodeL& L = G.keyIndex[_key?_key:""];
+      uint i=0;
+      while(i<L.N && L.elem(i)->index<index) i++;
+      L.insert(i, this);
+    } else {
+      G.clearKeyIndex();
+    }
+  }
+  key = _key;
+}
+
 Node::~Node() {
   if(container.isDoubleLinked) while(children.N) children.elem(-1)->removeParent(this);
   if(numChildren) LOG(-2) <<"It is not allowed to delete nodes that still have children";
   while(parents.N) removeParent(parents.elem(-1));
   if(this==container.elem(-1)) { //great: this is very efficient to remove without breaking indexing
+    if(container.keyIndexN==container.N) { //remove from the key index
+      auto it = container.keyIndex.find(key.p?key.p:"");
+      if(it!=container.keyIndex.end() && it->second.N && it->second.last()==this) {
+        it->second.resizeCopy(it->second.N-1);
+        container.keyIndexN--;
+      } else {
+        container.clearKeyIndex();
+      }
+    }
     container.resizeCopy(container.N-1);
   } else {
+    container.clearKeyIndex();
     container.removeValue(this);
     container.isIndexed=false;//  container.index();
   }
@@ -164,7 +190,11 @@ void Node::write(std::ostream& os, int indent, bool yamlMode, bool binary) const
   //-- colon separator
   if(key.N || parents.N) os <<": ";
 
-  //-- write value
+  writeValueText(os, indent, yamlMode, binary);
+}
+
+/// write only the value in the text format (as after the colon)
+void Node::writeValueText(std::ostream& os, int indent, bool yamlMode, bool binary) const {
   if(is<Graph>()) {
     if(yamlMode && indent>=0){
       graph().write(os, ",\n", "{}", indent, yamlMode, binary);
@@ -302,6 +332,7 @@ void Graph::clear() {
     delete *n;
   }
   isIndexed=true;
+  archive.reset();
 }
 
 Graph& Graph::add(const NodeInitializer& ni) {
@@ -335,10 +366,42 @@ void Graph::appendDict(const std::map<std::string, std::string>& dict) {
   }
 }
 
+//graphs with fewer nodes are searched linearly
+#define RAI_GRAPH_KEYINDEX_MINN 32
+
+const NodeL* Graph::findKeyIndexed(const char* key) const {
+  if(!key || N<RAI_GRAPH_KEYINDEX_MINN) return nullptr;
+  if(keyIndexN>N) clearKeyIndex();
+  //index nodes appended since the last lookup
+  for(; keyIndexN<N; keyIndexN++) {
+    Node* n = elem(keyIndexN);
+    keyIndex[n->key.p?n->key.p:""].append(n);
+  }
+  auto it = keyIndex.find(key);
+  bool stale=false;
+  if(it!=keyIndex.end() && it->second.N) {
+    for(Node* n:it->second) if(!(n->key==key)) { stale=true; break; }
+    if(!stale) return &it->second;
+  } else {
+    //a miss can be a key written directly (not via setKey): confirm with the linear scan
+    for(Node* n:*this) if(n->key==key) { stale=true; break; }
+    if(!stale) return nullptr;
+  }
+  //the index is out of date: rebuild once
+  clearKeyIndex();
+  return findKeyIndexed(key);
+}
+
 Node* Graph::findNode(const char* key, bool recurseUp, bool recurseDown) const {
 //  for(uint i=N;i--;) if(elem(i)->matches(key)) return elem(i);
-  for(Node *n:(*this)) if(n->key==key) return n;
   Node* ret=nullptr;
+  if(N>=RAI_GRAPH_KEYINDEX_MINN && key) {
+    std::lock_guard<std::mutex> lock(keyIndexMutex);
+    const NodeL* L = findKeyIndexed(key);
+    if(L) return L->elem(0);
+  } else {
+    for(Node *n:(*this)) if(n->key==key) return n;
+  }
   if(recurseUp && isNodeOfGraph) ret = isNodeOfGraph->container.findNode(key, true, false);
   if(ret) return ret;
   if(recurseDown){
@@ -351,7 +414,13 @@ Node* Graph::findNode(const char* key, bool recurseUp, bool recurseDown) const {
 }
 
 Node* Graph::findNodeOfType(const std::type_info& type, const char* key, bool recurseUp, bool recurseDown) const {
-  for(Node* n: (*this)) if(n->type==type && (!key || n->key==key)) return n;
+  if(N>=RAI_GRAPH_KEYINDEX_MINN && key) {
+    std::lock_guard<std::mutex> lock(keyIndexMutex);
+    const NodeL* L = findKeyIndexed(key);
+    if(L) for(Node* n: *L) if(n->type==type && n->key==key) return n;
+  } else {
+    for(Node* n: (*this)) if(n->type==type && (!key || n->key==key)) return n;
+  }
   Node* ret=nullptr;
   if(recurseUp && isNodeOfGraph) ret = isNodeOfGraph->container.findNodeOfType(type, key, true, false);
   if(ret) return ret;
@@ -364,7 +433,13 @@ Node* Graph::findNodeOfType(const std::type_info& type, const char* key, bool re
 
 NodeL Graph::findNodes(const char* key, bool recurseUp, bool recurseDown) const {
   NodeL ret;
-  for(Node* n: (*this)) if(n->key==key) ret.append(n);
+  if(N>=RAI_GRAPH_KEYINDEX_MINN && key) {
+    std::lock_guard<std::mutex> lock(keyIndexMutex);
+    const NodeL* L = findKeyIndexed(key);
+    if(L) for(Node* n: *L) if(n->key==key) ret.append(n);
+  } else {
+    for(Node* n: (*this)) if(n->key==key) ret.append(n);
+  }
   if(recurseUp && isNodeOfGraph) ret.append(isNodeOfGraph->container.findNodes(key, true, false));
   if(recurseDown) for(Node* n: (*this)) if(n->is<Graph>()) ret.append(n->graph().findNodes(key, false, true));
   return ret;
@@ -372,7 +447,13 @@ NodeL Graph::findNodes(const char* key, bool recurseUp, bool recurseDown) const
 
 NodeL Graph::findNodesOfType(const std::type_info& type, const char* key, bool recurseUp, bool recurseDown) const {
   NodeL ret;
-  for(Node* n: (*this)) if(n->type==type && (!key || n->key==key)) ret.append(n);
+  if(N>=RAI_GRAPH_KEYINDEX_MINN && key) {
+    std::lock_guard<std::mutex> lock(keyIndexMutex);
+    const NodeL* L = findKeyIndexed(key);
+    if(L) for(Node* n: *L) if(n->type==type && n->key==key) ret.append(n);
+  } else {
+    for(Node* n: (*this)) if(n->type==type && (!key || n->key==key)) ret.append(n);
+  }
   if(recurseUp && isNodeOfGraph) ret.append(isNodeOfGraph->container.findNodesOfType(type, key, true, false));
   if(recurseDown) for(Node* n: (*this)) if(n->is<Graph>()) ret.append(n->graph().findNodesOfType(type, key, false, true));
   return ret;
@@ -489,6 +570,7 @@ Node* Graph::edit(Node* ed) {
 }
 
 bool Graph::checkUniqueKeys(bool makeUnique){
+  if(makeUnique) clearKeyIndex();
   for(Node* a: list()){
     if(makeUnique && !a->key.N) a->key <<'_' <<a->index;
     for(Node* b: list()) {
@@ -636,7 +718,7 @@ void Graph::read(std::istream& is, bool parseInfo) {
       read(n->as<FileToken>().getIs(true), parseInfo);
       if(namePrefix.N) { //prepend a naming prefix to all nodes just read
         for(uint i=Nbefore; i<N; i++){
-          elem(i)->key.prepend(namePrefix);
+          elem(i)->setKey(STRING(namePrefix <<elem(i)->key));
           rai::String *tmp=0;
           if(elem(i)->is<Graph>()) tmp=elem(i)->graph().find<rai::String>("mimic");
           if(tmp) tmp->prepend(namePrefix);
@@ -694,6 +776,7 @@ void Graph::read(std::istream& is, bool parseInfo) {
         n->graph().add<bool>(STRING('%' <<n->key.getSubString(0, i-1)), true);
         n->key.replace(0, j, 0, 0);
       }
+      if(n->index<keyIndexN) clearKeyIndex(); //n was indexed with its unsplit key
     }
   }
 
@@ -721,6 +804,7 @@ void Graph::read(std::istream& is, bool parseInfo) {
         while(n->key.N && n->key(-1)==' ') n->key.resize(n->key.N-1, true);
       }
     }
+    clearKeyIndex();
     for(uint i=Nbefore; i<N; i++) {
       if(parentTags(i).N){
         Node* n=elem(i);
@@ -1150,6 +1234,219 @@ void Graph::writeYaml(std::ostream& os){
   write(os, "\n", 0, -1, true, false);
 }
 
+//===========================================================================
+//
+// binary archive
+//
+
+/* format: "rGrf" uint8(version) uint32(0x01020304, byte order check), then the root graph
+ *   graph:  uint32(#nodes) node*#nodes
+ *   node:   string(key) refs(parents) uint8(type) value
+ *   string: uint32(len) char*len
+ *   refs:   uint32(n) [uint32(levels up) uint32(index)]*n -- parents may live in containing graphs
+ *   value:  bool uint8, int int32, uint uint32, double, String string, StringA uint32(n) string*n, NodeL refs,
+ *           Graph graph, arr/floatA/intA/uintA/uint16A/byteA as Array::writeArchive records, else text as string */
+
+namespace {
+
+enum ArchiveType : uint8_t { AT_bool=0, AT_int, AT_uint, AT_double, AT_String, AT_StringA, AT_NodeL, AT_Graph,
+                             AT_arr, AT_floatA, AT_intA, AT_uintA, AT_uint16A, AT_byteA, AT_text };
+
+void archiveWrite(std::ostream& os, const void* x, uint n) { os.write((const char*)x, n); }
+void archiveWriteUint(std::ostream& os, uint32_t x) { os.write((const char*)&x, 4); }
+void archiveWriteType(std::ostream& os, uint8_t x) { os.write((const char*)&x, 1); }
+void archiveWriteString(std::ostream& os, const String& str) { archiveWriteUint(os, str.N); os.write(str.p, str.N); }
+
+void archiveWriteRefs(std::ostream& os, const Graph& G, const NodeL& L) {
+  archiveWriteUint(os, L.N);
+  for(Node* p:L) {
+    uint32_t up=0;
+    const Graph* g=&G;
+    while(g!=&p->container) {
+      CHECK(g->isNodeOfGraph, "node '" <<*p <<"' is neither in this graph nor a containing graph -- can't archive the reference");
+      g = &g->isNodeOfGraph->container;
+      up++;
+    }
+    archiveWriteUint(os, up);
+    archiveWriteUint(os, p->index);
+  }
+}
+
+void archiveWriteGraph(std::ostream& os, const Graph& G) {
+  if(!G.isIndexed) const_cast<Graph&>(G).index();
+  archiveWriteUint(os, G.N);
+  for(Node* n:G) {
+    archiveWriteString(os, n->key);
+    archiveWriteRefs(os, G, n->parents);
+    if(n->is<bool>()) { archiveWriteType(os, AT_bool); uint8_t b=n->as<bool>(); archiveWrite(os, &b, 1); }
+    else if(n->is<int>()) { archiveWriteType(os, AT_int); int32_t x=n->as<int>(); archiveWrite(os, &x, 4); }
+    else if(n->is<uint>()) { archiveWriteType(os, AT_uint); archiveWriteUint(os, n->as<uint>()); }
+    else if(n->is<double>()) { archiveWriteType(os, AT_double); archiveWrite(os, &n->as<double>(), 8); }
+    else if(n->is<String>()) { archiveWriteType(os, AT_String); archiveWriteString(os, n->as<String>()); }
+    else if(n->is<StringA>()) {
+      archiveWriteType(os, AT_StringA);
+      archiveWriteUint(os, n->as<StringA>().N);
+      for(const String& str:n->as<StringA>()) archiveWriteString(os, str);
+    }
+    else if(n->is<NodeL>()) { archiveWriteType(os, AT_NodeL); archiveWriteRefs(os, G, n->as<NodeL>()); }
+    else if(n->is<Graph>()) { archiveWriteType(os, AT_Graph); archiveWriteGraph(os, n->graph()); }
+    else if(n->is<arr>()) { archiveWriteType(os, AT_arr); n->as<arr>().writeArchive(os); }
+    else if(n->is<floatA>()) { archiveWriteType(os, AT_floatA); n->as<floatA>().writeArchive(os); }
+    else if(n->is<intA>()) { archiveWriteType(os, AT_intA); n->as<intA>().writeArchive(os); }
+    else if(n->is<uintA>()) { archiveWriteType(os, AT_uintA); n->as<uintA>().writeArchive(os); }
+    else if(n->is<uint16A>()) { archiveWriteType(os, AT_uint16A); n->as<uint16A>().writeArchive(os); }
+    else if(n->is<byteA>()) { archiveWriteType(os, AT_byteA); n->as<byteA>().writeArchive(os); }
+    else { //all other types: as in the text format
+      archiveWriteType(os, AT_text);
+      String txt;
+      n->writeValueText(txt);
+      archiveWriteString(os, txt);
+    }
+  }
+}
+
+struct ArchiveReader {
+  const char* data;
+  size_t size, pos=0;
+  bool view;
+  Graph* root;
+  uint rootOffset;
+  struct Refs { Node* n; Graph* G; uintA refs; bool isValue; };
+  std::vector<Refs> refs; //resolved after all nodes exist
+
+  ArchiveReader(const char* _data, size_t _size, bool _view, Graph& G) : data(_data), size(_size), view(_view), root(&G), rootOffset(G.N) {}
+
+  void get(void* x, size_t n) {
+    CHECK_LE(pos+n, size, "graph archive: unexpected end of data");
+    memcpy(x, data+pos, n);
+    pos+=n;
+  }
+  uint32_t getUint() { uint32_t x; get(&x, 4); return x; }
+  String getString() {
+    uint32_t n=getUint();
+    CHECK_LE(pos+n, size, "graph archive: unexpected end of data");
+    String str;
+    str.set(data+pos, n);
+    pos+=n;
+    return str;
+  }
+  uintA getRefs() {
+    uint32_t n=getUint();
+    uintA L(n, 2);
+    for(uint i=0; i<n; i++) { L(i, 0)=getUint(); L(i, 1)=getUint(); }
+    return L;
+  }
+
+  void read(Graph& G) {
+    char tag[4];
+    uint8_t version;
+    uint32_t order;
+    get(tag, 4);
+    CHECK(!memcmp(tag, "rGrf", 4), "not a graph archive");
+    get(&version, 1);
+    CHECK_EQ(version, 1, "unknown graph archive version");
+    get(&order, 4);
+    CHECK_EQ(order, 0x01020304, "graph archive was written with a different byte order");
+    readGraph(G);
+    for(Refs& r:refs) {
+      NodeL L(r.refs.d0);
+      for(uint i=0; i<L.N; i++) {
+        Graph* g=r.G;
+        for(uint up=r.refs(i, 0); up--;) { CHECK(g->isNodeOfGraph, "graph archive: corrupt parent reference"); g=&g->isNodeOfGraph->container; }
+        uint idx = r.refs(i, 1) + (g==root ? rootOffset : 0);
+        CHECK(idx<g->N, "graph archive: corrupt parent reference");
+        L.elem(i) = g->elem(idx);
+      }
+      if(r.isValue) r.n->as<NodeL>() = L;
+      else if(L.N) r.n->setParents(L);
+    }
+  }
+
+  void readGraph(Graph& G) {
+    uint32_t N=getUint();
+    for(uint i=0; i<N; i++) {
+      String key = getString();
+      uintA par = getRefs();
+      uint8_t type;
+      get(&type, 1);
+      Node* n=0;
+      switch(type) {
+        case AT_bool: { uint8_t b; get(&b, 1); n = G.add<bool>(key, b); } break;
+        case AT_int: { int32_t x; get(&x, 4); n = G.add<int>(key, x); } break;
+        case AT_uint: { n = G.add<uint>(key, getUint()); } break;
+        case AT_double: { double x; get(&x, 8); n = G.add<double>(key, x); } break;
+        case AT_String: { n = G.add<String>(key, getString()); } break;
+        case AT_StringA: {
+          StringA S(getUint());
+          for(String& str:S) str = getString();
+          n = G.add<StringA>(key, S);
+        } break;
+        case AT_NodeL: { n = G.add<NodeL>(key, NodeL()); refs.push_back({n, &G, getRefs(), true}); } break;
+        case AT_Graph: { Graph& sub = G.addSubgraph(key); n = sub.isNodeOfGraph; readGraph(sub); } break;
+        case AT_arr: { n = G.add<arr>(key); pos = n->as<arr>().readArchive(data, size, pos, view); } break;
+        case AT_floatA: { n = G.add<floatA>(key); pos = n->as<floatA>().readArchive(data, size, pos, view); } break;
+        case AT_intA: { n = G.add<intA>(key); pos = n->as<intA>().readArchive(data, size, pos, view); } break;
+        case AT_uintA: { n = G.add<uintA>(key); pos = n->as<uintA>().readArchive(data, size, pos, view); } break;
+        case AT_uint16A: { n = G.add<uint16A>(key); pos = n->as<uint16A>().readArchive(data, size, pos, view); } break;
+        case AT_byteA: { n = G.add<byteA>(key); pos = n->as<byteA>().readArchive(data, size, pos, view); } break;
+        case AT_text: {
+          String txt;
+          txt <<"_: " <<getString();
+          n = G.readNode(txt, false, false);
+          CHECK(n, "graph archive: could not parse the text value of node '" <<key <<"'");
+          n->setKey(key);
+        } break;
+        default: HALT("graph archive: unknown value type " <<(int)type);
+      }
+      if(par.N) refs.push_back({n, &G, par, false});
+    }
+  }
+};
+
+} //namespace
+
+void Graph::writeArchive(std::ostream& os) const {
+  uint8_t version=1;
+  os.write("rGrf", 4);
+  archiveWrite(os, &version, 1);
+  archiveWriteUint(os, 0x01020304);
+  archiveWriteGraph(os, *this);
+  os <<std::flush;
+}
+
+void Graph::writeArchive(const char* filename) const {
+  std::ofstream fil(filename, std::ios::binary);
+  CHECK(fil.good(), "could not open file '" <<filename <<"' for output");
+  writeArchive(fil);
+}
+
+void Graph::readArchive(std::istream& is) {
+  std::string buf;
+  std::streamoff beg = is.tellg();
+  if(beg>=0 && is.seekg(0, std::ios::end)) { //seekable: read in one go
+    buf.resize((std::streamoff)is.tellg()-beg);
+    is.seekg(beg);
+    is.read(&buf[0], buf.size());
+  } else {
+    is.clear();
+    buf.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  }
+  ArchiveReader(buf.data(), buf.size(), false, *this).read(*this);
+}
+
+void Graph::readArchive(const char* filename, bool mmap) {
+  if(!mmap) {
+    std::ifstream fil(filename, std::ios::binary);
+    CHECK(fil.good(), "could not open file '" <<filename <<"'");
+    readArchive(fil);
+    return;
+  }
+  CHECK(!archive, "this graph already holds a mapped archive -- clear it first");
+  auto file = std::make_shared<MappedFile>(filename);
+  ArchiveReader(file->data, file->size, true, *this).read(*this);
+  archive = file;
+}
+
 void Graph::writeParseInfo(std::ostream& os) {
   os <<"GRAPH " <<getParseInfo(nullptr) <<endl;
   for(Node* n:*this)
@@ -1268,6 +1565,7 @@ void Graph::sortByDotOrder() {
     }
   }
   permuteInv(perm);
+  clearKeyIndex();
   it_COUNT=0;
   for(Node *it: list()) it->index=it_COUNT++;
 }
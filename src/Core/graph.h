@@ -13,6 +13,8 @@
 
 #include <math.h>
 #include <map>
+#include <unordered_map>
+#include <mutex>
 #include <memory>
 
 //===========================================================================
@@ -37,7 +39,7 @@ namespace rai {
 struct Node {
   const std::type_info& type;
   Graph& container;
-  String key;
+  String key;       ///< rename via setKey: in searched large graphs, a direct write makes the next lookup rebuild the key index
   NodeL parents;
   NodeL children;
   uint numChildren=0;
@@ -46,6 +48,8 @@ struct Node {
   Node(const std::type_info& _type, Graph& _container, const char* _key);
   virtual ~Node();
 
+  void setKey(const char* _key); ///< renames the node and keeps the container's key index consistent
+
   Node* addParent(Node* p, bool prepend=false);
   Node* setParents(const NodeL& P);
   void removeParent(Node* p);
@@ -76,6 +80,7 @@ struct Node {
   }
 
   void write(std::ostream& os, int indent=-1, bool yamlMode=false, bool binary=false) const;
+  void writeValueText(std::ostream& os, int indent=-1, bool yamlMode=false, bool binary=false) const;
 
   //-- virtuals implemented by Node_typed
   virtual void copyValue(Node*) {NIY}
@@ -100,6 +105,12 @@ struct Graph : NodeL {
   ArrayG<ParseInfo>* pi;     ///< optional annotation of nodes: when detailed file parsing is enabled
   ArrayG<RenderingInfo>* ri; ///< optional annotation of nodes: dot style commands
 
+  mutable std::unordered_map<std::string, NodeL> keyIndex; ///< lazily built key->nodes index, used by find* for large graphs
+  mutable uint keyIndexN=0;                                 ///< number of (leading) nodes covered by keyIndex
+  mutable std::mutex keyIndexMutex;                         ///< the const find* extend keyIndex: concurrent lookups serialize on this
+
+  std::shared_ptr<MappedFile> archive; ///< set by readArchive(filename, true): keeps the mapping alive while array nodes refer into it
+
   //-- constructors
   Graph();                                               ///< empty graph
   explicit Graph(const char* filename, bool parseInfo=false);         ///< read from a file
@@ -137,6 +148,8 @@ struct Graph : NodeL {
   Node* findNodeOfType(const std::type_info& type, const char* key, bool recurseUp=false, bool recurseDown=false) const;
   NodeL findNodesOfType(const std::type_info& type, const char* key, bool recurseUp=false, bool recurseDown=false) const;
   NodeL findGraphNodesWithTag(const char* tag) const;
+  const NodeL* findKeyIndexed(const char* key) const; ///< (internal) hashed lookup of the local nodes with that key; nullptr if not found; caller holds keyIndexMutex
+  void clearKeyIndex() const { keyIndex.clear(); keyIndexN=0; }
 
   //-- get nodes
   Node* operator[](const char* key) const { return findNode(key); } ///< returns nullptr if not found
@@ -185,6 +198,10 @@ struct Graph : NodeL {
   Node* readNode(std::istream& is, bool verbose, bool parseInfo); //used only internally..
   void readJson(std::istream& is);
   void writeJson(std::istream& is);
+  void writeArchive(std::ostream& os) const;  ///< versioned binary format with typed values, nested subgraphs and aligned raw arrays
+  void writeArchive(const char* filename) const;
+  void readArchive(std::istream& is);
+  void readArchive(const char* filename, bool mmap=false); ///< mmap: array nodes become zero-copy views into the mapped file
   void write(std::ostream& os=cout, const char* ELEMSEP=",\n", const char* BRACKETS=0, int indent=-1, bool yamlMode=false, bool binary=false) const;
   void writeDot(std::ostream& os, bool withoutHeader=false, bool defaultEdges=false, int nodesOrEdges=0, int focusIndex=-1, bool subGraphsAsNodes=false);
   void writeHtml(std::ostream& os, std::istream& is);
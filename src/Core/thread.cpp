@@ -25,6 +25,14 @@
 #endif
 #include <errno.h>
 
+#ifdef RAI_Linux
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <linux/futex.h>
+#  include <limits.h>
+#endif
+
 //===========================================================================
 
 template<> const char* rai::Enum<ActStatus>::names []= {
@@ -278,6 +286,245 @@ int Var_base::deAccess(Thread* th) {
   return i;
 }
 
+//===========================================================================
+//
+// Var_shm
+//
+
+#ifdef RAI_Linux
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free, "shared memory atomics need to be lock-free");
+
+struct Var_shm::Header {
+  std::atomic<uint32_t> magic;    ///< set last on creation
+  uint32_t slots, elemSize;
+  uint64_t capacity;              ///< bytes per slot
+  char elemType[32];
+  std::atomic<uint32_t> revision; ///< futex word: number of published writes
+  std::atomic<uint32_t> waiters;  ///< number of readers blocking on revision (writers only wake if >0)
+  std::atomic<uint32_t> writeLock; ///< pid of the writing process, 0 if unlocked
+};
+
+struct Var_shm::Slot {
+  std::atomic<uint32_t> seq;      ///< 2*revision once published, odd while being written
+  std::atomic<uint32_t> nd, dim[4];
+  std::atomic<double> data_time;
+};
+
+static const uint32_t shmMagic = 0x5241494d;
+
+static rai::String shmName(const char* name) { rai::String s; s <<"/rai_" <<name; return s; }
+
+static bool stealDeadWriteLock(std::atomic<uint32_t>& lock, uint32_t owner) {
+  //the owner crashed while holding the lock: its pid is gone
+  return owner && kill(owner, 0) && errno==ESRCH && lock.compare_exchange_strong(owner, 0);
+}
+
+static long futex(const std::atomic<uint32_t>* addr, int op, uint32_t val, const struct timespec* timeout=nullptr) {
+  return syscall(SYS_futex, (uint32_t*)addr, op, val, timeout, nullptr, 0); //not FUTEX_PRIVATE: shared between processes
+}
+
+void Var_shm::map(int fd, bool writable) {
+  void* m = mmap(nullptr, size, PROT_READ | (writable?PROT_WRITE:0), MAP_SHARED, fd, 0);
+  close(fd);
+  if(m==MAP_FAILED) HALT("could not map shared variable '" <<name <<"': " <<strerror(errno));
+  head = (Header*)m;
+}
+
+static size_t shmLayout(uint slots, uint64_t capacity, size_t& metaOffset, size_t& dataOffset, uint64_t& stride) {
+  metaOffset = (sizeof(Var_shm::Header)+63)/64*64;
+  dataOffset = (metaOffset+slots*sizeof(Var_shm::Slot)+63)/64*64;
+  stride = (capacity+63)/64*64;
+  return dataOffset+slots*stride;
+}
+
+Var_shm::Var_shm(const char* _name, const char* elemType, uint elemSize, uint _capacity, uint slots) : name(_name) {
+  CHECK_GE(slots, 2, "need at least two slots");
+  CHECK_LE(strlen(elemType), 31, "");
+  size_t metaOffset, dataOffset;
+  size = shmLayout(slots, _capacity, metaOffset, dataOffset, stride);
+  int fd = shm_open(shmName(name), O_CREAT | O_RDWR, 0600);
+  if(fd<0) HALT("could not create shared variable '" <<name <<"': " <<strerror(errno));
+  struct stat sb;
+  if(fstat(fd, &sb)) HALT("could not stat shared variable '" <<name <<"'");
+  bool exists = sb.st_size>0;
+  if(exists) {
+    CHECK_EQ((size_t)sb.st_size, size, "shared variable '" <<name <<"' exists with a different layout -- unlink it first");
+  } else if(ftruncate(fd, size)) {
+    HALT("could not size shared variable '" <<name <<"': " <<strerror(errno));
+  }
+  map(fd, true);
+  slotMeta = (Slot*)((char*)head+metaOffset);
+  slotData = (char*)head+dataOffset;
+  if(exists && head->magic.load(std::memory_order_acquire)==shmMagic) { //re-attach, e.g. after a writer restart
+    CHECK(head->slots==slots && head->capacity==_capacity && head->elemSize==elemSize && !strcmp(head->elemType, elemType),
+          "shared variable '" <<name <<"' exists with a different layout -- unlink it first");
+    stealDeadWriteLock(head->writeLock, head->writeLock.load());
+  } else {
+    head->slots=slots;
+    head->elemSize=elemSize;
+    head->capacity=_capacity;
+    strcpy(head->elemType, elemType);
+    head->revision=0;
+    head->waiters=0;
+    head->writeLock=0;
+    for(uint i=0; i<slots; i++) slotMeta[i].seq=0;
+    head->magic.store(shmMagic, std::memory_order_release);
+  }
+}
+
+Var_shm::Var_shm(const char* _name, const char* elemType, uint elemSize, double timeout) : name(_name) {
+  double t0 = rai::realTime();
+  int fd;
+  for(;;) { //wait for the segment to exist and be initialized
+    fd = shm_open(shmName(name), O_RDWR, 0600);
+    if(fd>=0) {
+      struct stat sb;
+      if(!fstat(fd, &sb) && sb.st_size>=(off_t)sizeof(Header)) {
+        size = sb.st_size;
+        map(fd, true);
+        if(head->magic.load(std::memory_order_acquire)==shmMagic) break;
+        munmap(head, size);
+        head=0;
+      } else close(fd);
+    }
+    if(rai::realTime()-t0>timeout) HALT("shared variable '" <<name <<"' does not exist (after waiting " <<timeout <<"sec)");
+    rai::wait(.001);
+  }
+  CHECK(head->elemSize==elemSize && !strcmp(head->elemType, elemType),
+        "shared variable '" <<name <<"' has element type '" <<head->elemType <<"', not '" <<elemType <<"'");
+  size_t metaOffset, dataOffset;
+  CHECK_EQ(shmLayout(head->slots, head->capacity, metaOffset, dataOffset, stride), size, "corrupt shared variable '" <<name <<"'");
+  slotMeta = (Slot*)((char*)head+metaOffset);
+  slotData = (char*)head+dataOffset;
+}
+
+Var_shm::~Var_shm() {
+  if(listener.joinable()) {
+    stopListener=true;
+    futex(&head->revision, FUTEX_WAKE, INT_MAX);
+    listener.join();
+  }
+  for(auto* c:callbacks) delete c;
+  if(head) munmap(head, size);
+}
+
+void Var_shm::unlink(const char* name) { shm_unlink(shmName(name)); }
+
+int Var_shm::getRevision() const { return head->revision.load(std::memory_order_acquire); }
+
+uint Var_shm::capacity() const { return head->capacity; }
+
+int Var_shm::waitForRevisionGreaterThan(int rev, double timeout) const {
+  double t0 = timeout>=0. ? rai::realTime() : 0.;
+  for(;;) {
+    uint32_t r = head->revision.load(std::memory_order_acquire);
+    if((int)r>rev || stopListener) return r;
+    struct timespec ts, *tsp=nullptr;
+    if(timeout>=0.) {
+      double left = timeout - (rai::realTime()-t0);
+      if(left<=0.) return r;
+      ts.tv_sec = (time_t)left;
+      ts.tv_nsec = (long)((left-ts.tv_sec)*1e9);
+      tsp = &ts;
+    }
+    head->waiters.fetch_add(1);
+    futex(&head->revision, FUTEX_WAIT, r, tsp); //returns immediately if the revision changed in between
+    head->waiters.fetch_sub(1);
+  }
+}
+
+char* Var_shm::beginWrite() {
+  uint32_t expected=0, pid=getpid();
+  for(uint k=1; !head->writeLock.compare_exchange_weak(expected, pid, std::memory_order_acquire); k++) {
+    if(!(k%1024)) stealDeadWriteLock(head->writeLock, expected); //check the owner only now and then
+    expected=0;
+    std::this_thread::yield();
+  }
+  uint32_t rev = head->revision.load(std::memory_order_relaxed)+1;
+  wrSlot = rev%head->slots;
+  Slot& s = slotMeta[wrSlot];
+  s.seq.store(2*rev-1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  return slotData + wrSlot*stride;
+}
+
+int Var_shm::endWrite(uint nd, const uint* dim, double dataTime) {
+  CHECK_LE(nd, 4, "");
+  Slot& s = slotMeta[wrSlot];
+  s.nd.store(nd, std::memory_order_relaxed);
+  for(uint i=0; i<nd; i++) s.dim[i].store(dim[i], std::memory_order_relaxed);
+  s.data_time.store(dataTime>=0. ? dataTime : rai::clockTime(), std::memory_order_relaxed);
+  uint32_t rev = head->revision.load(std::memory_order_relaxed)+1;
+  s.seq.store(2*rev, std::memory_order_release);
+  head->revision.store(rev); //seq_cst: must not be reordered with the waiters load below, or a reader that just registered is never woken
+  head->writeLock.store(0, std::memory_order_release);
+  if(head->waiters.load()) futex(&head->revision, FUTEX_WAKE, INT_MAX);
+  return rev;
+}
+
+const char* Var_shm::readSlot(int& revision, uint& nd, uint* dim, double& dataTime) const {
+  for(;;) {
+    uint32_t rev = head->revision.load(std::memory_order_acquire);
+    revision = rev;
+    if(!rev) { nd=0; dataTime=0.; return nullptr; }
+    uint i = rev%head->slots;
+    const Slot& s = slotMeta[i];
+    if(s.seq.load(std::memory_order_acquire)!=2*rev) continue; //overwritten meanwhile (writer wrapped around)
+    nd = s.nd.load(std::memory_order_relaxed);
+    for(uint k=0; k<nd && k<4; k++) dim[k] = s.dim[k].load(std::memory_order_relaxed);
+    dataTime = s.data_time.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(s.seq.load(std::memory_order_relaxed)==2*rev) return slotData + i*stride;
+  }
+}
+
+bool Var_shm::isValid(int revision) const {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slotMeta[revision%head->slots].seq.load(std::memory_order_relaxed)==2*(uint32_t)revision;
+}
+
+void Var_shm::addCallback(const std::function<void(Var_shm*, int)>& call, const void* callbackID) {
+  {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    callbacks.append(new Callback<void(Var_shm*, int)>(callbackID, call));
+  }
+  if(!listener.joinable()) listener = std::thread(&Var_shm::listen, this);
+}
+
+void Var_shm::listen() {
+  int rev = getRevision();
+  while(!stopListener) {
+    //timed: the destructor's wake can fall between the stopListener check and the FUTEX_WAIT, which would then block until the next write
+    int r = waitForRevisionGreaterThan(rev, .1);
+    if(stopListener) break;
+    if(r<=rev) continue;
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    for(auto* c:callbacks) c->call()(this, r);
+    rev = r;
+  }
+}
+
+#else //RAI_Linux
+
+struct Var_shm::Header {};
+struct Var_shm::Slot {};
+Var_shm::Var_shm(const char* _name, const char*, uint, uint, uint) : name(_name) { NIY }
+Var_shm::Var_shm(const char* _name, const char*, uint, double) : name(_name) { NIY }
+Var_shm::~Var_shm() {}
+void Var_shm::unlink(const char* name) { NIY }
+int Var_shm::getRevision() const { NIY }
+int Var_shm::waitForRevisionGreaterThan(int rev, double timeout) const { NIY }
+uint Var_shm::capacity() const { NIY }
+char* Var_shm::beginWrite() { NIY }
+int Var_shm::endWrite(uint nd, const uint* dim, double dataTime) { NIY }
+const char* Var_shm::readSlot(int& revision, uint& nd, uint* dim, double& dataTime) const { NIY }
+bool Var_shm::isValid(int revision) const { NIY }
+void Var_shm::addCallback(const std::function<void(Var_shm*, int)>& call, const void* callbackID) { NIY }
+void Var_shm::listen() {}
+
+#endif //RAI_Linux
+
 //===========================================================================
 //
 // Metronome
@@ -287,28 +534,59 @@ Metronome::Metronome(double ticIntervalSec) {
   reset(ticIntervalSec);
 }
 
+const double Metronome::jitterEdges[Metronome::jitterBins-1] = {1., 2., 5., 10., 20., 50., 100., 200., 500., 1000., 2000., 5000.};
+
 void Metronome::reset(double ticIntervalSec) {
   tics=0;
   ticInterval = ticIntervalSec;
-  ticTime = std::chrono::high_resolution_clock::now();
+  ticTime = std::chrono::steady_clock::now();
+  for(uint& h:jitterHist) h=0;
+  overruns=0;
+  jitterMax=0.;
 }
 
 void Metronome::waitForTic() {
   ticTime += std::chrono::duration<double>(ticInterval);
-  std::chrono::time_point<std::chrono::high_resolution_clock, std::chrono::duration<double>> now = std::chrono::high_resolution_clock::now();
+  timepoint now = std::chrono::steady_clock::now();
+  double late;
   if(ticTime>now){
+#ifdef __linux__ //absolute-time sleep on the monotonic clock (= steady_clock) -- no drift from relative sleeps
+    double t = ticTime.time_since_epoch().count();
+    struct timespec ts;
+    ts.tv_sec = (time_t)t;
+    ts.tv_nsec = (long)((t-ts.tv_sec)*1e9);
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr)==EINTR) {}
+#else
     std::this_thread::sleep_until(ticTime);
+#endif
+    late = std::chrono::duration<double>(std::chrono::steady_clock::now()-ticTime).count();
   }else{
+    late = std::chrono::duration<double>(now-ticTime).count();
+    overruns++;
     ticTime = now;
   }
+  uint b=0;
+  while(b<jitterBins-1 && 1e6*late>jitterEdges[b]) b++;
+  jitterHist[b]++;
+  if(late>jitterMax) jitterMax=late;
   tics++;
 }
 
 double Metronome::getTimeSinceTic() {
-  auto now = std::chrono::high_resolution_clock::now();
+  auto now = std::chrono::steady_clock::now();
   return std::chrono::duration<double>(ticTime-now).count();
 }
 
+rai::String Metronome::reportJitter() const {
+  rai::String s;
+  s <<"tics=" <<tics <<" overruns=" <<overruns <<" jitterMax=" <<1e6*jitterMax <<"us hist[us]:";
+  for(uint b=0; b<jitterBins; b++) {
+    if(b<jitterBins-1) s <<" <" <<jitterEdges[b] <<':' <<jitterHist[b];
+    else s <<" >" <<jitterEdges[b-1] <<':' <<jitterHist[b];
+  }
+  return s;
+}
+
 //===========================================================================
 //
 // CycleTimer
@@ -394,6 +672,7 @@ Thread::~Thread() {
   }
 
 void Thread::threadOpen(bool wait, int priority) {
+  if(priority>0) rtPriority=priority;
   {
     auto lock = event.statusMutex(RAI_HERE);
     if(thread) return; //this is already open -- or has just beend opened (parallel call to threadOpen)
@@ -486,12 +765,54 @@ void Thread::threadStop(bool wait) {
   }
 }
 
+void Thread::setAffinity(const uintA& cpus) {
+  cpuAffinity = cpus;
+  auto lock = event.statusMutex(RAI_HERE);
+  if(thread) applyScheduling(thread->native_handle());
+}
+
+void Thread::setRealtime(int priority, bool roundRobin) {
+  rtPriority = priority;
+  rtRoundRobin = roundRobin;
+  auto lock = event.statusMutex(RAI_HERE);
+  if(thread) applyScheduling(thread->native_handle());
+}
+
+rai::String Thread::timingReport() {
+  rai::String s;
+  s <<name <<": " <<timer.report();
+  if(metronome.ticInterval>1e-10) s <<"\n  " <<metronome.reportJitter();
+  return s;
+}
+
+void Thread::applyScheduling(std::thread::native_handle_type h) {
+  if(!cpuAffinity.N && rtPriority<=0) return;
+#ifdef __linux__
+  if(cpuAffinity.N) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(uint c:cpuAffinity) CPU_SET(c, &set);
+    int r = pthread_setaffinity_np(h, sizeof(set), &set);
+    if(r) LOG(-1) <<"Thread '" <<name <<"': could not set cpu affinity " <<cpuAffinity <<": " <<strerror(r);
+  }
+  if(rtPriority>0) {
+    int policy = rtRoundRobin ? SCHED_RR : SCHED_FIFO;
+    struct sched_param param;
+    param.sched_priority = std::max(sched_get_priority_min(policy), std::min(rtPriority, sched_get_priority_max(policy)));
+    int r = pthread_setschedparam(h, policy, &param);
+    if(r) LOG(-1) <<"Thread '" <<name <<"': could not set real-time scheduling (" <<strerror(r) <<") -- continuing with normal scheduling";
+  }
+#else
+  LOG(-1) <<"Thread '" <<name <<"': cpu affinity and real-time scheduling are only supported on linux";
+#endif
+}
+
 void Thread::main() {
   tid = getpid();
 //  if(verbose>0) cout <<"*** Entering Thread '" <<name <<"'" <<endl;
-  //http://linux.die.net/man/3/setpriority
-  //if(Thread::threadPriority) setRRscheduling(Thread::threadPriority);
-  //if(Thread::threadPriority) setNice(Thread::threadPriority);
+#ifndef RAI_MSVC
+  applyScheduling(pthread_self()); //affinity and SCHED_FIFO/RR, if requested ('thread' may not be assigned yet)
+#endif
 
   {
     auto mux = stepMutex(RAI_HERE);
@@ -15,6 +15,8 @@
 #include <shared_mutex>
 #include <condition_variable>
 #include <thread>
+#include <atomic>
+#include <type_traits>
 
 enum ThreadState { tsIsClosed=-6, tsToOpen=-1, tsLOOPING=-2, tsBEATING=-3, tsIDLE=0, tsToStep=1, tsToClose=-4,  tsFAILURE=-5,  }; //positive states indicate steps-to-go
 struct Signaler;
@@ -222,6 +224,269 @@ struct Var {
 
 template<class T> std::ostream& operator<<(std::ostream& os, Var<T>& x) { x.write(os); return os; }
 
+//===========================================================================
+//
+// lock-free (seqlock) variables for trivially copyable payloads
+//
+
+/** A seqlock-protected variable: readers never take a lock and never block a writer -- they copy the payload
+ *  and retry if a write happened concurrently. Writers are only serialized among each other. The payload is
+ *  kept twice (a "latch"): while one copy is written, readers get the other, i.e. the previous revision. So a
+ *  reader never waits for a writer (no livelock if the writer is preempted, e.g. under SCHED_FIFO) and retries
+ *  only if a writer made progress. The revision counts writes as for Var_base. There are no callbacks/listeners:
+ *  poll hasNewRevision or wait on the revision. */
+template<class T>
+struct Var_seqlock : NonCopyable {
+  static_assert(std::is_trivially_copyable<T>::value, "Var_seqlock requires a trivially copyable payload");
+  struct Slot { T data; double data_time; };
+  static constexpr uint W = (sizeof(Slot)+7)/8;
+
+  std::atomic<uint32_t> seq;         ///< odd while a write is in progress; revision = seq/2; readers use copy seq&1
+  std::atomic<uint64_t> words[2][W]; ///< two copies of the payload, copied word-wise (so concurrent reads are well-defined)
+  std::mutex writeMutex;          ///< serializes writers only -- readers never take it
+  rai::String name;
+
+  Var_seqlock(const char* _name=0) : seq(0), name(_name) { Slot s{}; store(0, s); store(1, s); }
+
+  /// copy out a consistent snapshot; returns its revision
+  int read(T& x, double* dataTime=nullptr) const {
+    Slot s;
+    uint32_t s0 = load(s);
+    memcpy(&x, &s.data, sizeof(T));
+    if(dataTime) *dataTime = s.data_time;
+    return s0/2;
+  }
+  int getRevision() const { return seq.load(std::memory_order_acquire)/2; }
+
+  /// writer side: lock (against other writers only), read the current value, modify, publish
+  void beginWrite(Slot& s) { writeMutex.lock(); load(s); }
+  int endWrite(const Slot& s) {
+    uint32_t s0 = seq.load(std::memory_order_relaxed);
+    seq.store(s0+1, std::memory_order_relaxed); //readers switch to copy 1 (the previous revision)
+    std::atomic_thread_fence(std::memory_order_release);
+    store(0, s);
+    seq.store(s0+2, std::memory_order_release); //readers switch back to copy 0 (the new revision)
+    std::atomic_thread_fence(std::memory_order_release);
+    store(1, s);
+    writeMutex.unlock();
+    seq.notify_all();
+    return (s0+2)/2;
+  }
+
+  /// block (without locks) until revision > rev
+  int waitForRevisionGreaterThan(int rev) const {
+    for(;;) {
+      uint32_t s = seq.load(std::memory_order_acquire);
+      if((int)(s/2)>rev) return s/2;
+      seq.wait(s, std::memory_order_acquire);
+    }
+  }
+
+private:
+  uint32_t load(Slot& s) const {
+    uint64_t buf[W];
+    for(;;) {
+      uint32_t s0 = seq.load(std::memory_order_acquire);
+      const std::atomic<uint64_t>* w = words[s0&1];
+      for(uint i=0; i<W; i++) buf[i] = w[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(seq.load(std::memory_order_relaxed)==s0) { memcpy(&s, buf, sizeof(Slot)); return s0; }
+    }
+  }
+  void store(uint copy, const Slot& s) {
+    uint64_t buf[W];
+    buf[W-1]=0;
+    memcpy(buf, &s, sizeof(Slot));
+    for(uint i=0; i<W; i++) words[copy][i].store(buf[i], std::memory_order_relaxed);
+  }
+};
+
+/// read token of a SeqVar: holds a consistent copy of the payload
+template<class T>
+struct SeqRToken {
+  T data;
+  SeqRToken(const Var_seqlock<T>& var, int* getRevision=nullptr) { int r = var.read(data); if(getRevision) *getRevision=r; }
+  const T* operator->() { return &data; }
+  operator const T& () { return data; }
+  const T& operator()() { return data; }
+};
+
+/// write token of a SeqVar: holds a working copy which is published on destruction
+template<class T>
+struct SeqWToken {
+  Var_seqlock<T>* var;
+  typename Var_seqlock<T>::Slot slot;
+  SeqWToken(Var_seqlock<T>& _var, double dataTime=-1.) : var(&_var) {
+    var->beginWrite(slot);
+    if(dataTime>=0.) slot.data_time=dataTime;
+  }
+  SeqWToken(const SeqWToken&) = delete;
+  ~SeqWToken() { var->endWrite(slot); }
+  void operator=(const T& y) { slot.data=y; }
+  T* operator->() { return &slot.data; }
+  operator T& () { return slot.data; }
+  T& operator()() { return slot.data; }
+};
+
+/** Opt-in lock-free alternative to Var<T> (e.g. for robot state read by high-rate control threads), with the same
+ *  get()/set() token idiom and revision counter. T must be trivially copyable (e.g. fixed-size structs, not arr). */
+template<class T>
+struct SeqVar {
+  shared_ptr<Var_seqlock<T>> data;
+  Thread* thread;             ///< which thread is the owner
+  int last_read_revision=0;   ///< last revision that has been read
+
+  SeqVar(Thread* _thread=nullptr) : data(make_shared<Var_seqlock<T>>()), thread(_thread) {}
+  SeqVar(Thread* _thread, const SeqVar<T>& v) : data(v.data), thread(_thread) {}
+  SeqVar(const SeqVar<T>& v) : SeqVar(nullptr, v) {}
+  SeqVar& operator=(const SeqVar& v){ HALT("you can't copy Var!") }
+
+  SeqRToken<T> get() { return SeqRToken<T>(*data, &last_read_revision); } ///< lock-free read (copy)
+  SeqWToken<T> set() { return SeqWToken<T>(*data); } ///< write access; published when the token is destroyed
+  SeqWToken<T> set(const double& dataTime) { return SeqWToken<T>(*data, dataTime); }
+
+  rai::String& name() const { return data->name; }
+  int getRevision() { return data->getRevision(); }
+  bool hasNewRevision() { return getRevision()>last_read_revision; }
+  void waitForNextRevision(uint multipleRevisions=0) { waitForRevisionGreaterThan(last_read_revision+multipleRevisions); }
+  int waitForRevisionGreaterThan(int rev) { return data->waitForRevisionGreaterThan(rev); }
+};
+
+//===========================================================================
+//
+// inter-process variables (POSIX shared memory) for array streams
+//
+
+/** A named POSIX shared-memory segment holding a ring of `slots` buffers (each up to `capacity` bytes) of a fixed
+ *  element type. Writers (serialized by a spin lock in the segment that holds the owner's pid, so that the lock of a
+ *  crashed owner is recovered) publish into the next slot; readers in any process read lock-free, either by copying
+ *  or as zero-copy views, which stay valid until the writers have wrapped around the ring (check with isValid). The revision is a process-shared futex word: readers and callback
+ *  threads block on it. A segment outlives its processes (a restarted writer continues the revision count) until
+ *  it is unlinked. */
+struct Var_shm : NonCopyable {
+  struct Header;
+  struct Slot;
+
+  rai::String name;
+  Header* head=0;
+  Slot* slotMeta=0;
+  char* slotData=0;
+  size_t size=0;
+  CallbackL<void(Var_shm*, int)> callbacks;
+
+  /// create (or re-attach to) the segment with the given layout; elemType/elemSize guard against type mismatch
+  Var_shm(const char* _name, const char* elemType, uint elemSize, uint capacity, uint slots);
+  /// attach to an existing segment, waiting up to `timeout` seconds for it to be created
+  Var_shm(const char* _name, const char* elemType, uint elemSize, double timeout=1.);
+  ~Var_shm();
+
+  static void unlink(const char* name); ///< remove the segment name (mapped processes keep their mapping)
+
+  int getRevision() const;
+  int waitForRevisionGreaterThan(int rev, double timeout=-1.) const; ///< returns the current revision (<=rev on timeout)
+  uint capacity() const; ///< max bytes per slot
+
+  /// @name writer side
+  char* beginWrite(); ///< locks against other writers, returns the buffer of the next slot
+  int endWrite(uint nd, const uint* dim, double dataTime); ///< publishes the slot, wakes waiting readers
+
+  /// @name reader side
+  const char* readSlot(int& revision, uint& nd, uint* dim, double& dataTime) const; ///< latest published slot (nullptr if none)
+  bool isValid(int revision) const; ///< false once the slot of this revision is being overwritten
+
+  void addCallback(const std::function<void(Var_shm*, int)>& call, const void* callbackID=0); ///< called from a listener thread with each new revision
+
+private:
+  uint wrSlot=0;
+  uint64_t stride=0;
+  std::mutex callbackMutex;
+  std::thread listener;
+  std::atomic<bool> stopListener{false};
+  void map(int fd, bool writable);
+  void listen();
+};
+
+/// zero-copy read token of a ShmVar: data refers into the shared segment; check valid() after use
+template<class T>
+struct ShmRToken {
+  typedef std::remove_pointer_t<decltype(T::p)> E;
+  const Var_shm* var;
+  T data;
+  int revision;
+  double data_time;
+  ShmRToken(const Var_shm& _var, int* getRevision=nullptr) : var(&_var) {
+    uint nd, dim[4];
+    const char* p = var->readSlot(revision, nd, dim, data_time);
+    if(p && nd) {
+      uint n=1;
+      for(uint i=0; i<nd; i++) n*=dim[i];
+      data.referTo((const E*)p, n);
+      data.reshape(nd, dim);
+    }
+    if(getRevision) *getRevision=revision;
+  }
+  bool valid() const { return !revision || var->isValid(revision); } ///< the data was not (yet) overwritten
+  const T* operator->() { return &data; }
+  operator const T& () { return data; }
+  const T& operator()() { return data; }
+};
+
+/// zero-copy write token of a ShmVar: data refers into the next slot and is published on destruction
+template<class T>
+struct ShmWToken {
+  typedef std::remove_pointer_t<decltype(T::p)> E;
+  Var_shm* var;
+  T data;
+  double data_time;
+  ShmWToken(Var_shm& _var, const uintA& dim, double dataTime) : var(&_var), data_time(dataTime) {
+    CHECK_LE(dim.N, 4, "ShmVar arrays have at most 4 dimensions");
+    uint n=1;
+    for(uint d:dim) n*=d;
+    CHECK_LE(n*sizeof(E), var->capacity(), "array exceeds the capacity of shared variable '" <<var->name <<"'");
+    data.referTo((E*)var->beginWrite(), n);
+    if(dim.N) data.reshape(dim); else data.clear();
+  }
+  ShmWToken(const ShmWToken&) = delete;
+  ~ShmWToken() { uintA dim=data.dim(); var->endWrite(dim.N, dim.p, data_time); }
+  T* operator->() { return &data; }
+  operator T& () { return data; }
+  T& operator()() { return data; }
+};
+
+/** Inter-process variable for fixed-layout arrays (e.g. ShmVar<arr> for states, ShmVar<floatA>/ShmVar<byteA> for images),
+ *  with get()/set() tokens and revision counter as Var<T>. One process creates it with a capacity (max number of
+ *  elements), others attach by name. */
+template<class T>
+struct ShmVar {
+  typedef std::remove_pointer_t<decltype(T::p)> E;
+  static_assert(std::is_trivially_copyable<E>::value, "ShmVar requires an array of a trivially copyable element type");
+  shared_ptr<Var_shm> data;
+  int last_read_revision=0;   ///< last revision that has been read
+
+  ShmVar(const char* name, uint capacity, uint slots=4) : data(make_shared<Var_shm>(name, typeid(E).name(), sizeof(E), capacity*sizeof(E), slots)) {} ///< create
+  ShmVar(const char* name) : data(make_shared<Var_shm>(name, typeid(E).name(), sizeof(E))) {} ///< attach (waits up to 1sec for the creator)
+
+  ShmRToken<T> get() { return ShmRToken<T>(*data, &last_read_revision); } ///< zero-copy read of the latest revision
+  int get(T& x, double* dataTime=nullptr) { ///< consistent copy of the latest revision; returns it
+    for(;;) {
+      ShmRToken<T> tok(*data, &last_read_revision);
+      x = tok.data;
+      if(dataTime) *dataTime = tok.data_time;
+      if(tok.valid()) return tok.revision;
+    }
+  }
+  ShmWToken<T> set(std::initializer_list<uint> dim, double dataTime=-1.) { return ShmWToken<T>(*data, uintA(dim), dataTime); } ///< zero-copy write of an array of shape dim
+  ShmWToken<T> setDim(const uintA& dim, double dataTime=-1.) { return ShmWToken<T>(*data, dim, dataTime); } ///< as above
+  int set(const T& x, double dataTime=-1.) { { auto tok=setDim(x.dim(), dataTime); if(x.N) memcpy(tok.data.p, x.p, x.N*sizeof(E)); } return getRevision(); } ///< copy into the next slot
+
+  rai::String& name() const { return data->name; }
+  int getRevision() { return data->getRevision(); }
+  bool hasNewRevision() { return getRevision()>last_read_revision; }
+  void waitForNextRevision(uint multipleRevisions=0) { waitForRevisionGreaterThan(last_read_revision+multipleRevisions); }
+  int waitForRevisionGreaterThan(int rev, double timeout=-1.) { return data->waitForRevisionGreaterThan(rev, timeout); }
+  void addCallback(const std::function<void(Var_shm*, int)>& call, const void* callbackID=0) { data->addCallback(call, callbackID); }
+};
+
 //===========================================================================
 
 /// a basic condition variable
@@ -287,15 +552,24 @@ inline bool wait(const VarL& acts, double timeout=-1.) {
 
 /// a simple struct to realize a strict tic tac timing (called in thread::main once each step if looping)
 struct Metronome {
+  typedef std::chrono::time_point<std::chrono::steady_clock, std::chrono::duration<double>> timepoint;
   double ticInterval;
-  std::chrono::time_point<std::chrono::high_resolution_clock, std::chrono::duration<double>> ticTime;
+  timepoint ticTime;
   uint tics;
 
+  //-- wake-up statistics: lateness of each wake-up relative to its tic
+  static constexpr uint jitterBins=13;
+  static const double jitterEdges[jitterBins-1]; ///< upper bin edges in microseconds: 1,2,5,..,5000 (last bin: above)
+  uint jitterHist[jitterBins];
+  uint overruns;     ///< tics already past when waitForTic was called (the step took longer than the interval)
+  double jitterMax;  ///< max wake-up lateness [sec]
+
   Metronome(double ticIntervalSec); ///< set tic tac time in seconds
 
   void reset(double ticIntervalSec);
-  void waitForTic();              ///< waits until the next tic
+  void waitForTic();              ///< waits (absolute time, monotonic clock) until the next tic
   double getTimeSinceTic();       ///< time since last tic
+  rai::String reportJitter() const;
 };
 
 //===========================================================================
@@ -335,6 +609,9 @@ struct Thread {
   uint step_count;              ///< how often the step was called
   Metronome metronome;          ///< used for beat-looping
   CycleTimer timer;             ///< measure how the time spend per cycle, within step, idle
+  uintA cpuAffinity;            ///< cores this thread is pinned to (empty: no pinning)
+  int rtPriority=0;             ///< >0: real-time priority requested for this thread (SCHED_FIFO, or SCHED_RR)
+  bool rtRoundRobin=false;
 
   /// @name c'tor/d'tor
   /** DON'T open drivers/devices/files or so here in the constructor,
@@ -355,6 +632,10 @@ struct Thread {
   void threadStop(bool wait=false);     ///< stop looping
   void threadCancel();                  ///< a hard kill (pthread_cancel) of the thread
 
+  void setAffinity(const uintA& cpus);  ///< pin to cores (applied on open, or immediately if already open)
+  void setRealtime(int priority, bool roundRobin=false); ///< request SCHED_FIFO/SCHED_RR; falls back to normal scheduling if not permitted
+  rai::String timingReport();           ///< cycle times and the metronome's jitter/overrun histogram
+
   void waitForOpened();                 ///< caller waits until opening is done (working -> idle mode)
   void waitForIdle();                   ///< caller waits until step is done (working -> idle mode)
   bool isIdle();                        ///< check if in idle mode
@@ -376,6 +657,7 @@ struct Thread {
   virtual void close() {}
 
   void main(); //this is the thread main - should be private!
+  void applyScheduling(std::thread::native_handle_type h);
 };
 
 //===========================================================================
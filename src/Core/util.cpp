@@ -19,10 +19,17 @@
 #include <chrono>
 #include <ctime>
 #include <thread>
+#include <atomic>
+#include <algorithm>
+#ifdef __GNUG__
+#  include <cxxabi.h>
+#endif
 #  include <limits.h>
 #  include <sys/resource.h>
 #  include <sys/inotify.h>
 #  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
 #  include <poll.h>
 #  include <execinfo.h>
 #  include <cxxabi.h>    // for __cxa_demangle
@@ -1091,6 +1098,71 @@ rai::String rai::FileToken::fullPath() const {
   return str;
 }
 
+rai::MappedFile::MappedFile(const char* filename) : name(filename) {
+#if defined RAI_Linux || defined RAI_Cygwin || defined RAI_Darwin
+  int fd = ::open(filename, O_RDONLY);
+  if(fd<0) HALT("could not open file '" <<filename <<"' for mapping: " <<strerror(errno));
+  struct stat sb;
+  if(fstat(fd, &sb)) { close(fd); HALT("could not stat file '" <<filename <<"'"); }
+  size = sb.st_size;
+  if(size) {
+    void* m = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0); //copy-on-write: array views into the mapping may be modified
+    if(m==MAP_FAILED) { close(fd); HALT("could not map file '" <<filename <<"': " <<strerror(errno)); }
+    data = (const char*)m;
+  }
+  close(fd); //the mapping stays valid
+#else
+  NIY;
+#endif
+}
+
+rai::MappedFile::~MappedFile() {
+#if defined RAI_Linux || defined RAI_Cygwin || defined RAI_Darwin
+  if(data) munmap((void*)data, size);
+#endif
+}
+
+//===========================================================================
+
+namespace {
+struct BulkBlock {
+  std::atomic<size_t> count{1}; //live objects, +1 while the BulkStorage exists
+  char* next;
+  char* end;
+};
+const size_t bulkHeader = (sizeof(BulkBlock)+15)&~size_t(15);
+}
+
+rai::BulkStorage::BulkStorage(size_t capacity) {
+  char* mem = (char*)::malloc(bulkHeader+capacity);
+  if(!mem) throw std::bad_alloc();
+  BulkBlock* b = new(mem) BulkBlock;
+  b->next = mem+bulkHeader;
+  b->end = b->next+capacity;
+  block = b;
+}
+
+rai::BulkStorage::~BulkStorage() { release(block); }
+
+void* rai::BulkStorage::alloc(size_t size) {
+  BulkBlock* b = (BulkBlock*)block;
+  size = slotSize(size);
+  if(b->next+size>b->end) return nullptr;
+  char* p = b->next;
+  b->next += size;
+  return p;
+}
+
+void* rai::BulkStorage::adopt() {
+  ((BulkBlock*)block)->count++;
+  return block;
+}
+
+void rai::BulkStorage::release(void* block) {
+  BulkBlock* b = (BulkBlock*)block;
+  if(!--b->count) { b->~BulkBlock(); ::free(b); }
+}
+
 //===========================================================================
 //
 // random number generator
@@ -1414,6 +1486,104 @@ const char* niceTypeidName(const std::type_info& type) {
   return buf;
 }
 
+//===========================================================================
+
+extern thread_local int64_t globalMemoryAllocs;
+
+Profiler& profiler() {
+  static Profiler P;
+  return P;
+}
+
+static uint profileThreadId() {
+  static std::atomic<uint> count(0);
+  thread_local uint id = count++;
+  return id;
+}
+
+void Profiler::add(const char* cat, const char* name, double start, double dur, int64_t allocs, int arg, bool event) {
+  if(!cat) cat=""; //e.g. the buffer of an empty rai::String
+  if(!name) name="";
+  std::string key = std::string(cat) + '|' + name;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = entries.find(key);
+  if(it==entries.end()) {
+    it = entries.emplace(key, Entry()).first;
+    Entry& e = it->second;
+    e.cat = cat;
+#ifdef __GNUG__
+    int status=-1;
+    char* dem = abi::__cxa_demangle(name, 0, 0, &status);
+    if(!status && dem) e.name = dem; else e.name = name;
+    free(dem);
+#else
+    e.name = name;
+#endif
+  }
+  Entry& e = it->second;
+  e.count++;
+  e.total += dur;
+  if(dur>e.max) e.max = dur;
+  e.allocs += allocs;
+  if(event && events.size()<maxEvents) events.push_back({&e, start, dur, profileThreadId(), arg});
+}
+
+void Profiler::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  events.clear();
+  entries.clear();
+}
+
+void Profiler::report(std::ostream& os) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::vector<const Entry*> E;
+  for(auto& it:entries) E.push_back(&it.second);
+  std::sort(E.begin(), E.end(), [](const Entry* a, const Entry* b) { return a->total>b->total; });
+  os <<std::setw(16) <<"category" <<std::setw(40) <<"label" <<std::setw(10) <<"count"
+     <<std::setw(12) <<"total" <<std::setw(12) <<"mean" <<std::setw(12) <<"max" <<std::setw(10) <<"allocs" <<endl;
+  for(const Entry* e:E) {
+    os <<std::setw(16) <<e->cat <<std::setw(40) <<e->name <<std::setw(10) <<e->count
+       <<std::setw(12) <<e->total <<std::setw(12) <<e->total/e->count <<std::setw(12) <<e->max <<std::setw(10) <<e->allocs <<endl;
+  }
+}
+
+void Profiler::writeChromeTrace(std::ostream& os) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  os <<"{\"traceEvents\": [";
+  bool first=true;
+  for(const Event& ev:events) {
+    if(!first) os <<',';
+    first=false;
+    os <<"\n{\"name\":\"" <<ev.entry->name <<"\",\"cat\":\"" <<ev.entry->cat <<"\",\"ph\":\"X\""
+       <<",\"ts\":" <<std::fixed <<std::setprecision(3) <<1e6*ev.start <<",\"dur\":" <<1e6*ev.dur <<std::defaultfloat
+       <<",\"pid\":0,\"tid\":" <<ev.tid;
+    if(ev.arg>=0) os <<",\"args\":{\"t\":" <<ev.arg <<'}';
+    os <<'}';
+  }
+  os <<"\n],\n\"displayTimeUnit\": \"ms\"}" <<endl;
+}
+
+void Profiler::writeChromeTrace(const char* filename) const {
+  std::ofstream fil(filename);
+  CHECK(fil.good(), "could not open '" <<filename <<"' for writing");
+  writeChromeTrace(fil);
+}
+
+void ProfileScope::begin() {
+  allocs = globalMemoryAllocs;
+  start = realTime();
+}
+
+void ProfileScope::end() {
+  if(start<0.) return;
+  double dur = realTime()-start;
+  allocs = globalMemoryAllocs-allocs;
+  Profiler& P = profiler();
+  P.add(cat, name, start, dur, allocs, arg);
+  if(cat2) P.add(cat2, name2, start, dur, allocs, -1, false);
+  start=-1.;
+}
+
 }
 
 //===========================================================================
@@ -18,7 +18,10 @@
 #include <memory>
 #include <climits>
 #include <mutex>
+#include <atomic>
 #include <functional>
+#include <map>
+#include <vector>
 
 using std::cout;
 using std::cerr;
@@ -398,6 +401,40 @@ inline bool operator==(const FileToken&, const FileToken&) { return false; }
 }
 #define FILE(filename) (rai::FileToken(filename, false)()) //it needs to return a REFERENCE to a local scope object
 
+namespace rai {
+/// private (copy-on-write) memory mapping of a whole file, e.g. to create zero-copy array views of a binary archive; writes never reach the file
+struct MappedFile : NonCopyable {
+  rai::String name;
+  const char* data=0;
+  size_t size=0;
+  MappedFile(const char* filename);
+  ~MappedFile();
+};
+
+/** Contiguous bulk storage for many small heap objects: make<T>() places an object in the block (or on the general
+ *  heap once the block is full) and records the block in its '_bulk' member. Such classes define a (destroying)
+ *  operator delete that calls release(_bulk) instead of freeing the memory; a block is freed once the BulkStorage
+ *  is destroyed and its last object is released. */
+struct BulkStorage : NonCopyable {
+  BulkStorage(size_t capacity); ///< a block of 'capacity' bytes (see slotSize)
+  ~BulkStorage();
+  static size_t slotSize(size_t size) { return (size+15)&~size_t(15); } ///< bytes needed per object of that size
+  static void release(void* block); ///< an object placed in that block was destroyed
+
+  template<class T, class... Args> T* make(Args&&... args) {
+    void* p = alloc(sizeof(T));
+    if(!p) return new T(std::forward<Args>(args)...);
+    T* x = new(p) T(std::forward<Args>(args)...);
+    x->_bulk = adopt();
+    return x;
+  }
+
+private:
+  void* block;
+  void* alloc(size_t size);
+  void* adopt();
+};}
+
 //===========================================================================
 //
 // random number generator
@@ -535,6 +572,57 @@ struct Singleton {
   Mutex::TypedToken<T> operator()() { return getMutex()(&getSingleton(), RAI_HERE); }
 };
 
+//===========================================================================
+//
+/// lightweight profiling: per-label call counts, cumulative/max times and array allocations
+//
+
+namespace rai {
+
+struct Profiler {
+  struct Entry {
+    std::string cat, name;
+    uint64_t count=0;
+    double total=0., max=0.; ///< wall time in seconds
+    int64_t allocs=0;        ///< number of array (re)allocations within the scope
+  };
+  struct Event {
+    const Entry* entry;
+    double start, dur;
+    uint tid;
+    int arg;
+  };
+
+  std::atomic<bool> enabled={false}; ///< runtime switch -- when off, a ProfileScope costs a single branch
+  uint maxEvents=100000;  ///< cap on recorded trace events (aggregates are always updated)
+  std::map<std::string, Entry> entries;
+  std::vector<Event> events;
+  mutable std::mutex mutex; ///< guards entries and events
+
+  void add(const char* cat, const char* name, double start, double dur, int64_t allocs, int arg=-1, bool event=true);
+  void clear();
+  void report(std::ostream& os) const; ///< table of all entries, sorted by total time
+  void writeChromeTrace(std::ostream& os) const; ///< trace-event JSON, to be loaded in chrome://tracing or perfetto
+  void writeChromeTrace(const char* filename) const;
+};
+
+Profiler& profiler();
+
+/// RAII timer that reports to the global profiler (if enabled); optionally also aggregates into a second label (without trace event)
+struct ProfileScope {
+  const char *cat, *name, *cat2=0, *name2=0;
+  int arg;
+  double start=-1.;
+  int64_t allocs=0;
+  ProfileScope(const char* _cat, const char* _name, int _arg=-1, const char* _cat2=0, const char* _name2=0)
+    : cat(_cat), name(_name), cat2(_cat2), name2(_name2), arg(_arg) { if(profiler().enabled) begin(); }
+  ~ProfileScope() { if(start>=0.) end(); }
+  void begin();
+  void end(); ///< stop early (otherwise called on destruction)
+};
+
+}
+
 //===========================================================================
 //
 // just a hook to make things gl drawable
@@ -0,0 +1,133 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2020 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#include "broadphase.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace rai {
+
+Broadphase::Broadphase(const Array<shared_ptr<Mesh>>& geometries) {
+  objOfId.resize(geometries.N) = -1;
+  for(uint i=0; i<geometries.N; i++) if(geometries(i)) {
+      const arr& V = geometries(i)->V;
+      CHECK(V.N, "collision object " <<i <<" has no vertices");
+      Box b;
+      for(uint k=0; k<3; k++) { b.lo[k]=V(0, k); b.hi[k]=V(0, k); }
+      for(uint j=1; j<V.d0; j++) for(uint k=0; k<3; k++) {
+          double v=V(j, k);
+          if(v<b.lo[k]) b.lo[k]=v;
+          if(v>b.hi[k]) b.hi[k]=v;
+        }
+      objOfId(i) = ids.N;
+      ids.append(i);
+      local.append(b);
+    }
+  world = local;
+  posed.resize(ids.N);
+  order.setStraightPerm(ids.N);
+}
+
+void Broadphase::setPose(uint id, const Transformation& X) {
+  int i = objOfId(id);
+  CHECK_GE(i, 0, "object " <<id <<" has no geometry");
+  const Box& b = local.elem(i);
+  Box& w = world.elem(i);
+  OrientedBox& o = posed.elem(i);
+  double* R = o.R;
+  X.rot.getMatrix(R);
+  const double* t = &X.pos.x;
+  for(uint k=0; k<3; k++) {
+    //center and half extent of the rotated box
+    double c=t[k], h=0.;
+    for(uint j=0; j<3; j++) {
+      double r=R[3*k+j];
+      c += r*.5*(b.lo[j]+b.hi[j]);
+      h += ::fabs(r)*.5*(b.hi[j]-b.lo[j]);
+    }
+    o.c[k]=c;
+    w.lo[k]=c-h;
+    w.hi[k]=c+h;
+  }
+}
+
+/// separating axis test of two posed boxes, each inflated by margin/2 (cf. Gottschalk et al.'s OBBTree)
+static bool overlap(const Broadphase::Box& la, const Broadphase::OrientedBox& A, const Broadphase::Box& lb, const Broadphase::OrientedBox& B, double margin) {
+  double a[3], b[3], R[3][3], AbsR[3][3], t[3], d[3];
+  for(uint k=0; k<3; k++) {
+    a[k] = .5*(la.hi[k]-la.lo[k] + margin);
+    b[k] = .5*(lb.hi[k]-lb.lo[k] + margin);
+    d[k] = B.c[k]-A.c[k];
+  }
+  //B's axes and the center offset in A's coordinates
+  for(uint i=0; i<3; i++) {
+    t[i] = A.R[i]*d[0] + A.R[3+i]*d[1] + A.R[6+i]*d[2];
+    for(uint j=0; j<3; j++) {
+      R[i][j] = A.R[i]*B.R[j] + A.R[3+i]*B.R[3+j] + A.R[6+i]*B.R[6+j];
+      AbsR[i][j] = ::fabs(R[i][j]) + 1e-10; //robust for parallel edges
+    }
+  }
+  for(uint i=0; i<3; i++) if(::fabs(t[i]) > a[i] + b[0]*AbsR[i][0] + b[1]*AbsR[i][1] + b[2]*AbsR[i][2]) return false;
+  for(uint j=0; j<3; j++) if(::fabs(t[0]*R[0][j] + t[1]*R[1][j] + t[2]*R[2][j]) > a[0]*AbsR[0][j] + a[1]*AbsR[1][j] + a[2]*AbsR[2][j] + b[j]) return false;
+  for(uint i=0; i<3; i++) for(uint j=0; j<3; j++) {
+      uint i1=(i+1)%3, i2=(i+2)%3, j1=(j+1)%3, j2=(j+2)%3;
+      double ra = a[i1]*AbsR[i2][j] + a[i2]*AbsR[i1][j];
+      double rb = b[j1]*AbsR[i][j2] + b[j2]*AbsR[i][j1];
+      if(::fabs(t[i2]*R[i1][j] - t[i1]*R[i2][j]) > ra + rb) return false;
+    }
+  return true;
+}
+
+void Broadphase::step(double margin, const std::function<bool(uint, uint)>& filter) {
+  uint n=ids.N;
+  collisions.clear();
+  if(n<2) { collisions.resize(0, 2); return; }
+
+  //-- sweep along the axis with the largest spread of box centers
+  double m[3]= {0., 0., 0.}, s[3]= {0., 0., 0.};
+  for(const Box& b:world) for(uint k=0; k<3; k++) { double c=b.lo[k]+b.hi[k]; m[k]+=c; s[k]+=c*c; }
+  int ax=0;
+  for(uint k=1; k<3; k++) if(s[k]-m[k]*m[k]/n > s[ax]-m[ax]*m[ax]/n) ax=k;
+
+  auto lo = [&](uint i) { return world.elem(i).lo[ax]; };
+  if(ax!=axis) { //full sort when the axis changes
+    axis=ax;
+    std::sort(order.p, order.p+n, [&](uint a, uint b) { return lo(a)<lo(b); });
+  } else { //repair the previous order (near-linear for small motions)
+    for(uint i=1; i<n; i++) {
+      uint x=order.elem(i);
+      double v=lo(x);
+      uint j=i;
+      for(; j>0 && lo(order.elem(j-1))>v; j--) order.elem(j)=order.elem(j-1);
+      order.elem(j)=x;
+    }
+  }
+
+  //-- sweep: pairs overlapping along the axis, then check the other two axes
+  uint a1=(ax+1)%3, a2=(ax+2)%3;
+  for(uint i=0; i<n; i++) {
+    const Box& A = world.elem(order.elem(i));
+    double end = A.hi[ax]+margin;
+    for(uint j=i+1; j<n; j++) {
+      const Box& B = world.elem(order.elem(j));
+      if(B.lo[ax]>end) break;
+      if(B.lo[a1]>A.hi[a1]+margin || A.lo[a1]>B.hi[a1]+margin) continue;
+      if(B.lo[a2]>A.hi[a2]+margin || A.lo[a2]>B.hi[a2]+margin) continue;
+      uint oa=order.elem(i), ob=order.elem(j);
+      if(orientedTest && !overlap(local.elem(oa), posed.elem(oa), local.elem(ob), posed.elem(ob), margin)) continue;
+      uint a=ids.elem(oa), b=ids.elem(ob);
+      if(filter && !filter(a, b)) continue;
+      collisions.append(a);
+      collisions.append(b);
+    }
+  }
+  collisions.reshape(collisions.N/2, 2);
+}
+
+}
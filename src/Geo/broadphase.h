@@ -0,0 +1,45 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2020 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#pragma once
+
+#include "mesh.h"
+
+#include <functional>
+
+namespace rai {
+
+/** Native broadphase (sweep and prune) over posed geometries, without any external library or copying of poses.
+ *  Each object is bounded by its local bounding box, posed as an oriented box, and the world-aligned box around
+ *  that. The objects' order along the sweep axis persists between steps and is repaired by insertion sort, so that
+ *  a step costs near-linear time when objects move little between queries (as in sampling-based planning or
+ *  optimization). Pairs overlapping in the sweep are confirmed by an oriented box test. */
+struct Broadphase {
+  struct Box { double lo[3], hi[3]; };
+  struct OrientedBox { double c[3], R[9]; };
+
+  uintA ids;                ///< external ids (e.g. frame IDs) of all objects
+  Array<Box> local;         ///< bounding box in object coordinates
+  Array<Box> world;         ///< world-aligned bounding box, updated by setPose
+  Array<OrientedBox> posed; ///< center and rotation of the posed local box, updated by setPose
+  bool orientedTest=true;   ///< confirm the candidates of the sweep with an oriented box (separating axis) test
+  uintA collisions;         ///< return values of step: candidate pairs (n x 2, in external ids)
+
+  /// geometries(i)!=nullptr defines an object with external id i
+  Broadphase(const Array<shared_ptr<Mesh>>& geometries);
+
+  void setPose(uint id, const Transformation& X); ///< (re)compute the world box of the object with external id
+  void step(double margin=0., const std::function<bool(uint, uint)>& filter={}); ///< all pairs whose boxes overlap up to margin (and pass the filter)
+
+private:
+  intA objOfId;           ///< external id -> object index (-1 if none)
+  uintA order;            ///< objects sorted by lo along the sweep axis
+  int axis=-1;
+};
+
+}
@@ -9,6 +9,8 @@
 #include "depth2PointCloud.h"
 
 #include <math.h>
+#include <thread>
+#include <functional>
 
 Depth2PointCloud::Depth2PointCloud(Var<floatA>& _depth, float _fx, float _fy, float _px, float _py)
   : Thread("Depth2PointCloud"),
@@ -29,7 +31,8 @@ Depth2PointCloud::~Depth2PointCloud() {
 void Depth2PointCloud::step() {
   _depth = depth.get();
 
-  depthData2pointCloud(_points, _depth, fx, fy, px, py);
+  if(compact) depthData2pointCloud(_points, _depth, arr{fx, fy, px, py}, opt, &pixel2point);
+  else depthData2pointCloud(_points, _depth, fx, fy, px, py);
 
   rai::Transformation _pose = pose.get(); //this is relative to "/base_link"
   if(!_pose.isZero()) _pose.applyOnPointArray(_points);
@@ -46,27 +49,23 @@ void depthData2pointCloud(arr& pts, const floatA& depth, float fx, float fy, flo
   if(std::isnan(py)) py=.5*H;
 
   pts.resize(H*W, 3);
-  pts.setZero();
-  double* pt=pts.p;
-  float* de=depth.p;
-
-  for(uint i=0; i<H; i++) for(uint j=0; j<W; j++) {
-      float d = *(de++);
-      if(d>=0.) {
-        float x=j, y=i;
-#if 0 //slow
-        pts(k, 0) =  d * (x - px) / fx;
-        pts(k, 1) = -d * (y - py) / fy;
-        pts(k, 2) = -d;
-#else //fast
-        *(pt++) =  d * (x - px) / fx;
-        *(pt++) =  d * (y - py) / fy;
-        *(pt++) =  d;
-#endif
-      } else {
-        pt += 3;
-      }
+
+  //per-column factors, so that the row loop is branch-free (invalid depth -> zero point) and vectorizes
+  floatA xs(W);
+  for(uint j=0; j<W; j++) xs.p[j] = (float(j) - px) / fx;
+
+  for(uint i=0; i<H; i++) {
+    const float* __restrict de = depth.p + i*W;
+    const float* __restrict x = xs.p;
+    double* __restrict pt = pts.p + 3*i*W;
+    float ys = (float(i) - py) / fy;
+    for(uint j=0; j<W; j++) {
+      float d = de[j]>=0.f ? de[j] : 0.f;
+      pt[3*j+0] = d * x[j];
+      pt[3*j+1] = d * ys;
+      pt[3*j+2] = d;
     }
+  }
 
   pts.reshape(H, W, 3);
 
@@ -76,6 +75,126 @@ void depthData2pointCloud(arr& pts, const floatA& depth, const arr& FxyCxy) {
   depthData2pointCloud(pts, depth, FxyCxy.elem(0), FxyCxy.elem(1), FxyCxy.elem(2), FxyCxy.elem(3));
 }
 
+template<class T> uint depthData2pointCloud_compact(rai::Array<T>& pts, const floatA& depth, const arr& FxyCxy, const DepthConversionOptions& opt, intA* pixel2point) {
+  CHECK_EQ(depth.nd, 2, "");
+  CHECK_EQ(FxyCxy.N, 4, "need 4 intrinsic parameters");
+  uint H=depth.d0, W=depth.d1;
+  float fx=FxyCxy(0), fy=FxyCxy(1), px=FxyCxy(2), py=FxyCxy(3);
+  CHECK(fx>0, "need a focal length greater zero!(not implemented for ortho yet)");
+  if(std::isnan(fy)) fy = fx;
+  if(std::isnan(px)) px=.5*W;
+  if(std::isnan(py)) py=.5*H;
+  uint stride = opt.stride ? opt.stride : 1;
+  float dmin = opt.minDepth, dmax = opt.maxDepth>0. ? opt.maxDepth : INFINITY;
+
+  floatA xs(W);
+  for(uint j=0; j<W; j++) xs.p[j] = (float(j) - px) / fx;
+  int* pix=0;
+  if(pixel2point) { pixel2point->resize(H, W); *pixel2point = -1; pix=pixel2point->p; }
+
+  //-- row bands (aligned to the stride)
+  uint rows = (H+stride-1)/stride;
+  uint nb = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+  nb = std::max(1u, std::min(nb, rows/16));
+  uintA count(nb+1);
+  auto rowsOf = [&](uint b, uint& i0, uint& i1) { i0 = stride*(b*rows/nb);  i1 = std::min(H, stride*((b+1)*rows/nb)); };
+  auto run = [&](const std::function<void(uint)>& f) {
+    std::vector<std::thread> pool;
+    for(uint b=1; b<nb; b++) pool.emplace_back(f, b);
+    f(0);
+    for(std::thread& th:pool) th.join();
+  };
+
+  //-- pass 1: count valid points per band
+  count.setZero();
+  run([&](uint b) {
+    uint i0, i1, c=0;
+    rowsOf(b, i0, i1);
+    for(uint i=i0; i<i1; i+=stride) {
+      const float* de = depth.p + i*W;
+      for(uint j=0; j<W; j+=stride) c += (de[j]>dmin && de[j]<=dmax);
+    }
+    count(b+1) = c;
+  });
+  for(uint b=0; b<nb; b++) count(b+1) += count(b);
+
+  //-- pass 2: write points at the band offsets (branch-free compaction)
+  uint n = count(nb);
+  pts.resize(n+nb, 3); //+nb: a scratch row per band for the branch-free writes of invalid pixels after its last point
+  run([&](uint b) {
+    uint i0, i1, k=count(b), kEnd=count(b+1);
+    rowsOf(b, i0, i1);
+    for(uint i=i0; i<i1; i+=stride) {
+      const float* de = depth.p + i*W;
+      float ys = (float(i) - py) / fy;
+      for(uint j=0; j<W; j+=stride) {
+        float d = de[j];
+        bool ok = (d>dmin && d<=dmax);
+        T* p = pts.p + 3*(k<kEnd ? k : n+b);
+        p[0] = d * xs.p[j];
+        p[1] = d * ys;
+        p[2] = d;
+        if(pix && ok) pix[i*W+j] = k;
+        k += ok;
+      }
+    }
+  });
+
+  //-- voxel-grid downsampling: keep the first point per voxel (in-place, in pixel order)
+  if(opt.voxelSize>0.) {
+    //open-addressing hash table (key+1, 0: empty), buffers reused across calls
+    static thread_local std::vector<uint64_t> keys;
+    static thread_local std::vector<uint> vals, remap;
+    uint bits=12; //grown to keep the load below 1/2 -- the table stays small (cache) when voxels are few
+    keys.assign(1u<<bits, 0);
+    vals.resize(1u<<bits);
+    auto find = [&](uint64_t key) {
+      uint h = (key*0x9E3779B97F4A7C15ull) >> (64-bits);
+      while(keys[h] && keys[h]!=key) h = (h+1) & ((1u<<bits)-1);
+      return h;
+    };
+    if(pix) remap.resize(n);
+    double s = 1./opt.voxelSize;
+    auto cell = [s](T x) { x*=s; int64_t i=(int64_t)x; i -= (x<i); return (uint64_t)i & 0x1fffff; }; //floor without a libm call
+    uint m=0;
+    for(uint k=0; k<n; k++) {
+      T* p = pts.p + 3*k;
+      uint64_t key = 1 + (cell(p[0])<<42 | cell(p[1])<<21 | cell(p[2]));
+      uint h = find(key);
+      if(!keys[h]) {
+        keys[h] = key;
+        vals[h] = m;
+        if(m!=k) { T* q = pts.p + 3*m; q[0]=p[0]; q[1]=p[1]; q[2]=p[2]; }
+        m++;
+        if(2*m > (1u<<bits)) { //rehash
+          std::vector<uint64_t> oldKeys(keys);
+          std::vector<uint> oldVals(vals);
+          bits++;
+          keys.assign(1u<<bits, 0);
+          vals.resize(1u<<bits);
+          for(uint i=0; i<oldKeys.size(); i++) if(oldKeys[i]) { uint g=find(oldKeys[i]); keys[g]=oldKeys[i]; vals[g]=oldVals[i]; }
+          h = find(key);
+        }
+      }
+      if(pix) remap[k] = vals[h];
+    }
+    if(pix) for(uint i=0; i<H*W; i++) if(pix[i]>=0) pix[i] = remap[pix[i]];
+    n = m;
+  }
+
+  pts.resizeMEM(3*n, true, pts.M); //keep the memory for the next frame
+  pts.reshape(n, 3);
+  return n;
+}
+
+uint depthData2pointCloud(arr& pts, const floatA& depth, const arr& FxyCxy, const DepthConversionOptions& opt, intA* pixel2point) {
+  return depthData2pointCloud_compact<double>(pts, depth, FxyCxy, opt, pixel2point);
+}
+
+uint depthData2pointCloud(floatA& pts, const floatA& depth, const arr& FxyCxy, const DepthConversionOptions& opt, intA* pixel2point) {
+  return depthData2pointCloud_compact<float>(pts, depth, FxyCxy, opt, pixel2point);
+}
+
 void depthData2point(double* pt, double* FxyCxy) {
   pt[0] = pt[2] * (pt[0] - FxyCxy[2]) / FxyCxy[0];
   pt[1] = pt[2] * (pt[1] - FxyCxy[3]) / FxyCxy[1];
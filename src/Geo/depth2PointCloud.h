@@ -13,6 +13,15 @@
 
 #include <math.h>
 
+/// filtering and downsampling for the compact depth-to-point-cloud conversion
+struct DepthConversionOptions {
+  RAI_PARAM("depth2pc/", uint, stride, 1)          ///< only every stride-th row and column
+  RAI_PARAM("depth2pc/", double, voxelSize, -1.)   ///< if >0: voxel-grid downsampling (first point per voxel, in pixel order)
+  RAI_PARAM("depth2pc/", double, minDepth, 0.)     ///< points with depth<=minDepth are dropped (also NaN)
+  RAI_PARAM("depth2pc/", double, maxDepth, -1.)    ///< if >0: points with depth>maxDepth are dropped
+  RAI_PARAM("depth2pc/", uint, threads, 0)         ///< row bands converted in parallel; 0: hardware concurrency
+};
+
 struct Depth2PointCloud : Thread {
   //inputs
   Var<floatA> depth;
@@ -24,6 +33,10 @@ struct Depth2PointCloud : Thread {
   floatA _depth;
   arr _points;
 
+  bool compact=false; ///< output only valid (filtered, downsampled) points (n,3) instead of the (H,W,3) image
+  DepthConversionOptions opt;
+  intA pixel2point;   ///< (compact only) index of each pixel's point, -1 if dropped
+
   Depth2PointCloud(Var<floatA>& _depth, float _fx=NAN, float _fy=NAN, float _px=NAN, float _py=NAN);
   Depth2PointCloud(Var<floatA>& _depth, const arr& FxyCxy);
   virtual ~Depth2PointCloud();
@@ -37,4 +50,10 @@ void depthData2point(double* pt, double* FxyCxy);
 void depthData2point(arr& pt, const arr& FxyCxy);
 void depthData2pointCloud(arr& pts, const floatA& depth, float fx, float fy, float px, float py);
 void depthData2pointCloud(arr& pts, const floatA& depth, const arr& FxyCxy);
+
+/** compact conversion: only valid points, filtered and downsampled in the same pass; returns #points. pts is reused
+ *  (no allocation when its memory suffices). pixel2point (optional, (H,W)) gets each pixel's point index (with voxel
+ *  downsampling: its voxel's point), -1 if dropped. */
+uint depthData2pointCloud(arr& pts, const floatA& depth, const arr& FxyCxy, const DepthConversionOptions& opt, intA* pixel2point=nullptr);
+uint depthData2pointCloud(floatA& pts, const floatA& depth, const arr& FxyCxy, const DepthConversionOptions& opt, intA* pixel2point=nullptr);
 void point2depthData(double* pt, double* FxyCxy);
@@ -976,6 +976,11 @@ void Quaternion::applyOnPointArray(arr& pts) const {
 /// this is a 3-by-4 matrix $J$, giving the angular velocity vector $w = J \dot q$  induced by a $\dot q$
 arr Quaternion::getJacobian() const {
   arr J(3, 4);
+  getJacobian(J.p);
+  return J;
+}
+
+void Quaternion::getJacobian(double* J) const {
   rai::Quaternion e;
   for(uint i=0; i<4; i++) {
     if(i==0) e.set(1., 0., 0., 0.);
@@ -983,11 +988,10 @@ arr Quaternion::getJacobian() const {
     if(i==2) e.set(0., 0., 1., 0.);
     if(i==3) e.set(0., 0., 0., 1.); //TODO: the following could be simplified/compressed/made more efficient
     e = e / *this;
-    J(0, i) = -2.*e.x;
-    J(1, i) = -2.*e.y;
-    J(2, i) = -2.*e.z;
+    J[0*4+i] = -2.*e.x;
+    J[1*4+i] = -2.*e.y;
+    J[2*4+i] = -2.*e.z;
   }
-  return J;
 }
 
 /// this is a 4x(3x3) matrix, such that ~(J*x) is the jacobian of (R*x), and ~qdelta*J is (del R/del q)(qdelta)
@@ -79,6 +79,7 @@ struct Matrix {
   double* p() { return &m00; }
   arr getArr() const { return arr(&m00, 9, true).reshape(3,3); }
   arr getDiag() const { return arr{m00,m11,m22}; }
+  void mult(double* C, const double* B, uint n) const { fixed_MM<3, 3>(C, &m00, B, n); } ///< C(3,n) = this * B(3,n), fixed-size kernel
 
   void set(double* m);
   void setZero();
@@ -175,6 +176,7 @@ struct Quaternion {
   void applyOnPointArray(arr& pts) const;
 
   arr getJacobian() const;
+  void getJacobian(double* J) const; ///< same as above, written into a 3x4 row-major buffer
   arr getMatrixJacobian() const;
 
   arr getQuaternionMultiplicationMatrix() const; //turns a RHS(!) quat multiplication into a LHS(!) matrix multiplication
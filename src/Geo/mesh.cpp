@@ -1194,7 +1194,7 @@ uintA Mesh::getVertexDegrees() const {
   return deg;
 }
 
-ANN& Mesh::ensure_ann(){
+ANN& Mesh::ensure_ann() const {
   if(!ann) ann = make_shared<ANN>();
   if(ann->X.d0 != V.d0) ann->setX(V);
   return *ann;
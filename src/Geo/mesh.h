@@ -39,7 +39,7 @@ struct Mesh : GLDrawer {
 
   uintA cvxParts;
   uintAA graph;         ///< for every vertex, the set of neighboring vertices
-  shared_ptr<ANN> ann;
+  mutable shared_ptr<ANN> ann; ///< lazily built nearest neighbor index
 
   rai::Transformation glX; ///< transform (only used for drawing! Otherwise use applyOnPoints)  (optional)
 
@@ -120,7 +120,7 @@ struct Mesh : GLDrawer {
   double getVolume() const;
   uintA getVertexDegrees() const;
 
-  ANN& ensure_ann();
+  ANN& ensure_ann() const;
 
   /// Comparing two Meshes - static function
   static double meshMetric(const Mesh& trueMesh, const Mesh& estimatedMesh); // Haussdorf metric
@@ -32,7 +32,7 @@ extern "C" {
 
 namespace rai {
 
-PairCollision::PairCollision(rai::Mesh& _mesh1, rai::Mesh& _mesh2, const rai::Transformation& _t1, const rai::Transformation& _t2, double rad1, double rad2)
+PairCollision::PairCollision(const rai::Mesh& _mesh1, const rai::Mesh& _mesh2, const rai::Transformation& _t1, const rai::Transformation& _t2, double rad1, double rad2)
   : t1(&_t1), t2(&_t2), rad1(rad1), rad2(rad2) {
 
   mesh1.V.referTo(_mesh1.V); mesh1.T.referTo(_mesh1.T);
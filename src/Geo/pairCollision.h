@@ -39,7 +39,7 @@ struct PairCollision : GLDrawer, NonCopyable {
   arr poly, polyNorm;
 
   //mesh-to-mesh
-  PairCollision(rai::Mesh& mesh1, rai::Mesh& mesh2,
+  PairCollision(const rai::Mesh& mesh1, const rai::Mesh& mesh2,
                 const rai::Transformation& t1, const rai::Transformation& t2,
                 double rad1=0., double rad2=0.);
   //sdf-to-sdf
@@ -200,6 +200,7 @@ void KOMO::removeObjective(const Objective* ob){
     for(uint i=objs.N;i--;) if(objs(i).get()==o) objs.remove(i);
   }
   for(uint i=objectives.N;i--;) if(objectives(i).get()==ob) objectives.remove(i);
+  nlp_warm.reset(); //structure changed
 }
 
 void KOMO::copyObjectives(KOMO& komoB, bool deepCopyFeatures){
@@ -215,6 +216,7 @@ void KOMO::copyObjectives(KOMO& komoB, bool deepCopyFeatures){
 
 void KOMO::_addObjective(const std::shared_ptr<Objective>& ob, const intA& timeSlices){
   objectives.append(ob);
+  nlp_warm.reset(); //structure changed
 
   CHECK_EQ(timeSlices.nd, 2, "");
   CHECK_EQ(timeSlices.d1, ob->feat->order+1, "");
@@ -223,18 +225,22 @@ void KOMO::_addObjective(const std::shared_ptr<Objective>& ob, const intA& timeS
     objs.append(o);
     ob->groundings.append(o.get());
     o->objId = objectives.N-1;
-    o->frames.resize(timeSlices.d1, o->feat->frameIDs.N);
-    for(uint i=0;i<timeSlices.d1;i++){
-      int s = timeSlices(c,i) + k_order;
-      for(uint j=0;j<o->feat->frameIDs.N;j++){
-        uint fID = o->feat->frameIDs.elem(j);
-        o->frames(i,j) = this->timeSlices(s, fID);
-      }
-    }
-    if(o->feat->frameIDs.nd==2){
-      o->frames.reshape(timeSlices.d1, o->feat->frameIDs.d0, o->feat->frameIDs.d1);
+    _groundFrames(*o);
+  }
+}
+
+void KOMO::_groundFrames(GroundedObjective& o){
+  o.frames.resize(o.timeSlices.N, o.feat->frameIDs.N);
+  for(uint i=0;i<o.timeSlices.N;i++){
+    int s = o.timeSlices(i) + k_order;
+    for(uint j=0;j<o.feat->frameIDs.N;j++){
+      uint fID = o.feat->frameIDs.elem(j);
+      o.frames(i,j) = this->timeSlices(s, fID);
     }
   }
+  if(o.feat->frameIDs.nd==2){
+    o.frames.reshape(o.timeSlices.N, o.feat->frameIDs.d0, o.feat->frameIDs.d1);
+  }
 }
 
 shared_ptr<Objective> KOMO::addObjective(const arr& times,
@@ -909,6 +915,7 @@ arr KOMO::getPath_energies() {
 }
 
 arr KOMO::getActiveConstraintJacobian() {
+  CHECK_EQ(featureJacobians.N, 1, "no full Jacobian stored (the last evaluation was lazy or had no Jacobian)");
   uint n=0;
   for(uint i=0; i<dual.N; i++) if(dual.elem(i)>0.) n++;
 
@@ -1188,6 +1195,8 @@ void KOMO::updateAndShiftPrefix(const Configuration& C){
 
 void KOMO::reset() {
   dual.clear();
+  nlp_warm.reset();
+  mu_warm=-1.;
   featureValues.clear();
   featureJacobians.clear();
   featureTypes.clear();
@@ -1234,6 +1243,9 @@ void KOMO::run(OptOptions options) {
   }
 
   options.verbose = rai::MAX(opt.verbose-2, 0);
+  //-- profile this run (entries then hold this run only), unless the caller already profiles globally
+  bool profilerWasEnabled = rai::profiler().enabled;
+  if(opt.profile && !profilerWasEnabled) { rai::profiler().clear(); rai::profiler().enabled = true; }
   timeTotal -= rai::cpuTime();
   CHECK(T, "");
   if(logFile)(*logFile) <<"KOMO_run_log: [" <<endl;
@@ -1285,6 +1297,8 @@ void KOMO::run(OptOptions options) {
   } else NIY;
 
   timeTotal += rai::cpuTime();
+  if(opt.profile && opt.profileTrace.N) rai::profiler().writeChromeTrace(opt.profileTrace);
+  rai::profiler().enabled = profilerWasEnabled;
 
   if(logFile)(*logFile) <<"\n] #end of KOMO_run_log" <<endl;
   if(opt.verbose>0) {
@@ -1296,6 +1310,81 @@ void KOMO::run(OptOptions options) {
   if(opt.verbose>1) cout <<getReport(opt.verbose>2) <<endl;
 }
 
+void KOMO::run_warmStart(OptOptions options, int maxNewtonSteps) {
+  CHECK(solver==rai::KS_dense || solver==rai::KS_sparse, "warm start only for the dense or sparse solver");
+  Configuration::setJointStateCount=0;
+
+  //-- reuse the transcription (dimension, bounds, feature types), unless the problem changed structurally
+  auto P = std::dynamic_pointer_cast<Conv_KOMO_NLP>(nlp_warm);
+  bool changed = (!P || P->getDimension()!=x.N || P->objDims.N!=objs.N);
+  for(uint i=0, M=0; !changed && i<objs.N; i++) {
+    GroundedObjective& ob = *objs(i);
+    if(P->objDims(i)!=ob.feat->dim(ob.frames)) changed=true;
+    else if(P->objDims(i) && P->featureTypes(M)!=ob.type) changed=true;
+    M += P->objDims(i);
+  }
+  if(changed) {
+    nlp_warm = make_shared<Conv_KOMO_NLP>(*this, solver==rai::KS_sparse);
+    dual.clear();
+    mu_warm=-1.;
+  }
+  if(dual.N!=nlp_warm->featureTypes.N) dual.clear();
+
+  //-- continue with the previous penalty, cap the Newton steps
+  if(mu_warm>0.) options.muInit = mu_warm;
+  if(maxNewtonSteps>0) options.stopIters = maxNewtonSteps;
+
+  options.verbose = rai::MAX(opt.verbose-2, 0);
+  timeTotal -= rai::cpuTime();
+  OptConstrained _opt(x, dual, nlp_warm, options, logFile);
+  _opt.run();
+  mu_warm = _opt.L.mu;
+  timeNewton += _opt.newton.timeNewton;
+  timeTotal += rai::cpuTime();
+
+  if(opt.verbose>0) {
+    cout <<"** warm start optimization time:" <<timeTotal <<" newton steps:" <<_opt.newton.its
+         <<" setJointStateCount:" <<Configuration::setJointStateCount
+        <<"\n   sos:" <<sos <<" ineq:" <<ineq <<" eq:" <<eq <<endl;
+  }
+}
+
+void KOMO::shift_warmStart(int steps) {
+  if(steps<=0) return;
+
+  //-- primal: slice t takes the configuration of t+steps; the last ones are kept constant
+  for(int t=0; t<(int)T; t++) {
+    arr q = getConfiguration_qAll(rai::MIN(t+steps, (int)T-1));
+    if(q.N==getConfiguration_qAll(t).N) setConfiguration_qAll(t, q);
+  }
+  x = pathConfig.getJointState();
+
+  //-- dual: each grounded objective takes the multipliers of the same objective grounded 'steps' slices later
+  if(!dual.N || !nlp_warm) return;
+  auto P = std::dynamic_pointer_cast<Conv_KOMO_NLP>(nlp_warm);
+  CHECK_EQ(P->objDims.N, objs.N, "objectives changed since the last warm start");
+  CHECK_EQ(dual.N, sum(P->objDims), "");
+
+  uintA offset(objs.N);
+  std::map<std::pair<int, int>, uint> groundings; //(objId, last time slice) -> index in objs
+  uint M=0;
+  for(uint i=0; i<objs.N; i++) {
+    offset(i) = M;
+    M += P->objDims(i);
+    groundings[{objs(i)->objId, objs(i)->timeSlices.last()}] = i;
+  }
+
+  arr shifted = zeros(dual.N);
+  for(uint i=0; i<objs.N; i++) {
+    auto it = groundings.find({objs(i)->objId, objs(i)->timeSlices.last()+steps});
+    if(it==groundings.end()) continue; //no later grounding: start with zero multipliers
+    uint j = it->second;
+    if(P->objDims(j)!=P->objDims(i)) continue;
+    for(uint k=0; k<P->objDims(i); k++) shifted.elem(offset(i)+k) = dual.elem(offset(j)+k);
+  }
+  dual = shifted;
+}
+
 Graph KOMO::report(bool specs, bool plotOverTime){
   Graph G;
   if(specs){
@@ -1619,6 +1708,7 @@ rai::Frame* KOMO::addStableFrame(JointType jointType, const char* parent, const
     pathConfig.frames = timeSlices;
     uint i=0;
     for(Frame* f: pathConfig.frames) f->ID = i++;
+    pathConfig.reset_frameIndex();
   }
   return f0;
 }
@@ -1716,16 +1806,8 @@ void KOMO::setupPathConfig() {
     fcl = C.fcl();
   }
 
-  for(uint s=0;s<k_order+T;s++) {
-//    for(KinematicSwitch* sw:switches) { //apply potential switches
-//      if(sw.timeOfApplication+(int)k_order==(int)s)  sw.apply(C.frames);
-//    }
-
-//    uint nBefore = pathConfig.frames.N;
-    pathConfig.addCopies(C.frames, C.otherDofs);
-//    timeSlices[s] = pathConfig.frames({nBefore, -1});
-
-  }
+  //replicate the slice template k_order+T times in one go
+  pathConfig.addCopies(C.frames, C.otherDofs, k_order+T);
   timeSlices = pathConfig.frames;
 
   //deactivate prefix dofs
@@ -1775,6 +1857,7 @@ void KOMO::set_x(const arr& x, const uintA& selectedConfigurationsOnly) {
   CHECK_EQ(timeSlices.d0, k_order+T, "configurations are not setup yet");
 
   timeKinematics -= rai::cpuTime();
+  rai::ProfileScope profKin("KOMO", "kinematics");
 
   if(!selectedConfigurationsOnly.N){
     pathConfig.setJointState(x);
@@ -1784,9 +1867,11 @@ void KOMO::set_x(const arr& x, const uintA& selectedConfigurationsOnly) {
   }
 
   timeKinematics += rai::cpuTime();
+  profKin.end();
 
   if(computeCollisions) {
     timeCollisions -= rai::cpuTime();
+    rai::ProfileScope prof("KOMO", "collisions");
     pathConfig.proxies.clear();
     arr X;
     uintA collisionPairs;
@@ -1906,6 +1991,23 @@ rai::Graph KOMO::getReport(bool plotOverTime, int reportFeatures, std::ostream&
   report.add<double>("eq", totalH);
   report.add<double>("f", totalF);
 
+  //-- profiling entries (if the profiler was enabled)
+  {
+    rai::Profiler& P = rai::profiler();
+    std::lock_guard<std::mutex> lock(P.mutex);
+    if(P.entries.size()) {
+      Graph& prof = report.addSubgraph("profile");
+      for(auto& it:P.entries) {
+        const rai::Profiler::Entry& e = it.second;
+        Graph& g = prof.addSubgraph(STRING(e.cat <<':' <<e.name));
+        g.add<double>("count", e.count);
+        g.add<double>("total", e.total);
+        g.add<double>("max", e.max);
+        g.add<double>("allocs", e.allocs);
+      }
+    }
+  }
+
   if(plotOverTime) {
     //-- write a nice gnuplot file
     ofstream fil("z.costReport");
@@ -34,6 +34,8 @@ namespace rai {
     RAI_PARAM("KOMO/", bool, useFCL, true)
     RAI_PARAM("KOMO/", bool, unscaleEqIneqReport, false)
     RAI_PARAM("KOMO/", double, sampleRate_stable, .0)
+    RAI_PARAM("KOMO/", bool, profile, false)
+    RAI_PARAM("KOMO/", rai::String, profileTrace, "")
   };
 }//namespace
 
@@ -60,6 +62,8 @@ struct KOMO : NonCopyable {
   //-- optimizer
   rai::KOMOsolver solver=rai::KS_sparse;
   arr x, dual;                    ///< the primal and dual solution
+  shared_ptr<NLP> nlp_warm;       ///< NLP transcription kept across run_warmStart calls (dropped by reset())
+  double mu_warm=-1.;             ///< penalty parameter reached by the last run_warmStart
 
   //-- options
   rai::KOMO_Options opt;
@@ -174,6 +178,8 @@ public:
   //advanced
   void run_prepare(double addInitializationNoise);   ///< ensure the configurations are setup, decision variable is initialized, and noise added (if >0)
   void run(rai::OptOptions options=NOOPT);          ///< run the solver iterations (configurations and decision variable needs to be setup before)
+  void run_warmStart(rai::OptOptions options=NOOPT, int maxNewtonSteps=-1); ///< same as run(), but reusing the NLP structure, duals and penalty of the previous call; optionally capping Newton steps (real-time iteration)
+  void shift_warmStart(int steps=1);                 ///< time-shift the primal path and the duals by 'steps' slices (receding horizon)
   void setSpline(uint splineT);      ///< optimize B-spline nodes instead of the path; splineT specifies the time steps per node
 
   //-- reading results
@@ -287,5 +293,6 @@ public:
 
 //private:
   void _addObjective(const std::shared_ptr<Objective>& ob, const intA& timeSlices);
+  void _groundFrames(struct GroundedObjective& o); ///< (re)set o.frames from o.timeSlices; keeps the NLP structure (and warm start)
 };
 
@@ -50,14 +50,36 @@ void Conv_KOMO_NLP::evaluate(arr& phi, arr& J, const arr& x) {
 
   komo.timeFeatures -= cpuTime();
 
+  bool useLazy = (!!J && lazyFeatures.N==phi.N && objDims.N==komo.objs.N);
+
   uint M=0;
-  for(shared_ptr<GroundedObjective>& ob : komo.objs) {
+  bool anyLazy=false;
+  for(uint o=0; o<komo.objs.N; o++) {
+      shared_ptr<GroundedObjective>& ob = komo.objs(o);
+
+      //skip the Jacobian if the solver declared all rows of this inequality lazy
+      bool lazy = false;
+      if(useLazy && ob->type==OT_ineq && objDims(o)){
+        lazy = true;
+        for(uint i=0; i<objDims(o); i++) if(!lazyFeatures(M+i)) { lazy=false; break; }
+      }
+
       //query the task map and check dimensionalities of returns
-      arr y = ob->feat->eval(ob->frames);
+      Configuration::JacobianMode jacMode = komo.pathConfig.jacMode;
+      if(lazy) { komo.pathConfig.jacMode = Configuration::JM_noArr; anyLazy=true; }
+      arr y;
+      {
+        bool profiling = rai::profiler().enabled; //look up the labels only when they are recorded
+        ProfileScope prof("objective", (!profiling ? 0 : ob->objId>=0 ? komo.objectives(ob->objId)->name.p : "?"), ob->timeSlices.last(),
+                          "feature", (profiling ? typeid(*ob->feat).name() : 0));
+        y = ob->feat->eval(ob->frames);
+      }
+      komo.pathConfig.jacMode = jacMode;
 //      cout <<"EVAL '" <<ob->name() <<"' phi:" <<y <<endl <<y.J() <<endl<<endl;
       if(!y.N) continue;
       checkNan(y);
-      if(!!J){
+      if(lazy) CHECK_EQ(y.N, objDims(o), "lazy objective changed its dimension");
+      if(!!J && !lazy){
         CHECK(y.jac, "Jacobian needed but missing");
         CHECK_EQ(y.J().nd, 2, "");
         CHECK_EQ(y.J().d0, y.N, "");
@@ -72,7 +94,8 @@ void Conv_KOMO_NLP::evaluate(arr& phi, arr& J, const arr& x) {
       if(absMax(y)>1e10) RAI_MSG("WARNING y=" <<y);
 
       //write into phi and J
-      arr yJ = y.J_reset();
+      arr yJ;
+      if(!lazy) yJ = y.J_reset(); else y.jac.reset();
       phi.setVectorBlock(y, M);
 
       double scale=1.;
@@ -83,7 +106,7 @@ void Conv_KOMO_NLP::evaluate(arr& phi, arr& J, const arr& x) {
       else if(ob->type==OT_ineq) komo.ineq += sumOfPos(y) / scale;
       else if(ob->type==OT_eq) komo.eq += sumOfAbs(y) / scale;
 
-      if(!!J) {
+      if(!!J && !lazy) {
         if(sparse){
           yJ.sparse().reshape(J.d0, J.d1);
           yJ.sparse().colShift(M);
@@ -101,7 +124,10 @@ void Conv_KOMO_NLP::evaluate(arr& phi, arr& J, const arr& x) {
 
   CHECK_EQ(M, phi.N, "");
   komo.featureValues = phi;
-  if(!!J) komo.featureJacobians.resize(1).scalar() = J;
+  if(!!J) {
+    if(anyLazy) komo.featureJacobians.clear(); //lazy rows were left zero
+    else komo.featureJacobians.resize(1).scalar() = J;
+  }
 
   reportAfterPhiComputation(komo);
 
@@ -137,13 +163,19 @@ Conv_KOMO_NLP::Conv_KOMO_NLP(KOMO& _komo, bool sparse) : komo(_komo), sparse(spa
 
   //-- feature types
   uint M=0;
-  for(shared_ptr<GroundedObjective>& ob : komo.objs) M += ob->feat->dim(ob->frames);
+  objDims.resize(komo.objs.N);
+  for(uint i=0; i<komo.objs.N; i++) {
+    GroundedObjective* ob = komo.objs.elem(i).get();
+    objDims(i) = ob->feat->dim(ob->frames);
+    M += objDims(i);
+  }
 
   featureTypes.resize(M);
   komo.featureNames.clear();
   M=0;
-  for(shared_ptr<GroundedObjective>& ob : komo.objs) {
-    uint m = ob->feat->dim(ob->frames);
+  for(uint o=0; o<komo.objs.N; o++) {
+    GroundedObjective* ob = komo.objs.elem(o).get();
+    uint m = objDims(o);
     for(uint i=0; i<m; i++) featureTypes(M+i) = ob->type;
     for(uint j=0; j<m; j++) komo.featureNames.append(ob->feat->shortTag(komo.pathConfig));
     M += m;
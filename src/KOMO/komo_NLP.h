@@ -8,6 +8,8 @@ namespace rai {
 struct Conv_KOMO_NLP : NLP {
   KOMO& komo;
   bool sparse;
+  uintA objDims; ///< feature dimension of each grounded objective (as of construction)
+  boolA lazyFeatures; ///< solver hint: objectives whose rows are all lazy are evaluated without Jacobian
 
   arr quadraticPotentialLinear, quadraticPotentialHessian;
 
@@ -16,6 +18,7 @@ struct Conv_KOMO_NLP : NLP {
   virtual arr getInitializationSample(const arr& previousOptima= {});
   virtual void evaluate(arr& phi, arr& J, const arr& x);
   virtual void getFHessian(arr& H, const arr& x);
+  virtual void setLazyFeatures(const boolA& lazy) { lazyFeatures = lazy; }
 
   virtual void report(ostream& os, int verbose, const char* msg=0);
 };
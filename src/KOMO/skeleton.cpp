@@ -393,6 +393,7 @@ shared_ptr<KOMO> Skeleton::getKomo_finalSlice(const rai::Configuration& C, doubl
   for(uint i=komo->objs.N;i--;) if(!komo->objs(i)->feat){
     komo->objs.remove(i);
   }
+  komo->nlp_warm.reset(); //structure changed
 
   for(uint i=0;i<explicitCollisions.N;i+=2){
     komo->addObjective({}, FS_distance, {explicitCollisions.elem(i), explicitCollisions.elem(i+1)}, OT_ineq, {collScale});
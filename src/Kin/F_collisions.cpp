@@ -46,15 +46,16 @@ void F_PairCollision::phi2(arr& y, arr& J, const FrameL& F) {
   double r1=0., r2=0.;
   rai::Mesh dot;
   dot.setDot();
-  rai::Mesh *m1=&dot, *m2=&dot;
-  if(f1->shape && f1->shape->type()!=rai::ST_marker){
-    r1 = f1->shape->radius();
-    m1 = &f1->shape->sscCore();  if(!m1->V.N) { m1 = &f1->shape->mesh(); r1=0.; }
+  const rai::Mesh *m1=&dot, *m2=&dot;
+  const rai::Shape *s1=f1->shape, *s2=f2->shape; //const access keeps meshes shared between copies
+  if(s1 && s1->_type!=rai::ST_marker){
+    r1 = s1->radius();
+    m1 = &s1->sscCore();  if(!m1->V.N) { m1 = &s1->mesh(); r1=0.; }
     if(!m1->V.N) m1 = &dot;
   }
-  if(f2->shape && f2->shape->type()!=rai::ST_marker){
-    r2 = f2->shape->radius();
-    m2 = &f2->shape->sscCore();  if(!m2->V.N) { m2 = &f2->shape->mesh(); r2=0.; }
+  if(s2 && s2->_type!=rai::ST_marker){
+    r2 = s2->radius();
+    m2 = &s2->sscCore();  if(!m2->V.N) { m2 = &s2->mesh(); r2=0.; }
     if(!m2->V.N) m2 = &dot;
   }
 
@@ -127,39 +128,58 @@ void F_PairCollision::phi2(arr& y, arr& J, const FrameL& F) {
 void F_AccumulatedCollisions::phi2(arr& y, arr& J, const FrameL& F) {
   rai::Configuration& C = F.first()->C;
   C.kinematicsZero(y, J, 1);
-  for(rai::Proxy& p: C.proxies) {
-    bool isSelected=false;
-    if(selectAll){
-        //select based on indices, e.g. being in a single time slice of a path config
-        isSelected = (p.a->ID>=F.first()->ID && p.a->ID<=F.last()->ID)
-                     || (p.b->ID>=F.first()->ID && p.b->ID<=F.last()->ID);
-    }else{
-        //select by explicitly looking up in F
-        isSelected = (!selectXor && (F.contains(p.a) || F.contains(p.b)))
-                     || (selectXor && (F.contains(p.a) ^ F.contains(p.b)));
-    }
-    if(isSelected){
-      CHECK(p.a->shape, "");
-      CHECK(p.b->shape, "");
 
-      //early check: if swift is way out of collision, don't bother computing it precisely
-      if(p.d > p.a->shape->radius() + p.b->shape->radius() + .01 + margin) continue;
+  auto accumulate = [&](rai::Proxy& p) {
+    CHECK(p.a->shape, "");
+    CHECK(p.b->shape, "");
 
-      if(!p.collision) p.calc_coll();
+    //early check: if swift is way out of collision, don't bother computing it precisely
+    if(p.d > p.a->shape->radius() + p.b->shape->radius() + .01 + margin) return;
 
-      if(p.collision->getDistance()>margin) continue;
+    if(!p.collision) p.calc_coll();
 
-      arr Jp1, Jp2;
-      p.a->C.jacobian_pos(Jp1, p.a, p.collision->p1);
-      p.b->C.jacobian_pos(Jp2, p.b, p.collision->p2);
+    if(p.collision->getDistance()>margin) return;
+
+    arr Jp1, Jp2;
+    p.a->C.jacobian_pos(Jp1, p.a, p.collision->p1);
+    p.b->C.jacobian_pos(Jp2, p.b, p.collision->p2);
 
-      arr y_dist, J_dist;
-      p.collision->kinDistance(y_dist, J_dist, Jp1, Jp2);
+    arr y_dist, J_dist;
+    p.collision->kinDistance(y_dist, J_dist, Jp1, Jp2);
 
-      if(y_dist.scalar()>margin) continue; //this is the hinge: proxies contribute only when below margin
+    if(y_dist.scalar()>margin) return; //this is the hinge: proxies contribute only when below margin
 
-      y += margin-y_dist.scalar();
-      J -= J_dist;
+    y += margin-y_dist.scalar();
+    J -= J_dist;
+  };
+
+  //proxies are looked up via the configuration's per-frame (and per-slice) proxy index;
+  //a proxy with both frames selected is visited only from its first one
+  if(selectAll){
+    //select based on indices, e.g. being in a single time slice of a path config
+    uint lo = F.first()->ID, hi = F.last()->ID;
+    if(C.frames.nd==2 && lo%C.frames.d1==0 && hi+1==lo+C.frames.d1){ //exactly one time slice
+      for(uint i: C.getProxiesOfSlice(lo/C.frames.d1)) accumulate(C.proxies(i));
+    }else{
+      for(uint id=lo; id<=hi; id++) for(uint i: C.getProxiesOfFrame(id)){
+        rai::Proxy& p = C.proxies(i);
+        uint other = (p.a->ID==id ? p.b->ID : p.a->ID);
+        if(other>=lo && other<id) continue;
+        accumulate(p);
+      }
+    }
+  }else{
+    //select by explicitly looking up in F
+    uintA ids = framesToIndices(F);
+    ids.reshape(-1);
+    ids.sort().removeDoublesInSorted();
+    for(uint id: ids) for(uint i: C.getProxiesOfFrame(id)){
+      rai::Proxy& p = C.proxies(i);
+      uint other = (p.a->ID==id ? p.b->ID : p.a->ID);
+      bool otherSelected = ids.containsInSorted(other);
+      if(selectXor && otherSelected) continue;
+      if(otherSelected && other<id) continue;
+      accumulate(p);
     }
   }
 }
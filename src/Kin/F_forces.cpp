@@ -20,11 +20,11 @@
 //helper methods:
 
 void POA_distance(arr& y, arr& J, rai::ForceExchange* ex, bool b_or_a) {
-  rai::Shape* s = ex->a.shape;
+  const rai::Shape* s = ex->a.shape;
   if(b_or_a) s = ex->b.shape;
   CHECK(s, "contact object does not have a shape!");
   double r=s->radius();
-  rai::Mesh* m = &s->sscCore();  if(!m->V.N) { m = &s->mesh(); r=0.; }
+  const rai::Mesh* m = &s->sscCore();  if(!m->V.N) { m = &s->mesh(); r=0.; }
 
   CHECK_EQ(&ex->a.C, &ex->b.C, "");
   rai::Configuration& K = ex->a.C;
@@ -653,13 +653,13 @@ void F_fex_POAContactDistances::phi2(arr& y, arr& J, const FrameL& F) {
   rai::ForceExchange* ex = getContact(f1, f2);
 
   //-- POA inside objects (eventually on surface!)
-  rai::Shape* s1 = f1->shape;
-  rai::Shape* s2 = f2->shape;
+  const rai::Shape* s1 = f1->shape;
+  const rai::Shape* s2 = f2->shape;
   CHECK(s1 && s2, "");
   double r1=s1->radius();
   double r2=s2->radius();
-  rai::Mesh* m1 = &s1->sscCore();  if(!m1->V.N) { m1 = &s1->mesh(); r1=0.; }
-  rai::Mesh* m2 = &s2->sscCore();  if(!m2->V.N) { m2 = &s2->mesh(); r2=0.; }
+  const rai::Mesh* m1 = &s1->sscCore();  if(!m1->V.N) { m1 = &s1->mesh(); r1=0.; }
+  const rai::Mesh* m2 = &s2->sscCore();  if(!m2->V.N) { m2 = &s2->mesh(); r2=0.; }
 
   rai::Mesh M0;
   M0.setDot();
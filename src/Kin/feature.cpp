@@ -86,7 +86,8 @@ FrameL Feature::getFrames(const rai::Configuration& C, uint s) {
     F.reshape(1, F.N);
   }else{
     CHECK_EQ(C.frames.nd, 2, "");
-    CHECK_GE(C.frames.d0, order+s+1, "");
+    CHECK_GE(s, order, "slice " <<s <<" has no " <<order <<" predecessors");
+    CHECK_GE(C.frames.d0, s+1, "");
     F.resize(order+1, frameIDs.N);
     for(uint i=0;i<=order;i++){
       for(uint j=0;j<frameIDs.N;j++){
@@ -178,13 +178,13 @@ void rai::ForceExchange::kinTorque(arr& y, arr& J) const {
 
 rai::PairCollision* rai::ForceExchange::coll() {
   if(!__coll) {
-    rai::Shape* s1 = a.shape;
-    rai::Shape* s2 = b.shape;
+    const rai::Shape* s1 = a.shape;
+    const rai::Shape* s2 = b.shape;
     CHECK(s1 && s2, "");
     double r1=s1->size(-1);
     double r2=s2->size(-1);
-    rai::Mesh* m1 = &s1->sscCore();  if(!m1->V.N) { m1 = &s1->mesh(); r1=0.; }
-    rai::Mesh* m2 = &s2->sscCore();  if(!m2->V.N) { m2 = &s2->mesh(); r2=0.; }
+    const rai::Mesh* m1 = &s1->sscCore();  if(!m1->V.N) { m1 = &s1->mesh(); r1=0.; }
+    const rai::Mesh* m2 = &s2->sscCore();  if(!m2->V.N) { m2 = &s2->mesh(); r2=0.; }
     __coll = new PairCollision(*m1, *m2, s1->frame.ensure_X(), s2->frame.ensure_X(), r1, r2);
   }
   return __coll;
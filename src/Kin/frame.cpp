@@ -47,17 +47,18 @@ void rai::Transformation_Qtoken::operator=(const rai::Transformation& _Q) { f.Q=
 
 bool rai_Kin_frame_ignoreQuatNormalizationWarning = false;
 
-rai::Frame::Frame(Configuration& _C, const Frame* copyFrame)
+rai::Frame::Frame(Configuration& _C, const Frame* copyFrame, BulkStorage* bulk)
   : C(_C) {
 
   ID=C.frames.N;
   C.frames.append(this);
+  C._state_shapes_revision++;
   if(copyFrame) {
     const Frame& f = *copyFrame;
     name=f.name; Q=f.Q; X=f.X; _state_X_isGood=f._state_X_isGood; tau=f.tau; ats=f.ats;
     //we cannot copy link! because we can't know if the frames already exist. Configuration::copy copies the rel's !!
-    if(copyFrame->joint) new Joint(*this, copyFrame->joint);
-    if(copyFrame->shape) new Shape(*this, copyFrame->shape);
+    if(copyFrame->joint) { if(bulk) bulk->make<Joint>(*this, copyFrame->joint); else new Joint(*this, copyFrame->joint); }
+    if(copyFrame->shape) { if(bulk) bulk->make<Shape>(*this, copyFrame->shape); else new Shape(*this, copyFrame->shape); }
     if(copyFrame->inertia) new Inertia(*this, copyFrame->inertia);
     if(copyFrame->particleDofs) new ParticleDofs(*this, copyFrame->particleDofs);
     if(copyFrame->pathDof) new PathDof(*this, copyFrame->pathDof);
@@ -78,6 +79,8 @@ rai::Frame::~Frame() {
   if(inertia) delete inertia;
   if(parent) unLink();
   while(children.N) children.last()->unLink();
+  C.remove_frameIndex(this);
+  C._state_shapes_revision++; //frame IDs may change
   if(this==C.frames.last()) { //great: this is very efficient to remove without breaking indexing
     CHECK_EQ(ID, C.frames.N-1, "");
     C.frames.resizeCopy(C.frames.N-1);
@@ -89,6 +92,12 @@ rai::Frame::~Frame() {
   C.reset_q();
 }
 
+void rai::Frame::operator delete(Frame* f, std::destroying_delete_t) {
+  void* bulk = f->_bulk;
+  f->~Frame();
+  if(bulk) BulkStorage::release(bulk); else ::operator delete(f);
+}
+
 void rai::Frame::calc_X_from_parent() {
   CHECK(parent, "");
   CHECK(parent->_state_X_isGood, "");
@@ -273,7 +282,13 @@ rai::Dof* rai::Frame::getDof() const {
 void rai::Frame::prefixSubtree(const char* prefix) {
   FrameL F = {this};
   getSubtree(F);
-  for(auto* f:F) f->name.prepend(prefix);
+  for(auto* f:F) f->setName(STRING(prefix <<f->name));
+}
+
+rai::Frame& rai::Frame::setName(const char* _name) {
+  C.rename_frameIndex(this, _name);
+  name = _name;
+  return *this;
 }
 
 void rai::Frame::computeCompoundInertia(bool clearChildInertias){
@@ -304,7 +319,7 @@ void rai::Frame::convertDecomposedShapeToChildFrames(){
     if(!s.V.N){
       delete ch; //ch->setShape(ST_marker, {.01});
     }else{
-      ch->shape->cont = shape->cont;
+      ch->setContact(shape->cont);
     }
   }
   delete shape;
@@ -360,7 +375,7 @@ void rai::Frame::read(const Graph& ats) {
   if(transFromAts(tmp, ats, "Q")) set_Q() = tmp;
   if(transFromAts(tmp, ats, "rel")) set_Q() = tmp;
 
-  if(ats["type"]) ats["type"]->key = "shape"; //compatibility with old convention: 'body { type... }' generates shape
+  if(ats["type"]) ats["type"]->setKey("shape"); //compatibility with old convention: 'body { type... }' generates shape
 
   Node *n;
   if((n=ats["joint"])) {
@@ -441,9 +456,10 @@ void rai::Frame::write(std::ostream& os) const {
 /************* USER INTERFACE **************/
 
 rai::Frame& rai::Frame::setShape(rai::ShapeType shape, const arr& size) {
+  getShape().detach();
   getShape().type() = shape;
   getShape().size = size;
-  getShape().createMeshes();
+  getShape().createMeshes(); //increments C._state_shapes_revision
   return *this;
 }
 
@@ -492,6 +508,7 @@ rai::Frame& rai::Frame::setRelativeQuaternion(const arr& quat) {
 }
 
 rai::Frame& rai::Frame::setPointCloud(const arr& points, const byteA& colors) {
+  getShape().detach();
   getShape().type() = ST_pointCloud;
   if(!points.N) {
     cerr <<"given point cloud has zero size" <<endl;
@@ -504,10 +521,12 @@ rai::Frame& rai::Frame::setPointCloud(const arr& points, const byteA& colors) {
     mesh.C = (convert<double>(byteA(colors))/255.).reshape(-1, 3);
     if(mesh.C.N <= 4){ mesh.C.reshape(-1); }
   }
+  C._state_shapes_revision++;
   return *this;
 }
 
 rai::Frame& rai::Frame::setConvexMesh(const arr& points, const byteA& colors, double radius) {
+  getShape().detach();
   if(!radius) {
     getShape().type() = ST_mesh;
     getShape().mesh().V.clear().operator=(points).reshape(-1, 3);
@@ -523,23 +542,28 @@ rai::Frame& rai::Frame::setConvexMesh(const arr& points, const byteA& colors, do
   if(colors.N) {
     getShape().mesh().C.clear().operator=(convert<double>(byteA(colors))/255.).reshape(-1, 3);
   }
+  C._state_shapes_revision++;
   return *this;
 }
 
 rai::Frame& rai::Frame::setMesh(const rai::Mesh& m) {
+  getShape().detach();
   getShape().type() = ST_mesh;
   getShape().mesh() = m;
+  C._state_shapes_revision++;
   return *this;
 }
 
 rai::Frame& rai::Frame::setSdf(const SDF_GridData& sdf) {
+  getShape().detach();
   getShape().type() = ST_sdf;
   getShape().sdf() = sdf;
-  getShape().createMeshes();
+  getShape().createMeshes(); //increments C._state_shapes_revision
   return *this;
 }
 
 rai::Frame& rai::Frame::setColor(const arr& color) {
+  getShape().detach();
   getShape().mesh().C = color;
   return *this;
 }
@@ -556,6 +580,7 @@ rai::Frame& rai::Frame::setJoint(rai::JointType jointType) {
 
 rai::Frame& rai::Frame::setContact(int cont) {
   getShape().cont = cont;
+  C._state_shapes_revision++;
   return *this;
 }
 
@@ -828,6 +853,12 @@ rai::Joint::~Joint() {
   if(mimic &&  mimic!=(Joint*)1) mimic->mimicers.removeValue(this);
 }
 
+void rai::Joint::operator delete(Joint* j, std::destroying_delete_t) {
+  void* bulk = j->_bulk;
+  j->~Joint();
+  if(bulk) BulkStorage::release(bulk); else ::operator delete(j);
+}
+
 const rai::Transformation& rai::Joint::X() const {
   return frame->parent->get_X();
 }
@@ -1469,6 +1500,7 @@ rai::Shape::Shape(Frame& f, const Shape* copyShape)
 
   CHECK(!frame.shape, "this frame ('" <<frame.name <<"') already has a shape attached");
   frame.shape = this;
+  frame.C._state_shapes_revision++;
   if(copyShape) {
     const Shape& s = *copyShape;
     if(s._mesh) _mesh = s._mesh; //shallow shared_ptr copy!
@@ -1482,6 +1514,52 @@ rai::Shape::Shape(Frame& f, const Shape* copyShape)
 
 rai::Shape::~Shape() {
   frame.shape = nullptr;
+  frame.C._state_shapes_revision++;
+}
+
+void rai::Shape::operator delete(Shape* s, std::destroying_delete_t) {
+  void* bulk = s->_bulk;
+  s->~Shape();
+  if(bulk) BulkStorage::release(bulk); else ::operator delete(s);
+}
+
+rai::Mesh& rai::Shape::mesh() {
+  if(!_mesh) { if(_type==ST_none) _type=ST_mesh; _mesh = make_shared<Mesh>(); }
+  else if(_mesh.use_count()>1) _mesh = make_shared<Mesh>(*_mesh);
+  return *_mesh;
+}
+
+rai::Mesh& rai::Shape::sscCore() {
+  if(!_sscCore) { if(_type==ST_none) _type=ST_ssCvx; _sscCore = make_shared<Mesh>(); }
+  else if(_sscCore.use_count()>1) _sscCore = make_shared<Mesh>(*_sscCore);
+  return *_sscCore;
+}
+
+SDF_GridData& rai::Shape::sdf() {
+  if(!_sdf) { if(_type==ST_none) _type=ST_sdf; _sdf = make_shared<SDF_GridData>(); }
+  else if(_sdf.use_count()>1) _sdf = make_shared<SDF_GridData>(*_sdf);
+  return *_sdf;
+}
+
+const rai::Mesh& rai::Shape::mesh() const {
+  static const Mesh none;
+  return _mesh ? *_mesh : none;
+}
+
+const rai::Mesh& rai::Shape::sscCore() const {
+  static const Mesh none;
+  return _sscCore ? *_sscCore : none;
+}
+
+const SDF_GridData& rai::Shape::sdf() const {
+  static const SDF_GridData none;
+  return _sdf ? *_sdf : none;
+}
+
+void rai::Shape::detach() {
+  if(_mesh && _mesh.use_count()>1) _mesh = make_shared<Mesh>(*_mesh);
+  if(_sscCore && _sscCore.use_count()>1) _sscCore = make_shared<Mesh>(*_sscCore);
+  if(_sdf && _sdf.use_count()>1) _sdf = make_shared<SDF_GridData>(*_sdf);
 }
 
 bool rai::Shape::canCollideWith(const rai::Frame* f) const {
@@ -1591,6 +1669,8 @@ void rai::Shape::read(const Graph& ats) {
     //    }
   }
 
+  frame.C._state_shapes_revision++;
+
   //compute the bounding radius
 //  if(mesh().V.N) mesh_radius = mesh().getRadius();
 }
@@ -1628,7 +1708,7 @@ void rai::Shape::glDraw(OpenGL& gl) {
     glColorId(frame.ID);
     CHECK(!gl.drawOptions.drawColors, "must be disabled..");
   } else if(gl.drawOptions.drawColors) {
-    if(mesh().C.N) glColor(mesh().C); //color[0], color[1], color[2], color[3]*world.orsDrawAlpha);
+    if(_mesh && _mesh->C.N) glColor(_mesh->C); //color[0], color[1], color[2], color[3]*world.orsDrawAlpha);
     else glColor(.5, .5, .5);
   }
 
@@ -1677,17 +1757,17 @@ void rai::Shape::glDraw(OpenGL& gl) {
         glDrawCamera(cam); //gl.camera);
       }
     } else {
-      if(!mesh().V.N) {
+      if(!_mesh || !_mesh->V.N) {
         LOG(-1) <<"trying to draw empty mesh (shape type:" <<_type <<")";
-      } else {
-        if(!mesh().T.N){
+      } else { //draw the (possibly shared) mesh without detaching it
+        if(!_mesh->T.N){
           if(size.N) glPointSize(size.last());
           else glPointSize(1.f);
         }
-        if(!mesh().C.N){
+        if(!_mesh->C.N){
           glColor(.8, .8, .8);
         }
-        mesh().glDraw(gl);
+        _mesh->glDraw(gl);
       }
     }
   }
@@ -1803,6 +1883,7 @@ void rai::Shape::createMeshes() {
       HALT("createMeshes not possible for shape type '" <<_type <<"'");
     }
   }
+  frame.C._state_shapes_revision++;
 //  auto func = functional(false);
 //  if(func){
 //    mesh().setImplicitSurfaceBySphereProjection(*func, 2.);
@@ -1833,7 +1914,7 @@ shared_ptr<ScalarFunction> rai::Shape::functional(bool worldCoordinates){
     case rai::ST_mesh:
     case rai::ST_sdf:
       if(_sdf){
-        _sdf->pose = pose;
+        sdf().pose = pose; //detaches: copies have different poses
         return _sdf;
       }
       return shared_ptr<ScalarFunction>();
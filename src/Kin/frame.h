@@ -73,7 +73,7 @@ struct Transformation_Qtoken {
 struct Frame : NonCopyable {
   Configuration& C;        ///< a Frame is uniquely associated with a Configuration
   uint ID;                 ///< unique identifier (index in Configuration.frames)
-  String name;             ///< name
+  String name;             ///< name (rename via setName)
   Frame* parent=nullptr;   ///< parent frame
   FrameL children;         ///< list of children
   Frame* prev=0;           ///< same frame in the previous time slice - if time sliced
@@ -102,10 +102,12 @@ struct Frame : NonCopyable {
   Array<ForceExchange*> forces;  ///< this frame exchanges forces with other frames
   ParticleDofs* particleDofs=nullptr; ///< this frame is a set of particles that are dofs themselves
   PathDof* pathDof=nullptr; ///< this frame is a set of particles that are dofs themselves
+  void* _bulk=nullptr; ///< the BulkStorage block this was placed in, if any
 
-  Frame(Configuration& _C, const Frame* copyFrame=nullptr);
+  Frame(Configuration& _C, const Frame* copyFrame=nullptr, BulkStorage* bulk=nullptr); ///< a given bulk also places the joint and shape copies
   Frame(Frame* _parent);
   ~Frame();
+  static void operator delete(Frame* f, std::destroying_delete_t); ///< releases bulk storage (see Configuration::addCopies)
 
   //accessors to attachments
   Shape& getShape();
@@ -139,6 +141,7 @@ struct Frame : NonCopyable {
   Dof* getDof() const;
 
   void prefixSubtree(const char* prefix);
+  Frame& setName(const char* _name); ///< rename; writing name directly makes the next Configuration::getFrame rebuild its name index
   void transformToDiagInertia();
 
   //composed object manipulation
@@ -246,11 +249,13 @@ struct Joint : Dof, NonCopyable {
 
   //attachments to the joint
   //struct Uncertainty* uncertainty=nullptr;
+  void* _bulk=nullptr;
 
   Joint(Frame& f, JointType type);
   Joint(Frame& f, Joint* copyJoint=nullptr);
   Joint(Frame& from, Frame& f, Joint* copyJoint=nullptr);
   ~Joint();
+  static void operator delete(Joint* j, std::destroying_delete_t);
 
   const Transformation& X() const; ///< the base frame, where the joint STARTS (i.e. parent->X)
   const Transformation& Q() const; ///< the transformation realized by this joint (i.e. from parent->X to frame->X)
@@ -316,19 +321,26 @@ struct Shape : NonCopyable, GLDrawer {
   shared_ptr<Mesh> _sscCore;
   shared_ptr<SDF_GridData> _sdf;
   char cont=0;           ///< are contacts registered (or filtered in the callback)
+  void* _bulk=nullptr;
 
-  double radius() { if(size.N) return size(-1); return 0.; }
+  double radius() const { if(size.N) return size(-1); return 0.; }
   Enum<ShapeType>& type() { return _type; }
-  Mesh& mesh() { if(!_mesh){ if(_type==ST_none) _type=ST_mesh; _mesh = make_shared<Mesh>(); } return *_mesh; }
-  Mesh& sscCore() { if(!_sscCore){ if(_type==ST_none) _type=ST_ssCvx;  _sscCore = make_shared<Mesh>();  } return *_sscCore; }
-  SDF_GridData& sdf() { if(!_sdf){ if(_type==ST_none) _type=ST_sdf; _sdf = make_shared<SDF_GridData>(); } return *_sdf; }
-  double alpha() { arr& C=mesh().C; if(C.N==4 || C.N==2) return C(-1); return 1.; }
+  Mesh& mesh(); ///< creates the mesh if none, detaches it if shared with copies (see detach)
+  Mesh& sscCore();
+  SDF_GridData& sdf();
+  const Mesh& mesh() const; ///< read access that keeps sharing (an empty mesh if none)
+  const Mesh& sscCore() const;
+  const SDF_GridData& sdf() const;
+  double alpha() const { const arr& C=mesh().C; if(C.N==4 || C.N==2) return C(-1); return 1.; }
 
   void createMeshes();
   shared_ptr<ScalarFunction> functional(bool worldCoordinates=true);
 
   Shape(Frame& f, const Shape* copyShape=nullptr); //new Shape, being added to graph and frame's shape lists
   virtual ~Shape();
+  static void operator delete(Shape* s, std::destroying_delete_t);
+
+  void detach(); ///< copy-on-write: copies share meshes and SDFs; this gives the shape its own before modifying them
 
   bool canCollideWith(const Frame* f) const;
 
@@ -22,6 +22,7 @@
 #include "../Core/graph.h"
 #include "../Core/util.h"
 #include "../Geo/fclInterface.h"
+#include "../Geo/broadphase.h"
 #include "../Geo/qhull.h"
 #include "../Geo/mesh_readAssimp.h"
 #include "../Gui/opengl.h"
@@ -30,6 +31,8 @@
 #include <algorithm>
 #include <sstream>
 #include <climits>
+#include <unordered_map>
+#include <mutex>
 
 #ifdef RAI_ASSIMP
 #  include <assimp/Exporter.hpp>
@@ -104,16 +107,20 @@ void computeOptimalSSBoxes(FrameL& frames) {
 void computeMeshNormals(FrameL& frames, bool force) {
   for(Frame* f: frames) if(f->shape) {
       Shape* s = f->shape;
-      if(force || s->mesh().V.d0!=s->mesh().Vn.d0 || s->mesh().T.d0!=s->mesh().Tn.d0) s->mesh().computeNormals();
-      if(force || s->sscCore().V.d0!=s->sscCore().Vn.d0 || s->sscCore().T.d0!=s->sscCore().Tn.d0) s->sscCore().computeNormals();
+      const Shape& cs = *s;
+      const Mesh& m=cs.mesh(), &c=cs.sscCore(); //const access: only detach what needs recomputation
+      if(force || m.V.d0!=m.Vn.d0 || m.T.d0!=m.Tn.d0) s->mesh().computeNormals();
+      if(force || c.V.d0!=c.Vn.d0 || c.T.d0!=c.Tn.d0) s->sscCore().computeNormals();
     }
 }
 
 void computeMeshGraphs(FrameL& frames, bool force) {
   for(Frame* f: frames) if(f->shape) {
       Shape* s = f->shape;
-      if(force || s->mesh().V.d0!=s->mesh().graph.N|| s->mesh().T.d0!=s->mesh().Tn.d0) s->mesh().buildGraph();
-      if(force || s->sscCore().V.d0!=s->sscCore().graph.N || s->sscCore().T.d0!=s->sscCore().Tn.d0) s->sscCore().buildGraph();
+      const Shape& cs = *s;
+      const Mesh& m=cs.mesh(), &c=cs.sscCore();
+      if(force || m.V.d0!=m.graph.N || m.T.d0!=m.Tn.d0) s->mesh().buildGraph();
+      if(force || c.V.d0!=c.graph.N || c.T.d0!=c.Tn.d0) s->sscCore().buildGraph();
     }
 }
 
@@ -126,9 +133,18 @@ struct sConfiguration {
   shared_ptr<ConfigurationViewer> viewer;
   //shared_ptr<SwiftInterface> swift;
   shared_ptr<FclInterface> fcl;
+  shared_ptr<Broadphase> broadphase;
+  uint broadphaseRevision=0; //_state_shapes_revision when the broadphase was built
   unique_ptr<PhysXInterface> physx;
   unique_ptr<OdeInterface> ode;
   unique_ptr<FeatherstoneInterface> fs;
+  std::unordered_map<std::string, uintA> frameIndex; //name -> IDs (increasing) of frames with that name, built lazily by getFrame
+  uint frameIndexN=0; //number of (leading) frames covered by frameIndex
+  std::mutex frameIndexMutex; //getFrame is const but extends the index: concurrent lookups serialize on this
+  uintAA frameProxies; //for each frame, indices of the proxies involving it, built lazily by getProxiesOfFrame
+  uintAA sliceProxies; //for path configurations, the same for each time slice
+  int proxyIndexN=-1; //proxies.N when the proxy index was built; -1 if invalid
+  uint proxyIndexSliceN=0; //frames per time slice when the proxy index was built
 };
 
 Configuration::Configuration() {
@@ -220,7 +236,7 @@ Frame* Configuration::addFile(const char* filename, const char* namePrefix) {
   Graph G(file);
   if(namePrefix && namePrefix[0]){
     for(Node *n:G){
-      n->key.prepend(namePrefix);
+      n->setKey(STRING(namePrefix <<n->key));
       rai::String *tmp=0;
       if(n->is<Graph>()) tmp=n->graph().find<rai::String>("mimic");
       if(tmp) tmp->prepend(namePrefix);
@@ -322,59 +338,89 @@ Frame* Configuration::addObject(const char* name, const char* parent, ShapeType
 }
 #endif
 
-/// add copies of all given frames and forces, which can be from another Configuration -> \ref frames array becomes sliced! (a matrix)
-Frame* Configuration::addCopies(const FrameL& F, const DofL& _dofs) {
-  //prepare an index FId -> thisId
+/// add nSlices copies of all given frames and forces, which can be from another Configuration -> \ref frames array becomes sliced! (a matrix)
+Frame* Configuration::addCopies(const FrameL& F, const DofL& _dofs, uint nSlices) {
+  if(!nSlices || !F.N) return nullptr;
+
+  //-- compile the slice template once: index F.ID -> position in F, parent & mimic positions
   uint maxId=0;
   for(Frame* f:F) if(f->ID>maxId) maxId=f->ID;
-  intA FId2thisId(maxId+1);
-  FId2thisId = -1;
+  intA FId2i(maxId+1);
+  FId2i = -1;
+  for(uint i=0; i<F.N; i++) FId2i(F.elem(i)->ID) = i;
 
-  //create new copied frames
-  for(Frame* f:F) {
-    Frame* f_new = new Frame(*this, f);
-    FId2thisId(f->ID) = f_new->ID;
-
-    //convert constant joints to mimic joints
-    if(f->joint && f->ats && (*f->ats)["constant"]){
-      Frame *f_orig = getFrame(f_new->name); //identify by name!!!
-      if(f_orig!=f_new){
-        CHECK(f_orig->joint, "");
-        f_new->joint->setMimic(f_orig->joint);
+  intA parent_i(F.N), mimic_i(F.N);
+  parent_i = -1;
+  mimic_i = -1;
+  for(uint i=0; i<F.N; i++) {
+    Frame* f = F.elem(i);
+    if(f->parent) {
+      if(f->parent->ID>maxId || FId2i(f->parent->ID)==-1) {
+        LOG(-1) <<"can't relink frame '" <<*f <<"'";
+      } else {
+        parent_i(i) = FId2i(f->parent->ID);
       }
     }
-
-    //auto-create prev link if names match
-    if(f_new->ID>=F.N){
-      rai::Frame *p = frames(f_new->ID-F.N);
-      if(p->name==f_new->name) f_new->prev = p;
-    }
+    //take care of within-F mimic joints:
+    if(f->joint && f->joint->mimic && f->joint->mimic->frame->ID<maxId) mimic_i(i) = FId2i(f->joint->mimic->frame->ID);
   }
 
-  //relink frames - special attention to mimic'ing
-  for(Frame* f:F) if(f->parent){
-    if(f->parent->ID>maxId || FId2thisId(f->parent->ID)==-1) {
-      LOG(-1) <<"can't relink frame '" <<*f <<"'";
-    }
-    Frame* f_new = frames.elem(FId2thisId(f->ID));
-    f_new->setParent(frames.elem(FId2thisId(f->parent->ID)));
-    //take care of within-F mimic joints:
-    if(f->joint && f->joint->mimic){
-      if(f->joint->mimic->frame->ID<maxId && FId2thisId(f->joint->mimic->frame->ID)!=-1){
-        f_new->joint->setMimic(frames.elem(FId2thisId(f->joint->mimic->frame->ID))->joint, true);
+  //-- preallocate: frames, joints and shapes of all slices go into one contiguous block
+  size_t bytes=0;
+  for(Frame* f:F) {
+    bytes += BulkStorage::slotSize(sizeof(Frame));
+    if(f->joint) bytes += BulkStorage::slotSize(sizeof(Joint));
+    if(f->shape) bytes += BulkStorage::slotSize(sizeof(Shape));
+  }
+  BulkStorage bulk(nSlices*bytes);
+  if(frames.nd<=1) frames.reserveMEM(frames.N+nSlices*F.N);
+
+  //-- replicate the template slice by slice (meshes, SDFs and attributes are shared, see Shape::detach)
+  FrameL constOrig(F.N); //origin of constant joints, identified by name at the first copy
+  constOrig.setZero();
+  uint firstID = frames.N;
+  for(uint s=0; s<nSlices; s++) {
+    uint sliceID = frames.N;
+
+    //create new copied frames
+    for(uint i=0; i<F.N; i++) {
+      Frame* f = F.elem(i);
+      Frame* f_new = bulk.make<Frame>(*this, f, &bulk);
+
+      //convert constant joints to mimic joints
+      if(f->joint && f->ats && (*f->ats)["constant"]) {
+        if(!s) constOrig(i) = getFrame(f_new->name); //identify by name!!!
+        Frame* f_orig = constOrig(i);
+        if(f_orig!=f_new) {
+          CHECK(f_orig->joint, "");
+          f_new->joint->setMimic(f_orig->joint);
+        }
+      }
+
+      //auto-create prev link if names match (always true within the replicated slices)
+      if(f_new->ID>=F.N) {
+        rai::Frame* p = frames.elem(f_new->ID-F.N);
+        if(s || p->name==f_new->name) f_new->prev = p;
       }
     }
-  }
 
-  //copy force exchanges
-  for(Dof * dof:_dofs){
-    const ForceExchange* ex = dof->fex();
-    if(ex) new ForceExchange(*frames.elem(FId2thisId(ex->a.ID)), *frames.elem(FId2thisId(ex->b.ID)), ex->type, ex);
+    //relink frames - special attention to mimic'ing
+    for(uint i=0; i<F.N; i++) if(parent_i(i)!=-1) {
+      Frame* f_new = frames.elem(sliceID+i);
+      f_new->setParent(frames.elem(sliceID+parent_i(i)));
+      if(mimic_i(i)!=-1) f_new->joint->setMimic(frames.elem(sliceID+mimic_i(i))->joint, true);
+    }
+
+    //copy force exchanges
+    for(Dof* dof:_dofs) {
+      const ForceExchange* ex = dof->fex();
+      if(ex) new ForceExchange(*frames.elem(sliceID+FId2i(ex->a.ID)), *frames.elem(sliceID+FId2i(ex->b.ID)), ex->type, ex);
+    }
   }
 
   if(!(frames.N%F.N)) frames.reshape(-1, F.N);
 
-  return frames.elem(FId2thisId(F.first()->ID));
+  return frames.elem(firstID);
 }
 
 /// same as addCopies() with C.frames and C.forces
@@ -384,14 +430,73 @@ void Configuration::addConfiguration(const Configuration& C, double tau){
 }
 
 /// get first frame with given name
+//configurations with fewer frames are searched linearly
+#define RAI_KIN_FRAMEINDEX_MINN 32
+
 Frame* Configuration::getFrame(const char* name, bool warnIfNotExist, bool reverse) const {
-  if(!reverse) {
-    for(Frame* b: frames) if(b->name==name) return b;
+  Frame* f=0;
+  if(name && frames.N>=RAI_KIN_FRAMEINDEX_MINN) {
+    //hashed lookup (e.g., for KOMO's pathConfig): index frames added since the last lookup; renames should go through Frame::setName
+    std::lock_guard<std::mutex> lock(self->frameIndexMutex);
+    auto& index = self->frameIndex;
+    uint& indexN = self->frameIndexN;
+    for(;;) {
+      if(indexN>frames.N) { index.clear(); indexN=0; }
+      for(; indexN<frames.N; indexN++) {
+        const String& fname = frames.elem(indexN)->name;
+        index[fname.p?fname.p:""].append(indexN);
+      }
+      auto it = index.find(name);
+      bool stale=false;
+      if(it!=index.end() && it->second.N) {
+        for(uint i:it->second) if(!(frames.elem(i)->name==name)) { stale=true; break; }
+        if(!stale) { f = frames.elem(reverse ? it->second.last() : it->second.first()); break; }
+      } else {
+        //a miss can be a name written directly (not via setName): confirm with the linear scan
+        for(Frame* b: frames) if(b->name==name) { stale=true; break; }
+        if(!stale) break;
+      }
+      //the index is out of date: rebuild once
+      index.clear(); indexN=0;
+    }
+  } else if(!reverse) {
+    for(Frame* b: frames) if(b->name==name) { f=b; break; }
   } else {
-    for(uint i=frames.N; i--;) if(frames.elem(i)->name==name) return frames.elem(i);
+    for(uint i=frames.N; i--;) if(frames.elem(i)->name==name) { f=frames.elem(i); break; }
   }
-  if(warnIfNotExist) RAI_MSG("cannot find frame named '" <<name <<"'");
-  return 0;
+  if(!f && warnIfNotExist) RAI_MSG("cannot find frame named '" <<name <<"'");
+  return f;
+}
+
+void Configuration::reset_frameIndex() {
+  self->frameIndex.clear();
+  self->frameIndexN=0;
+}
+
+void Configuration::remove_frameIndex(Frame* f) {
+  uint& indexN = self->frameIndexN;
+  if(f->ID>=indexN) return; //not indexed (or no index at all): no indexed ID changes
+  if(f==frames.last()) { //only f's own entry goes away
+    auto it = self->frameIndex.find(f->name.p?f->name.p:"");
+    if(it!=self->frameIndex.end() && it->second.N && it->second.last()==f->ID) {
+      it->second.resizeCopy(it->second.N-1);
+      indexN--;
+      return;
+    }
+  }
+  reset_frameIndex(); //the following IDs are renumbered
+}
+
+void Configuration::rename_frameIndex(Frame* f, const char* name) {
+  uint& indexN = self->frameIndexN;
+  if(f->ID>=indexN) return; //not indexed yet
+  auto& index = self->frameIndex;
+  auto it = index.find(f->name.p?f->name.p:"");
+  if(it==index.end() || !it->second.removeValue(f->ID, false)) { reset_frameIndex(); return; }
+  uintA& IDs = index[name?name:""];
+  uint i=0;
+  while(i<IDs.N && IDs.elem(i)<f->ID) i++;
+  IDs.insert(i, f->ID);
 }
 
 /// get all frames of given indices (almost same as \ref frames . Array::sub() )
@@ -633,6 +738,7 @@ void Configuration::setJointState(const arr& _q) {
   q=_q;
 
   proxies.clear();
+  self->proxyIndexN=-1;
 
   _state_q_isGood=true;
   _state_proxies_isGood=false;
@@ -666,6 +772,7 @@ void Configuration::setDofState(const arr& _q, const DofL& dofs, bool mimicsIncl
   CHECK_EQ(_q.N, nd, "given q-vector has wrong size");
 
   proxies.clear();
+  self->proxyIndexN=-1;
 
   _state_q_isGood=true;
   _state_proxies_isGood=false;
@@ -899,17 +1006,23 @@ double Configuration::getEnergy(const arr& qdot) {
 }
 
 /// get the sum of all shape penetrations -- PRECONDITION: proxies have been computed (with stepFcl())
-double Configuration::getTotalPenetration() {
+double Configuration::getTotalPenetration(int slice) {
   CHECK(_state_proxies_isGood, "");
 
   double D=0.;
-  for(const Proxy& p:proxies) {
+  auto add = [&D](Proxy& p) {
     //early check: if proxy is way out of collision, don't bother computing it precise
-    if(p.d > p.a->shape->radius()+p.b->shape->radius()+.01) continue;
+    if(p.d > p.a->shape->radius()+p.b->shape->radius()+.01) return;
     //exact computation
-    if(!p.collision)((Proxy*)&p)->calc_coll();
+    if(!p.collision) p.calc_coll();
     double d = p.collision->getDistance();
     if(d<0.) D -= d;
+  };
+  if(slice<0) {
+    for(Proxy& p:proxies) add(p);
+  } else {
+    CHECK_EQ(frames.nd, 2, "slice-wise penetration requires a path configuration");
+    for(uint i:getProxiesOfSlice(slice)) add(proxies(i));
   }
   //  for(Frame *f:frames) for(ForceExchange *c:f->forces) if(&c->a==f) {
   //        double d = c->getDistance();
@@ -940,7 +1053,7 @@ bool Configuration::checkUniqueNames(bool makeUnique) {
       if(a==b) break;
       if(a->name==b->name){
         if(!makeUnique) return false;
-        else a->name <<'_' <<a->ID;
+        else a->setName(STRING(a->name <<'_' <<a->ID));
       }
     }
   return true;
@@ -986,9 +1099,11 @@ void Configuration::clear() {
 //  swiftDelete();
   if(self->viewer) self->viewer->clear();
   self->fcl.reset();
+  self->broadphase.reset();
 
   reset_q();
   proxies.clear(); //while(proxies.N){ delete proxies.last(); /*checkConsistency();*/ }
+  self->proxyIndexN=-1;
   while(frames.N) { delete frames.last(); /*checkConsistency();*/ }
   reset_q();
   //if(self->viewer) self->viewer->recopyMeshes(*this);
@@ -1100,6 +1215,7 @@ void Configuration::optimizeTree(bool _pruneRigidJoints, bool pruneNamed, bool p
 
 void Configuration::sortFrames() {
   frames = calc_topSort();
+  reset_frameIndex();
   uint i=0;
   for(Frame* f: frames) f->ID = i++;
 }
@@ -1373,10 +1489,24 @@ FrameL Configuration::getCollisionAllPairs(){
   return coll;
 }
 
+Array<shared_ptr<Mesh>> Configuration::getCollisionGeometries(){
+  Array<shared_ptr<Mesh>> geometries(frames.N);
+  for(Frame* f:frames) {
+    if(f->shape && f->shape->cont) {
+      CHECK(f->shape->type()!=rai::ST_marker, "collision object can't be a marker");
+      const Shape& s = *f->shape; //const access keeps meshes shared between copies
+      if(!s.mesh().V.N) f->shape->createMeshes();
+      CHECK(s.mesh().V.N, "collision object with no vertices");
+      geometries(f->ID) = f->shape->_mesh;
+    }
+  }
+  return geometries;
+}
+
 /// creates uniques names by prefixing the node-index-number to each name */
 void Configuration::prefixNames(bool clear) {
-  if(!clear) for(Frame* a: frames) a->name=STRING('_' <<a->ID <<'_' <<a->name);
-  else       for(Frame* a: frames) a->name.clear() <<a->ID;
+  if(!clear) for(Frame* a: frames) a->setName(STRING('_' <<a->ID <<'_' <<a->name));
+  else       for(Frame* a: frames) a->setName(STRING(a->ID));
 }
 
 void Configuration::calc_indexedActiveJoints(bool resetActiveJointSet) {
@@ -1546,7 +1676,7 @@ arr Configuration::calc_fwdPropagateVelocities(const arr& qdot) {
 }
 
 void Configuration::ensure_proxies(bool fine) {
-  if(!_state_proxies_isGood) stepFcl(); //broadphase
+  if(!_state_proxies_isGood) stepBroadphase(); //broadphase
   if(fine) for(Proxy& p: proxies) if(!p.collision) p.calc_coll(); //fine
 }
 
@@ -1733,10 +1863,12 @@ void Configuration::jacobian_angular(arr& J, Frame* a) const {
           uint offset = 0;
           if(j->type==JT_XBall) offset=1;
           if(j->type==JT_free) offset=3;
-          arr Jrot = j->X().rot.getArr() * a->get_Q().rot.getJacobian(); //transform w-vectors into world coordinate
-          Jrot /= sqrt(sumOfSqr(q({j->qIndex+offset, j->qIndex+offset+3}))); //account for the potential non-normalization of q
+          double Jq[12];
+          a->get_Q().rot.getJacobian(Jq);
+          arr Jrot(3, 4);
+          j->X().rot.getMatrix().mult(Jrot.p, Jq, 4); //transform w-vectors into world coordinate
+          Jrot *= j->scale / sqrt(sumOfSqr(q({j->qIndex+offset, j->qIndex+offset+3}))); //account for the potential non-normalization of q
           //          for(uint i=0;i<4;i++) for(uint k=0;k<3;k++) J.elem(k,j_idx+offset+i) += Jrot(k,i);
-          Jrot *= j->scale;
           J.setMatrixBlock(Jrot, 0, j_idx+offset);
         }
         if(j->type==JT_generic) {
@@ -1848,7 +1980,10 @@ void Configuration::kinematicsMat(arr& y, arr& J, Frame* a) const {
     arr A;
     jacobian_angular(A, a);
     jacobian_zero(J, 9);
-    if(A.N){
+    if(A.N && !isSpecial(A) && !isSpecial(J)){
+      //dense case: write the three 3xn blocks directly
+      for(uint i=0; i<3; i++) fixed_crossColumns(J.p+3*i*A.d1, A.p, R.p+3*i, A.d1);
+    } else if(A.N){
       J.setMatrixBlock(crossProduct(A, R[0]), 0, 0);
       J.setMatrixBlock(crossProduct(A, R[1]), 3, 0);
       J.setMatrixBlock(crossProduct(A, R[2]), 6, 0);
@@ -1884,10 +2019,11 @@ void Configuration::kinematicsQuat(arr& y, arr& J, Frame* a) const { //TODO: all
     J.rowShifted().insRow(0);
     J = ROT_A * J;
   } else if(!isSpecial(A)) {
-    J.resize(4, A.d1).setZero();
-    J.setMatrixBlock(A, 1, 0);
-    J *= .5;
-    J = ROT_A * J;
+    //J = ROT_A * [0; .5*A], using only the right 4x3 block of ROT_A
+    double R[12];
+    for(uint i=0; i<4; i++) for(uint k=0; k<3; k++) R[i*3+k] = .5*ROT_A(i, k+1);
+    J.resize(4, A.d1);
+    fixed_MM<4, 3>(J.p, R, A.p, A.d1);
   } else NIY;
 }
 
@@ -2069,20 +2205,20 @@ std::shared_ptr<SwiftInterface> Configuration::swift() {
 
 std::shared_ptr<FclInterface> Configuration::fcl() {
   if(!self->fcl) {
-    Array<shared_ptr<Mesh>> geometries(frames.N);
-    for(Frame* f:frames) {
-      if(f->shape && f->shape->cont) {
-        CHECK(f->shape->type()!=rai::ST_marker, "collision object can't be a marker");
-        if(!f->shape->mesh().V.N) f->shape->createMeshes();
-        CHECK(f->shape->mesh().V.N, "collision object with no vertices");
-        geometries(f->ID) = f->shape->_mesh;
-      }
-    }
-    self->fcl = make_shared<FclInterface>(geometries, -1.); //-1.=broadphase only -> many proxies, 0.=binary, .1=exact margin (slow)
+    self->fcl = make_shared<FclInterface>(getCollisionGeometries(), -1.); //-1.=broadphase only -> many proxies, 0.=binary, .1=exact margin (slow)
   }
   return self->fcl;
 }
 
+/// return the native broadphase (rebuilt when frames or collision shapes changed, see _state_shapes_revision)
+std::shared_ptr<Broadphase> Configuration::broadphase() {
+  if(!self->broadphase || self->broadphaseRevision!=_state_shapes_revision) {
+    self->broadphase = make_shared<Broadphase>(getCollisionGeometries());
+    self->broadphaseRevision = _state_shapes_revision; //after createMeshes in getCollisionGeometries
+  }
+  return self->broadphase;
+}
+
 /// return a PhysX extension
 PhysXInterface& Configuration::physx() {
   if(!self->physx) {
@@ -2164,20 +2300,20 @@ void Configuration::glGetMasks(int w, int h, bool rgbIndices) {
 #endif
 
 
-void Configuration::addProxies(const uintA& collisionPairs) {
+void Configuration::addProxies(const uintA& collisionPairs, bool filterPairs) {
   //-- filter the collisions
   boolA filter(collisionPairs.d0);
   uint n=0;
-#if 1
-  for(uint i=0; i<collisionPairs.d0; i++) {
-    bool canCollide = frames.elem(collisionPairs(i, 0))->shape->canCollideWith(frames.elem(collisionPairs(i, 1)));
-    filter(i) = canCollide;
-    if(canCollide) n++;
+  if(filterPairs) {
+    for(uint i=0; i<collisionPairs.d0; i++) {
+      bool canCollide = frames.elem(collisionPairs(i, 0))->shape->canCollideWith(frames.elem(collisionPairs(i, 1)));
+      filter(i) = canCollide;
+      if(canCollide) n++;
+    }
+  } else { //already filtered (e.g. by the broadphase)
+    filter = true;
+    n = collisionPairs.d0;
   }
-#else
-  filter = true;
-  n = collisionPairs.d0;
-#endif
   //-- copy them into proxies
   uint j = proxies.N;
   proxies.resizeCopy(j+n);
@@ -2195,6 +2331,38 @@ void Configuration::addProxies(const uintA& collisionPairs) {
       j++;
     }
   }
+  self->proxyIndexN=-1;
+}
+
+static void ensure_proxyIndex(Configuration& C) {
+  sConfiguration& s = *C.self;
+  uint T = (C.frames.nd==2 ? C.frames.d0 : 1);
+  uint nFrames = (C.frames.nd==2 ? C.frames.d1 : C.frames.N);
+  if(s.proxyIndexN==(int)C.proxies.N && s.frameProxies.N==C.frames.N && s.proxyIndexSliceN==nFrames) return;
+  s.frameProxies.resize(C.frames.N);
+  for(uintA& l:s.frameProxies) l.clear();
+  s.sliceProxies.resize(T);
+  for(uintA& l:s.sliceProxies) l.clear();
+  for(uint i=0; i<C.proxies.N; i++) {
+    const Proxy& p = C.proxies.elem(i);
+    s.frameProxies(p.a->ID).append(i);
+    if(p.b!=p.a) s.frameProxies(p.b->ID).append(i);
+    uint ta = p.a->ID/nFrames, tb = p.b->ID/nFrames;
+    s.sliceProxies(ta).append(i);
+    if(tb!=ta) s.sliceProxies(tb).append(i);
+  }
+  s.proxyIndexN = C.proxies.N;
+  s.proxyIndexSliceN = nFrames;
+}
+
+const uintA& Configuration::getProxiesOfFrame(uint frameID) {
+  ensure_proxyIndex(*this);
+  return self->frameProxies(frameID);
+}
+
+const uintA& Configuration::getProxiesOfSlice(uint t) {
+  ensure_proxyIndex(*this);
+  return self->sliceProxies(t);
 }
 
 /*
@@ -2223,6 +2391,16 @@ void Configuration::stepFcl(double cutoff) {
   _state_proxies_isGood=true;
 }
 
+void Configuration::stepBroadphase(double margin) {
+  auto bp = broadphase();
+  for(uint id:bp->ids) bp->setPose(id, frames.elem(id)->ensure_X());
+  bp->step(margin, [this](uint a, uint b) { return frames.elem(a)->shape->canCollideWith(frames.elem(b)); });
+  proxies.clear();
+  addProxies(bp->collisions, false);
+
+  _state_proxies_isGood=true;
+}
+
 void Configuration::stepPhysx(double tau) {
   physx().step(tau);
 }
@@ -2332,6 +2510,7 @@ void Configuration::copyProxies(const ProxyA& _proxies) {
   proxies.clear();
   proxies.resize(_proxies.N);
   for(uint i=0; i<proxies.N; i++) proxies(i).copy(*this, _proxies(i));
+  self->proxyIndexN=-1;
 }
 
 /// prototype for \c operator<<
@@ -2353,7 +2532,7 @@ void Configuration::write(std::ostream& os, bool explicitlySorted) const {
 }
 
 void Configuration::write(Graph& G) const {
-  for(Frame* f: frames) if(!f->name.N) f->name <<'_' <<f->ID;
+  for(Frame* f: frames) if(!f->name.N) f->setName(STRING('_' <<f->ID));
   for(Frame* f: frames) f->write(G.addSubgraph(f->name));
   for(uint i=0;i<frames.N;i++) if(frames(i)->parent){
     G.elem(i)->addParent(G.elem(frames(i)->parent->ID));
@@ -2570,16 +2749,16 @@ Graph Configuration::getGraph() const {
     Node* n = G.elem(f->ID);
     if(f->parent) {
       n->addParent(G.elem(f->parent->ID));
-      n->key = STRING("Q= " <<f->get_Q());
+      n->setKey(STRING("Q= " <<f->get_Q()));
     }
     if(f->joint) {
-      n->key = (STRING("joint " <<f->joint->type));
+      n->setKey(STRING("joint " <<f->joint->type));
     }
     if(f->shape) {
-      n->key = (STRING("shape " <<f->shape->type()));
+      n->setKey(STRING("shape " <<f->shape->type()));
     }
     if(f->inertia) {
-      n->key = (STRING("inertia m=" <<f->inertia->mass));
+      n->setKey(STRING("inertia m=" <<f->inertia->mass));
     }
   }
 #else
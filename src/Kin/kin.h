@@ -35,6 +35,7 @@ struct Configuration;
 struct KinematicSwitch;
 
 struct FclInterface;
+struct Broadphase;
 struct ConfigurationViewer;
 
 } // namespace rai
@@ -73,6 +74,7 @@ struct Configuration : GLDrawer {
   bool _state_indexedJoints_areGood=false; // the active sets, incl. their topological sorting, are up to date
   bool _state_q_isGood=false; // the q-vector represents the current relative transforms (and force dofs)
   bool _state_proxies_isGood=false; // the proxies have been created for the current state
+  uint _state_shapes_revision=0; // incremented when frames are added/removed or collision shapes change (geometry, contact flag) -- direct writes to Shape members need to increment it
   //TODO: need a _state for all the plugin engines (SWIFT, PhysX)? To auto-reinitialize them when the config changed structurally?
 
   //-- format in which Jacobians are returned
@@ -96,7 +98,7 @@ struct Configuration : GLDrawer {
   Frame* addFrame(const char* name, const char* parent=nullptr, const char* args=nullptr, bool warnDuplicateName=true);
   Frame* addFile(const char* filename, const char* namePrefix=0);
   Frame* addAssimp(const char* filename);
-  Frame* addCopies(const FrameL& F, const DofL& _dofs);
+  Frame* addCopies(const FrameL& F, const DofL& _dofs, uint nSlices=1);
   void addConfiguration(const Configuration& C, double tau=1.);
 
   /// @name get frames
@@ -159,7 +161,7 @@ struct Configuration : GLDrawer {
   arr getLimits() const { return getLimits(activeDofs); }
   arr getTorqueLimits(const DofL& dofs, uint index=4) const;
   double getEnergy(const arr& qdot);
-  double getTotalPenetration(); ///< proxies are returns from a collision engine; contacts stable constraints
+  double getTotalPenetration(int slice=-1); ///< proxies are returns from a collision engine; contacts stable constraints (slice>=0: only those of that time slice of a path configuration)
   Graph reportForces();
   bool checkUniqueNames(bool makeUnique=false);
   FrameL calc_topSort() const;
@@ -168,6 +170,9 @@ struct Configuration : GLDrawer {
   /// @name structural operations, changes of configuration
   void clear();
   void reset_q();
+  void reset_frameIndex(); ///< drop the hashed frame name index of getFrame (when reordering frames)
+  void remove_frameIndex(Frame* f); ///< (internal) called by ~Frame before f is removed from frames
+  void rename_frameIndex(Frame* f, const char* name); ///< (internal) move f to its new name in the index; use Frame::setName
   void reconfigureRoot(Frame* newRoot, bool ofLinkOnly);  ///< n becomes the root of the kinematic tree; joints accordingly reversed; lists resorted
   void flipFrames(Frame* a, Frame* b);
   void pruneRigidJoints();        ///< delete rigid joints -> they become just links
@@ -185,6 +190,7 @@ struct Configuration : GLDrawer {
   uintA getCollisionExcludeIDs(bool verbose=false);
   uintA getCollisionExcludePairIDs(bool verbose=false);
   FrameL getCollisionAllPairs();
+  Array<shared_ptr<Mesh>> getCollisionGeometries(); ///< meshes of all contact shapes indexed by frame ID (created on demand), as used by the collision engines
   void prefixNames(bool clear=false);
 
   /// @name computations on the tree
@@ -235,13 +241,16 @@ struct Configuration : GLDrawer {
 
   /// @name collisions & proxies
   void copyProxies(const ProxyA& _proxies);
-  void addProxies(const uintA& collisionPairs);
+  void addProxies(const uintA& collisionPairs, bool filter=true);
+  const uintA& getProxiesOfFrame(uint frameID); ///< indices of the proxies involving the frame (index rebuilt lazily when the proxies changed)
+  const uintA& getProxiesOfSlice(uint t);       ///< for path configurations (frames.nd==2): indices of the proxies involving frames of time slice t
 
   /// @name extensions on demand
   std::shared_ptr<ConfigurationViewer>& viewer(const char* window_title=nullptr, bool offscreen=false);
   OpenGL& gl();
   //std::shared_ptr<SwiftInterface> swift();
   std::shared_ptr<FclInterface> fcl();
+  std::shared_ptr<Broadphase> broadphase();
   void swiftDelete();
   PhysXInterface& physx();
   OdeInterface& ode();
@@ -253,6 +262,7 @@ struct Configuration : GLDrawer {
   int glAnimate();
   void view_close();
   void stepFcl(double cutoff=-1.);
+  void stepBroadphase(double margin=0.);
   void stepPhysx(double tau);
   void stepOde(double tau);
   void stepDynamics(arr& qdot, const arr& u_control, double tau, double dynamicNoise = 0.0, bool gravity = true);
@@ -64,7 +64,8 @@ void KinViewer::step() {
     auto _dataLock = gl->dataLock(RAI_HERE);
     meshesCopy.resize(n);
     for(uint i=0; i<n; i++) {
-      if(world->frames.elem(i)->shape) meshesCopy.elem(i) = world->frames.elem(i)->shape->mesh();
+      const rai::Shape* s = world->frames.elem(i)->shape;
+      if(s) meshesCopy.elem(i) = s->mesh();
       else meshesCopy.elem(i).clear();
     }
   }
@@ -216,7 +217,8 @@ void KinPoseViewer::step() {
       meshesCopy.resize(n);
       for(uint i=0; i<n; i++) {
         rai::Frame* f = modelGet->frames.elem(i);
-        if(f->shape) meshesCopy.elem(i) = f->shape->mesh();
+        const rai::Shape* s = f->shape;
+        if(s) meshesCopy.elem(i) = s->mesh();
         else meshesCopy.elem(i).clear();
       }
     }
@@ -351,7 +351,7 @@ void Simulation::closeGripper(const char* gripperFrameName, double width, double
   CHECK(finger2->shape && finger2->shape->cont, "");
 
   //collect objects close to fing1 and fing2
-  C.stepFcl();
+  C.stepBroadphase();
   FrameL fing1close;
   FrameL fing2close;
   for(rai::Proxy& p:C.proxies) {
@@ -894,7 +894,7 @@ void Imp_NoPenetrations::modConfiguration(Simulation& S, double tau){
     S.C.kinematicsZero(y, J, 1);
 
     // Check penetrations between robot vs. static objects
-    S.C.stepFcl();
+    S.C.stepBroadphase();
     for(rai::Proxy& p: S.C.proxies){
       if(!(dynamicFrames.contains(p.a->ID) || dynamicFrames.contains(p.b->ID))) {
         if(p.d > p.a->shape->radius() + p.b->shape->radius() + .01) continue;
@@ -465,11 +465,13 @@ void LGP_Node::getGraph(Graph& G, Node* n, bool brief) {
   }
 
   if(!brief) {
-    n->key <<STRING("\ns:" <<step <<" t:" <<time <<" bound:" <<highestBound <<" feas:" <<!isInfeasible <<" term:" <<isTerminal <<' ' <<folState->isNodeOfGraph->key);
+    String key = n->key;
+    key <<STRING("\ns:" <<step <<" t:" <<time <<" bound:" <<highestBound <<" feas:" <<!isInfeasible <<" term:" <<isTerminal <<' ' <<folState->isNodeOfGraph->key);
     for(uint l=0; l<L; l++) if(count(l))
-      n->key <<STRING('\n' <<Enum<BoundType>::name(l) <<" #:" <<count(l) <<" c:" <<cost(l) <<"|" <<constraints(l) <<" " <<(feasible(l)?'1':'0') <<" time:" <<computeTime(l));
-    if(folAddToState) n->key <<STRING("\nsymAdd:" <<*folAddToState);
-    if(note.N) n->key <<'\n' <<note;
+      key <<STRING('\n' <<Enum<BoundType>::name(l) <<" #:" <<count(l) <<" c:" <<cost(l) <<"|" <<constraints(l) <<" " <<(feasible(l)?'1':'0') <<" time:" <<computeTime(l));
+    if(folAddToState) key <<STRING("\nsymAdd:" <<*folAddToState);
+    if(note.N) key <<'\n' <<note;
+    n->setKey(key);
   }
 
   G.getRenderingInfo(n).dotstyle="shape=box";
@@ -103,6 +103,17 @@ void FOL_World::init(const Graph& _KB) {
 FOL_World::~FOL_World() {
 }
 
+std::shared_ptr<TreeSearchDomain> FOL_World::clone() const {
+  const_cast<Graph&>(KB).index(); //transitions leave the KB non-indexed, which copying requires (only renumbers nodes)
+  auto W = std::make_shared<FOL_World>();
+  W->copy(*this);
+  W->hasWait=hasWait;  W->gamma=gamma;  W->stepCost=stepCost;  W->timeCost=timeCost;  W->deadEndCost=deadEndCost;  W->maxHorizon=maxHorizon;
+  W->start_T_step=start_T_step;
+  W->start_T_real=start_T_real;
+  W->state = W->KB.find<Graph>("STATE"); //the copied KB already has a state subgraph (reset_state overwrites it with the start state)
+  return W;
+}
+
 TreeSearchDomain::TransitionReturn FOL_World::transition(const Handle& action) {
   lastStepReward = -stepCost;
   lastStepDuration = 0.;
@@ -131,10 +142,10 @@ TreeSearchDomain::TransitionReturn FOL_World::transition(const Handle& action) {
     NodeL decisionTuple = {d->rule};
     decisionTuple.append(d->substitution);
     lastDecisionInState = createNewFact(*state, decisionTuple);
-    lastDecisionInState->key = "decision";
+    lastDecisionInState->setKey("decision");
   } else {
     lastDecisionInState = createNewFact(*state, {Wait_keyword});
-    lastDecisionInState->key = "decision";
+    lastDecisionInState->setKey("decision");
   }
 
   //-- apply effects of decision
@@ -293,7 +304,7 @@ void FOL_World::make_current_state_new_start() {
   if(!start_state) start_state = &KB.addSubgraph("START_STATE", state->isNodeOfGraph->parents);
   state->index();
   start_state->copy(*state);
-  start_state->isNodeOfGraph->key="START_STATE";
+  start_state->isNodeOfGraph->setKey("START_STATE");
   start_T_step = T_step;
   start_T_real = T_real;
   DEBUG(KB.checkConsistency();)
@@ -666,9 +677,9 @@ NodeL FOL_World_State::getDecisionSequence(String& string){
   NodeL decisions;
   for(FOL_World_State* s:folStates) if(s->folDecision){
     decisions.append(s->folDecision);
-    s->folDecision->key = " ";
+    s->folDecision->setKey(" ");
     string <<*s->folDecision;
-    s->folDecision->key = "decision";
+    s->folDecision->setKey("decision");
   }
   return decisions;
 }
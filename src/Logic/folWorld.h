@@ -106,6 +106,7 @@ struct FOL_World : TreeSearchDomain {
   void init(const Graph& _KB);
   void init(const char* filename);
   void copy(const FOL_World& fol) { init(fol.KB); }
+  virtual std::shared_ptr<TreeSearchDomain> clone() const;
 
   virtual TransitionReturn transition(const Handle& action); //returns (observation, reward)
   virtual const Array<Handle> get_actions();
@@ -82,6 +82,9 @@ struct TreeSearchDomain {
   virtual double get_info_value(InfoTag tag) const = 0;
 
   virtual void write(std::ostream& os) const { std::cerr <<"NOT OVERLOADED!" <<std::endl; }
+
+  /// an independent copy (same start state), needed for parallel rollouts; for equal decision sequences it must list its actions in the same order (solvers address clones by action index)
+  virtual std::shared_ptr<TreeSearchDomain> clone() const { NIY; return {}; }
 };
 inline std::ostream& operator<<(std::ostream& os, const TreeSearchDomain& E) { E.write(os); return os; }
 inline std::ostream& operator<<(std::ostream& os, const TreeSearchDomain::SAO& x) { x.write(os); return os; }
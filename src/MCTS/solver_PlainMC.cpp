@@ -8,6 +8,8 @@
 
 #include "solver_PlainMC.h"
 
+#include <thread>
+
 void MCStatistics::add(double R, uint topSize) {
   n++;
   if(X.N<topSize) X.insertInSorted(R, rai::greaterEqual<double>);
@@ -17,8 +19,19 @@ void MCStatistics::add(double R, uint topSize) {
   }
 }
 
+void MCStatistics::merge(const MCStatistics& other, uint topSize) {
+  for(double R:other.X) {
+    if(X.N<topSize) X.insertInSorted(R, rai::greaterEqual<double>);
+    else if(R>X.last()) {
+      X.insertInSorted(R, rai::greaterEqual<double>);
+      X.popLast();
+    }
+  }
+  n += other.n;
+}
+
 PlainMC::PlainMC(rai::TreeSearchDomain& world)
-  : world(world), gamma(.9), verbose(2), topSize(10) {
+  : world(world), gamma(.9), verbose(2), topSize(10), rng(&rnd) {
   reset();
   gamma = world.get_info_value(rai::TreeSearchDomain::getGamma);
   rai::FileToken fil("PlainMC.blackList");
@@ -70,7 +83,7 @@ double PlainMC::finishRollout(int stepAbort) {
       if(verbose>1) { cout <<" -- no decisions left -> terminal" <<endl; }
       break;
     }
-    uint a = rand()%actions.N;
+    uint a = (*rng)(actions.N);
     if(verbose>1) cout <<"****************** MC: random decision: " <<*actions(a) <<endl;
     rolloutDecisions.append(actions(a));
     ret = world.transition(actions(a));
@@ -135,7 +148,7 @@ double PlainMC::generateRollout(int stepAbort, const rai::Array<rai::TreeSearchD
 
 double PlainMC::addRollout(int stepAbort) {
   // random first choice
-  uint a = rnd(A.N);
+  uint a = (*rng)(A.N);
 
   //generate rollout
   generateRollout(stepAbort, {A(a)});
@@ -157,6 +170,46 @@ double PlainMC::addRollout(int stepAbort) {
   return rolloutR;
 }
 
+void PlainMC::addRollouts(uint n, uint threads, int stepAbort, uint32_t seed) {
+  if(!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+  if(threads>n) threads = n;
+  if(!threads) return;
+
+  //-- setup workers (sequentially): each owns a world clone, a random source and its own statistics
+  rai::Array<std::shared_ptr<rai::TreeSearchDomain>> worlds(threads);
+  std::vector<rai::Rnd> rngs(threads);
+  rai::Array<std::shared_ptr<PlainMC>> workers(threads);
+  for(uint w=0; w<threads; w++) {
+    worlds(w) = world.clone();
+    worlds(w)->reset_state();
+    rngs[w].seed(seed + 1000003u*w);
+    auto& W = workers(w);
+    W = std::make_shared<PlainMC>(*worlds(w));
+    CHECK_EQ(W->A.N, A.N, "the cloned world has a different number of start decisions");
+    W->verbose = 0;
+    W->gamma = gamma;
+    W->topSize = topSize;
+    W->blackList = blackList;
+    W->rng = &rngs[w];
+  }
+
+  //-- run
+  auto run = [&](uint w) {
+    uint nw = n/threads + (w<n%threads ? 1 : 0);
+    for(uint i=0; i<nw; i++) workers(w)->addRollout(stepAbort);
+  };
+  std::vector<std::thread> pool;
+  for(uint w=1; w<threads; w++) pool.emplace_back(run, w);
+  run(0);
+  for(std::thread& th:pool) th.join();
+
+  //-- merge statistics in worker order
+  for(uint w=0; w<threads; w++) {
+    for(uint a=0; a<A.N; a++) D(a).merge(workers(w)->D(a), topSize);
+    Droot.merge(workers(w)->Droot, topSize);
+  }
+}
+
 void PlainMC::addReturnToStatistics(double rolloutR, rai::TreeSearchDomain::Handle decision, int decisionIndex) {
   if(decisionIndex>=0) {
     CHECK_EQ(A(decisionIndex), decision, "")
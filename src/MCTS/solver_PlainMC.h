@@ -21,6 +21,7 @@ struct MCStatistics {
   MCStatistics():n(0) {}
   void clear() { X.clear(); n=0; }
   void add(double R, uint topSize=10);
+  void merge(const MCStatistics& other, uint topSize=10); ///< as if all of other's returns were added
 };
 
 //===========================================================================
@@ -35,6 +36,7 @@ struct PlainMC {
   int verbose;
   uint topSize;
   StringA blackList;
+  rai::Rnd* rng;    ///< random source of the rollouts (default: the global rnd)
 
   //partly internal: results of a rollout
   uint rolloutStep;
@@ -48,6 +50,7 @@ struct PlainMC {
   double finishRollout(int stepAbort=-1);
   double generateRollout(int stepAbort=-1, const rai::Array<rai::TreeSearchDomain::Handle>& prefixDecisions= {});
   double addRollout(int stepAbort=-1);                 ///< adds one more rollout to the tree
+  void addRollouts(uint n, uint threads=0, int stepAbort=-1, uint32_t seed=0); ///< root-parallel: each thread runs rollouts on a clone of the world; statistics are merged in thread order (deterministic for fixed seed and threads)
   void addReturnToStatistics(double R, rai::TreeSearchDomain::Handle decision, int decisionIndex=-1);
   void report();
   uint getBestActionIdx();
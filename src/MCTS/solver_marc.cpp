@@ -8,6 +8,8 @@
 
 #include "solver_marc.h"
 
+#include <thread>
+
 void MCTS::addRollout(int stepAbort) {
   int step=0;
   MCTS_Node* n = &root;
@@ -52,13 +54,15 @@ void MCTS::addRollout(int stepAbort) {
 
   //  double r = world.get_terminal_reward();
   //  Return_rollout += r;
-  if(step>=stepAbort) Return_rollout -= 100.;
+  if(stepAbort>=0 && step>=stepAbort) Return_rollout -= 100.;
   if(verbose>0) cout <<"****************** MCTS: terminal state reached; step=" <<step <<" Return=" <<Return_tree + Return_rollout <<endl;
 
   //-- backup
-  double Return_togo = Return_rollout;
-  for(;;) {
-    if(!n) break;
+  backup(n, Return_rollout);
+}
+
+void MCTS::backup(MCTS_Node* n, double Return_togo) {
+  for(; n; n=n->parent) {
     n->N++;
     n->R += n->r;   //total immediate reward
     Return_togo += n->r; //add up total return from n to terminal
@@ -68,16 +72,86 @@ void MCTS::addRollout(int stepAbort) {
       n->Qme = max(Qfunction(n,  0));
       n->Qlo = max(Qfunction(n, -1));
     }
-    n = n->parent;
   }
 }
 
-MCTS_Node* MCTS::treePolicy(MCTS_Node* n) {
+void MCTS::addRollouts(uint n, uint threads, int stepAbort, uint32_t seed, double virtualLoss) {
+  if(!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+  if(threads>n) threads = n;
+  if(!threads) return;
+
+  rai::Array<std::shared_ptr<rai::TreeSearchDomain>> worlds(threads);
+  for(uint k=0; k<threads; k++) worlds(k) = world.clone();
+  rai::Rnd selectRnd;
+  selectRnd.seed(seed);
+  std::vector<rai::Rnd> playRnd(threads);
+
+  struct Leaf { rai::Array<MCTS_Node*> path; uintA choices; arr rewards; int step; double Return_rollout; };
+  std::vector<Leaf> leaves(threads);
+
+  for(uint done=0; done<n;) {
+    uint B = std::min(threads, n-done);
+
+    //-- select B leaves sequentially (on the world itself); virtual loss steers later selections of the batch away from earlier ones
+    for(uint k=0; k<B; k++) {
+      Leaf& L = leaves[k];
+      L.path = {&root};
+      L.choices.clear();
+      L.rewards = {0.};
+      L.step = 0;
+      MCTS_Node* m = &root;
+      world.reset_state();
+      while(!world.is_terminal_state() && (stepAbort<0 || L.step++<stepAbort)) {
+        if(!m->children.N && !m->N) break; //freshmen -> do not expand
+        if(!m->children.N) for(const rai::TreeSearchDomain::Handle& d:world.get_actions()) new MCTS_Node(m, d);
+        MCTS_Node* c = treePolicy(m, selectRnd);
+        L.choices.append(m->children.findValue(c));
+        m = c;
+        L.path.append(m);
+        L.rewards.append(world.transition(m->decision).reward);
+      }
+      for(MCTS_Node* v:L.path) { v->N++; v->Q -= virtualLoss; }
+    }
+
+    //-- random playouts in parallel, each on its own clone with its own random source; the clone replays the
+    //   tree decisions by child index, as action handles of different clones need not compare equal
+    auto playout = [&](uint k) {
+      rai::TreeSearchDomain& W = *worlds(k);
+      rai::Rnd& R = playRnd[k];
+      Leaf& L = leaves[k];
+      R.seed(seed + 1000003u*(done+k+1));
+      W.reset_state();
+      for(uint i:L.choices) W.transition(W.get_actions()(i));
+      L.Return_rollout = 0.;
+      while(!W.is_terminal_state() && (stepAbort<0 || L.step++<stepAbort)) {
+        auto A = W.get_actions();
+        L.Return_rollout += W.transition(A(R(A.N))).reward;
+      }
+      if(stepAbort>=0 && L.step>=stepAbort) L.Return_rollout -= 100.;
+    };
+    std::vector<std::thread> pool;
+    for(uint k=1; k<B; k++) pool.emplace_back(playout, k);
+    playout(0);
+    for(std::thread& th:pool) th.join();
+
+    //-- backup in batch order (after removing the virtual loss)
+    for(uint k=0; k<B; k++) {
+      Leaf& L = leaves[k];
+      for(MCTS_Node* v:L.path) { v->N--; v->Q += virtualLoss; }
+      for(uint i=1; i<L.path.N; i++) L.path(i)->r = L.rewards(i);
+      if(verbose>0) cout <<"****************** MCTS: terminal state reached; step=" <<L.step <<" Return=" <<sum(L.rewards) + L.Return_rollout <<endl;
+      backup(L.path.last(), L.Return_rollout);
+    }
+    done += B;
+  }
+}
+
+MCTS_Node* MCTS::treePolicy(MCTS_Node* n, rai::Rnd& R) {
   CHECK(n->children.N, "you should have children!");
   CHECK(n->N, "you should not be a freshman!");
   if(n->N>n->children.N) { //we've visited each child at least once
     arr Q = Qfunction(n, +1);      //optimistic Qfunction
-    rndUniform(Q, 0., 1e-3, true); //add noise
+    for(double& q:Q) q += 1e-3*R.uni(); //add noise
     return n->children(argmax(Q));
   }
   return n->children(n->N-1);   //else: visit children by their order
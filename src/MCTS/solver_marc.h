@@ -46,7 +46,9 @@ struct MCTS {
   MCTS(rai::TreeSearchDomain& world):world(world), root(nullptr, nullptr), verbose(2), beta(2.) {}
 
   void addRollout(int stepAbort=-1);                 ///< adds one more rollout to the tree
-  MCTS_Node* treePolicy(MCTS_Node* n);   ///< policy to choose the child from which to do a rollout or to expand
+  void addRollouts(uint n, uint threads=0, int stepAbort=-1, uint32_t seed=0, double virtualLoss=1.); ///< tree-parallel: batches of leaves are selected under virtual loss, played out in parallel on world clones, and backed up in batch order
+  void backup(MCTS_Node* n, double Return_rollout); ///< adds the rollout return (plus the immediate rewards r along the way) to n and all its ancestors
+  MCTS_Node* treePolicy(MCTS_Node* n, rai::Rnd& R=rnd);   ///< policy to choose the child from which to do a rollout or to expand
   double Qvalue(MCTS_Node* n, int optimistic); ///< current value estimates at a node
   arr Qfunction(MCTS_Node* n=nullptr, int optimistic=0); ///< the Q-function (value estimates of all children) at a node
   arr Qvariance(MCTS_Node* n=nullptr);
@@ -26,10 +26,11 @@ BayesOpt::BayesOpt(const ScalarFunction& _f, const arr& bounds_lo, const arr& bo
   kernel_now->type = kernel_smaller->type = DefaultKernelFunction::Gauss; //TODO: ugly!!
 
   kernel_now->hyperParam1 = arr{init_lengthScale};
-  kernel_now->hyperParam2 = arr{prior_var};
+  kernel_now->hyperParam2 = arr{1.};
   kernel_smaller->hyperParam1 = kernel_now->hyperParam1;
   kernel_smaller->hyperParam1 /= 2.;
   kernel_smaller->hyperParam2 = kernel_now->hyperParam2;
+  priorVar = prior_var;
 }
 
 BayesOpt::~BayesOpt() {
@@ -62,7 +63,7 @@ void BayesOpt::run(uint maxIt) {
 
 void BayesOpt::report(bool display, const ScalarFunction& f) {
   if(!f_now) return;
-  cout <<"mean=" <<f_now->mu <<" var=" <<kernel_now->hyperParam2.scalar() <<endl;
+  cout <<"mean=" <<f_now->mu <<" var=" <<priorVar <<endl;
 
   arr X_grid, s_grid;
   X_grid.setGrid(data_X.d1, 0., 1., (data_X.d1==1?500:30));
@@ -107,25 +108,30 @@ void BayesOpt::report(bool display, const ScalarFunction& f) {
 }
 
 void BayesOpt::addDataPoint(const arr& x, double y) {
-  if(f_now) delete f_now;
-  if(f_smaller) delete f_smaller;
-
   data_X.append(x);  data_X.reshape(data_X.N/x.N, x.N);
   data_y.append(y);
 
   double fmean = sum(data_y)/data_y.N;
-  if(data_y.N>2) {
-    kernel_now->hyperParam2 = 2.*var(data_y);
-    kernel_smaller->hyperParam2 = kernel_now->hyperParam2;
-  }
-
-  f_now = new KernelRidgeRegression(data_X, data_y, *kernel_now, -1., fmean);
-  f_smaller = new KernelRidgeRegression(data_X, data_y, *kernel_smaller, -1., fmean);
+  if(data_y.N>2) priorVar = 2.*var(data_y);
+
+  //-- incremental update of the regressions (rebuilt only after a length scale change)
+  auto update = [&](KernelRidgeRegression*& f, DefaultKernelFunction& kernel) {
+    if(!f) {
+      f = new KernelRidgeRegression(data_X, data_y, kernel, -1., fmean);
+    } else {
+      f->append(x, y);
+      f->setMu(fmean);
+    }
+    f->priorVar = priorVar;
+  };
+  update(f_now, *kernel_now);
+  update(f_smaller, *kernel_smaller);
 }
 
 void BayesOpt::reOptimizeAlphaMinima() {
   alphaMinima_now.newton.f = f_now->getF(-2.);
   alphaMinima_smaller.newton.f = f_smaller->getF(-2.);
+  alphaMinima_now.threads = alphaMinima_smaller.threads = threads; //the acquisition function only reads the regressions: thread safe
 
   alphaMinima_now.reOptimizeAllPoints();
   alphaMinima_now.run(20);
@@ -150,6 +156,11 @@ arr BayesOpt::pickNextPoint() {
 
 void BayesOpt::reduceLengthScale() {
   cout <<"REDUCING LENGTH SCALE!!" <<endl;
-  kernel_now->hyperParam1 = kernel_smaller->hyperParam1;
+  //the smaller regression becomes the current one; the new smaller one is rebuilt with the next data point
+  std::swap(kernel_now, kernel_smaller);
+  std::swap(f_now, f_smaller);
+  kernel_smaller->hyperParam1 = kernel_now->hyperParam1;
   kernel_smaller->hyperParam1 /= 2.;
+  delete f_smaller;
+  f_smaller = nullptr;
 }
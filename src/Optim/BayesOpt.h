@@ -27,6 +27,8 @@ struct BayesOpt {
   struct DefaultKernelFunction* kernel_now;
   struct DefaultKernelFunction* kernel_smaller;
   double lengthScale;
+  double priorVar; ///< kernel variance, applied to the regressions' variances (the kernels themselves have unit variance)
+  RAI_PARAM("BayesOpt/", uint, threads, 0) ///< threads for the local optimizations of the acquisition function (0: hardware concurrency, 1: serial)
 
   //lengthScale is always relative to hi-lo
   BayesOpt(const ScalarFunction& f, const arr& bounds_lo, const arr& bounds_hi, double init_lengthScale=1., double prior_var=1., rai::OptOptions o=NOOPT);
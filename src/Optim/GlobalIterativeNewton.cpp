@@ -8,6 +8,8 @@
 
 #include "GlobalIterativeNewton.h"
 
+#include <thread>
+
 bool useNewton=true;
 
 GlobalIterativeNewton::GlobalIterativeNewton(const ScalarFunction& f, const arr& bounds_lo, const arr& bounds_up, rai::OptOptions opt)
@@ -74,9 +76,42 @@ void GlobalIterativeNewton::step() {
 }
 
 void GlobalIterativeNewton::run(uint maxIt) {
-  for(uint i=0; i<maxIt; i++) {
-    step();
+  if(!maxIt) return;
+  arr X0 = rand(maxIt, bounds_lo.N);
+  for(uint i=0; i<maxIt; i++) X0[i] = bounds_lo + (bounds_hi-bounds_lo) % X0[i];
+  addRunsFrom(X0);
+}
+
+void GlobalIterativeNewton::addRunsFrom(const arr& X0) {
+  if(!useNewton || X0.d0<2) {
+    for(uint i=0; i<X0.d0; i++) addRunFrom(*this, X0[i]);
+    return;
   }
+
+  //-- local optimizations (in parallel if threads!=1), each with its own OptNewton (f then needs to be thread safe)
+  arr X = X0, fX(X0.d0);
+  uint nThreads = threads ? threads : std::thread::hardware_concurrency();
+  nThreads = rai::MIN(rai::MAX(nThreads, 1u), X.d0);
+  auto work = [this, &X, &fX, nThreads](uint t) {
+    for(uint i=t; i<X.d0; i+=nThreads) {
+      arr x = X[i];
+      boundClip(x, bounds_lo, bounds_hi);
+      OptNewton local(x, newton.f, newton.options);
+      local.setBounds(bounds_lo, bounds_hi);
+      local.run();
+      X[i] = x;
+      fX(i) = local.fx;
+    }
+  };
+  if(nThreads==1) work(0);
+  else {
+    std::vector<std::thread> workers;
+    for(uint t=0; t<nThreads; t++) workers.emplace_back(work, t);
+    for(std::thread& w:workers) w.join();
+  }
+
+  //-- merge in order (deterministic)
+  for(uint i=0; i<X.d0; i++) addRun(*this, X[i], fX(i), 3.*newton.options.stopTolerance);
 }
 
 void GlobalIterativeNewton::report() {
@@ -94,5 +129,5 @@ void GlobalIterativeNewton::reOptimizeAllPoints() {
   X.reshape(localMinima.N, X.N/localMinima.N);
   rndGauss(X, .01, true);
   localMinima.clear();
-  for(uint i=0; i<X.d0; i++) addRunFrom(*this, X[i]);
+  addRunsFrom(X);
 }
@@ -20,6 +20,7 @@ struct GlobalIterativeNewton {
   struct LocalMinimum { arr x; double fx; uint hits; };
   rai::Array<LocalMinimum> localMinima;
   LocalMinimum* best;
+  uint threads=1; ///< number of threads for the local (Newton) optimizations; 0: hardware concurrency
 
   GlobalIterativeNewton(const ScalarFunction& f, const arr& bounds_lo, const arr& bounds_up, rai::OptOptions o=NOOPT);
   ~GlobalIterativeNewton();
@@ -29,4 +30,5 @@ struct GlobalIterativeNewton {
   void report();
 
   void reOptimizeAllPoints();
+  void addRunsFrom(const arr& X0); ///< local optimizations from each row of X0 (in parallel), then merged into localMinima
 };
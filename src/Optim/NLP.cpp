@@ -7,6 +7,7 @@
     --------------------------------------------------------------  */
 
 #include "NLP.h"
+#include "NLP_Trace.h"
 #include "lagrangian.h"
 #include "utils.h"
 
@@ -355,12 +356,35 @@ void Conv_FactoredNLP_BandedNLP::evaluate(arr& phi, arr& J, const arr& x) {
 void NLP_Traced::evaluate(arr& phi, arr& J, const arr& x) {
   evals++;
   P->evaluate(phi, J, x);
+  if(stream) {
+    arr costs;
+    if(trace_costs) costs = summarizeErrors(phi, featureTypes);
+    stream->record(evals, (trace_x?x:NoArr), (trace_costs?costs:NoArr), (trace_phi?phi:NoArr), (trace_J?J:NoArr));
+    return;
+  }
   if(trace_x) { xTrace.append(x); xTrace.reshape(-1, x.N); }
   if(trace_costs) { costTrace.append(summarizeErrors(phi, featureTypes)); costTrace.reshape(-1, 3);  }
   if(trace_phi && !!phi) { phiTrace.append(phi);  phiTrace.reshape(-1, phi.N); }
   if(trace_J && !!J) { JTrace.append(J);  JTrace.reshape(-1, phi.N, x.N); }
 }
 
+void NLP_Traced::setStream(const char* filename, uint ringSize) {
+  stream.reset(); //flush and close a previous stream first
+  stream = make_shared<NLP_TraceStream>(filename, ringSize);
+  streamSynced=-1;
+}
+
+void NLP_Traced::syncTrace() {
+  if(!stream || streamSynced==int(stream->records)) return;
+  stream->flush();
+  NLP_TraceReader R(stream->filename);
+  xTrace = R.x;
+  costTrace = R.costs;
+  phiTrace = R.phi;
+  JTrace = R.J;
+  streamSynced = stream->records;
+}
+
 void NLP_Traced::report(std::ostream& os, int verbose, const char* msg) {
   os <<"TRACE: #evals: " <<evals;
   if(costTrace.N) os <<" costs: " <<costTrace[-1];
@@ -421,6 +445,7 @@ void NLP_Viewer::display(double mu) {
   if(!T) {
     cmd <<splot <<";";
   } else {
+    T->syncTrace();
     T->report(cout, 0);
     if(false && T->costTrace.N) {
       FILE("z.trace") <<catCol(T->xTrace, T->costTrace.col(0)).modRaw();
@@ -439,6 +464,7 @@ void NLP_Viewer::display(double mu) {
 
 void NLP_Viewer::plotCostTrace() {
   CHECK(T, "");
+  T->syncTrace();
   FILE("z.trace") <<T->costTrace.modRaw();
   rai::String cmd;
   cmd <<"reset; set xlabel 'evals'; set ylabel 'objectives'; set style data lines;";
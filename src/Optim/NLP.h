@@ -63,6 +63,9 @@ public:
   // optional evaluation of Hessian of all scalar objectives
   virtual void getFHessian(arr& H, const arr& x) { H.clear(); } //the Hessian of the sum of all f-features (or Hessian in addition to the Gauss-Newton Hessian of all other features)
 
+  // optional: solver hint that the Jacobian rows of flagged features are not needed (they may be left zero) [default: ignore]; an empty array clears the hint
+  virtual void setLazyFeatures(const boolA& lazy) {}
+
   // optional: return some info on the problem and the last evaluation, potentially with display
   virtual void report(ostream& os, int verbose, const char* msg=0);
 
@@ -116,6 +119,8 @@ struct NLP_Traced : NLP {
   bool trace_costs=true;
   bool trace_phi=false;
   bool trace_J=false;
+  shared_ptr<struct NLP_TraceStream> stream; ///< if set, evaluations are streamed to file instead of appended to the arrays above
+  int streamSynced=-1; ///< stream records at the last syncTrace
 
   NLP_Traced(const shared_ptr<NLP>& P) : P(P) {
     copySignature(*P);
@@ -131,12 +136,15 @@ struct NLP_Traced : NLP {
     phiTrace.clear();
     JTrace.clear();
   }
+  void setStream(const char* filename, uint ringSize=0); ///< stream the trace to a binary file (ringSize>0: keep only the last evaluations)
+  void syncTrace(); ///< if streaming: flush and replay the file into the trace arrays (only if there are new records)
 
   virtual void evaluate(arr& phi, arr& J, const arr& x);
 
   //trivial
   virtual arr  getInitializationSample(const arr& previousOptima= {}) { return P->getInitializationSample(previousOptima); }
   virtual void getFHessian(arr& H, const arr& x) { P->getFHessian(H, x); }
+  virtual void setLazyFeatures(const boolA& lazy) { P->setLazyFeatures(lazy); }
 
   virtual void report(std::ostream &os, int verbose, const char* msg=0);
 };
@@ -54,6 +54,10 @@ std::shared_ptr<SolverReturn> NLP_Solver::solve(int resampleInitialization){
   if(solverID==NLPS_newton){
     Conv_NLP_ScalarProblem P1(P);
     OptNewton newton(x, P1, opt);
+    if(opt.matrixFree){
+      P1.hessianFactor=true;
+      newton.setMatrixFree();
+    }
     newton.run();
     ret->f = newton.fx;
   }
@@ -61,6 +65,16 @@ std::shared_ptr<SolverReturn> NLP_Solver::solve(int resampleInitialization){
     Conv_NLP_ScalarProblem P1(P);
     OptGrad(x, P1).run();
   }
+  else if(solverID==NLPS_LBFGS){
+    Conv_NLP_ScalarProblem P1(P);
+    OptNewton lbfgs(x, P1, opt);
+    lbfgs.setLBFGS(opt.lbfgsMemory>0 ? opt.lbfgsMemory : 10);
+    arr lo, up;
+    P->getBounds(lo, up);
+    if(lo.N || up.N) lbfgs.setBounds(lo, up);
+    lbfgs.run();
+    ret->f = lbfgs.fx;
+  }
   else if(solverID==NLPS_rprop){
     Conv_NLP_ScalarProblem P1(P);
     Rprop().loop(x, P1, opt.stopTolerance, opt.initStep, opt.stopEvals, opt.verbose);
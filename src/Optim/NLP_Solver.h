@@ -43,16 +43,17 @@ struct NLP_Solver : NonCopyable {
   NLP_Solver& setInitialization(const arr& _x){ x=_x; return *this; }
   NLP_Solver& setWarmstart(const arr& _x, const arr& _dual){ x=_x; dual=_dual; return *this; }
   NLP_Solver& setTracing(bool trace_x, bool trace_costs, bool trace_phi, bool trace_J){ P->setTracing(trace_x, trace_costs, trace_phi, trace_J); return *this; }
+  NLP_Solver& setTraceStream(const char* filename, uint ringSize=0){ P->setStream(filename, ringSize); return *this; }
   NLP_Solver& clear(){ P.reset(); optCon.reset(); ret.reset(); x.clear(); dual.clear(); return *this; }
 
   std::shared_ptr<SolverReturn> solve(int resampleInitialization=-1); ///< -1: only when not yet set
   std::shared_ptr<SolverReturn> solveStepping(int resampleInitialization=-1); ///< -1: only when not yet set
   bool step();
 
-  arr getTrace_x(){ return P->xTrace; }
-  arr getTrace_costs(){ return P->costTrace; }
-  arr getTrace_phi(){ return P->phiTrace; }
-  arr getTrace_J(){ return P->JTrace; }
+  arr getTrace_x(){ P->syncTrace(); return P->xTrace; }
+  arr getTrace_costs(){ P->syncTrace(); return P->costTrace; }
+  arr getTrace_phi(){ P->syncTrace(); return P->phiTrace; }
+  arr getTrace_J(){ P->syncTrace(); return P->JTrace; }
   arr getTrace_lambda();
   arr getTrace_evals();
   rai::Graph reportLangrangeGradients(const StringA& featureNames);
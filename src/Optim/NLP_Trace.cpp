@@ -0,0 +1,227 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2020 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#include "NLP_Trace.h"
+
+#include <sstream>
+
+//===========================================================================
+
+static const char* traceMagic = "NLPTRACE";
+static const uint32_t traceVersion = 1;
+
+template<class T> static void put(std::vector<char>& buf, const T& x) {
+  const char* p = (const char*)&x;
+  buf.insert(buf.end(), p, p+sizeof(T));
+}
+
+static void putDoubles(std::vector<char>& buf, const double* p, uint n) {
+  buf.insert(buf.end(), (const char*)p, (const char*)(p+n));
+}
+
+static void putArr(std::vector<char>& buf, const arr& x) {
+  put<uint32_t>(buf, x.N);
+  putDoubles(buf, x.p, x.N);
+}
+
+static void putJacobian(std::vector<char>& buf, const arr& J) {
+  if(!rai::isSpecial(J)) {
+    put<uint8_t>(buf, 0);
+    put<uint32_t>(buf, J.d0);
+    put<uint32_t>(buf, J.d1);
+    putDoubles(buf, J.p, J.N);
+  } else if(rai::isSparseMatrix(J)) {
+    const rai::SparseMatrix& S = J.sparse();
+    put<uint8_t>(buf, 1);
+    put<uint32_t>(buf, J.d0);
+    put<uint32_t>(buf, J.d1);
+    put<uint32_t>(buf, S.elems.d0);
+    for(uint k=0; k<S.elems.d0; k++) {
+      put<uint32_t>(buf, S.elems.p[2*k]);
+      put<uint32_t>(buf, S.elems.p[2*k+1]);
+      put<double>(buf, J.p[k]);
+    }
+  } else if(rai::isRowShifted(J)) {
+    const rai::RowShifted& S = J.rowShifted();
+    uint nnz=0;
+    for(uint i=0; i<J.d0; i++) nnz += S.rowLen.p[i];
+    put<uint8_t>(buf, 1);
+    put<uint32_t>(buf, J.d0);
+    put<uint32_t>(buf, J.d1);
+    put<uint32_t>(buf, nnz);
+    for(uint i=0; i<J.d0; i++) {
+      double* Zp = J.p + i*S.rowSize;
+      for(uint j=0; j<S.rowLen.p[i]; j++) {
+        put<uint32_t>(buf, i);
+        put<uint32_t>(buf, S.rowShift.p[i]+j);
+        put<double>(buf, Zp[j]);
+      }
+    }
+  } else NIY;
+}
+
+static void writeHeader(std::ostream& os) {
+  os.write(traceMagic, 8);
+  os.write((const char*)&traceVersion, sizeof(traceVersion));
+}
+
+//===========================================================================
+
+NLP_TraceStream::NLP_TraceStream(const char* _filename, uint _ringSize, uint _chunkSize)
+  : filename(_filename), ringSize(_ringSize), chunkSize(_chunkSize) {
+  if(!ringSize) {
+    fil.open(filename, std::ios::binary | std::ios::trunc);
+    CHECK(fil.good(), "could not open trace file '" <<filename <<"'");
+    writeHeader(fil);
+    writer = std::thread(&NLP_TraceStream::loop, this);
+  }
+}
+
+NLP_TraceStream::~NLP_TraceStream() {
+  flush();
+  if(writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop=true;
+    }
+    cond.notify_all();
+    writer.join();
+  }
+}
+
+void NLP_TraceStream::record(uint eval, const arr& x, const arr& costs, const arr& phi, const arr& J) {
+  records++;
+  std::vector<char> rec;
+  put<uint32_t>(rec, 0); //placeholder for the byte count
+  put<uint32_t>(rec, eval);
+  uint8_t mask = (!!x?1:0) | (!!costs?2:0) | (!!phi?4:0) | (!!J?8:0);
+  put<uint8_t>(rec, mask);
+  if(!!x) putArr(rec, x);
+  if(!!costs) putArr(rec, costs);
+  if(!!phi) putArr(rec, phi);
+  if(!!J) putJacobian(rec, J);
+  uint32_t bytes = rec.size()-sizeof(uint32_t);
+  memmove(rec.data(), &bytes, sizeof(uint32_t));
+
+  if(ringSize) {
+    ring.push_back(std::move(rec));
+    while(ring.size()>ringSize) ring.pop_front();
+    return;
+  }
+
+  chunk.insert(chunk.end(), rec.begin(), rec.end());
+  if(chunk.size()>=chunkSize) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back(std::move(chunk));
+    }
+    chunk.clear();
+    cond.notify_all();
+  }
+}
+
+void NLP_TraceStream::flush() {
+  if(ringSize) {
+    if(ringFlushed==int(records)) return; //file is up to date
+    ringFlushed=records;
+    std::ofstream os(filename, std::ios::binary | std::ios::trunc);
+    CHECK(os.good(), "could not open trace file '" <<filename <<"'");
+    writeHeader(os);
+    for(const std::vector<char>& rec:ring) os.write(rec.data(), rec.size());
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  if(chunk.size()) {
+    queue.push_back(std::move(chunk));
+    chunk.clear();
+    cond.notify_all();
+  }
+  cond.wait(lock, [this]() { return queue.empty() && !writing; });
+  fil.flush();
+}
+
+void NLP_TraceStream::loop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  for(;;) {
+    cond.wait(lock, [this]() { return stop || !queue.empty(); });
+    if(queue.empty()) break; //stop and nothing left
+    std::vector<char> buf = std::move(queue.front());
+    queue.pop_front();
+    writing=true;
+    lock.unlock();
+    fil.write(buf.data(), buf.size());
+    lock.lock();
+    writing=false;
+    cond.notify_all();
+  }
+}
+
+//===========================================================================
+
+template<class T> static T get(std::istream& is) {
+  T x;
+  is.read((char*)&x, sizeof(T));
+  return x;
+}
+
+static arr getArr(std::istream& is) {
+  arr x(get<uint32_t>(is));
+  is.read((char*)x.p, x.N*sizeof(double));
+  return x;
+}
+
+NLP_TraceReader::NLP_TraceReader(const char* filename) {
+  std::ifstream is(filename, std::ios::binary);
+  CHECK(is.good(), "could not open trace file '" <<filename <<"'");
+  char magic[8];
+  is.read(magic, 8);
+  CHECK(is.good() && !strncmp(magic, traceMagic, 8), "'" <<filename <<"' is not an NLP trace file");
+  uint32_t version = get<uint32_t>(is);
+  CHECK_EQ(version, traceVersion, "unknown trace file version");
+
+  for(;;) {
+    //read the whole record first, so that a truncated last record leaves all arrays consistent
+    uint32_t bytes = get<uint32_t>(is);
+    if(!is.good()) break;
+    std::string buf(bytes, 0);
+    is.read(&buf[0], bytes);
+    if(is.gcount()!=std::streamsize(bytes)) { LOG(-1) <<"trace file '" <<filename <<"' is truncated"; break; }
+    std::istringstream rec(buf);
+
+    uint eval = get<uint32_t>(rec);
+    uint8_t mask = get<uint8_t>(rec);
+    arr xi, ci, pi, Ji;
+    if(mask&1) xi = getArr(rec);
+    if(mask&2) ci = getArr(rec);
+    if(mask&4) pi = getArr(rec);
+    if(mask&8) {
+      uint8_t kind = get<uint8_t>(rec);
+      uint d0 = get<uint32_t>(rec);
+      uint d1 = get<uint32_t>(rec);
+      Ji.resize(d0, d1);
+      if(kind==0) {
+        rec.read((char*)Ji.p, Ji.N*sizeof(double));
+      } else {
+        Ji.setZero();
+        uint nnz = get<uint32_t>(rec);
+        for(uint k=0; k<nnz; k++) {
+          uint i = get<uint32_t>(rec);
+          uint j = get<uint32_t>(rec);
+          Ji(i, j) += get<double>(rec);
+        }
+      }
+    }
+    CHECK(rec.good() && rec.tellg()==std::streampos(bytes), "corrupt record in trace file '" <<filename <<"'");
+
+    evals.append(eval);
+    if(mask&1) { x.append(xi); x.reshape(-1, xi.N); }
+    if(mask&2) { costs.append(ci); costs.reshape(-1, ci.N); }
+    if(mask&4) { phi.append(pi); phi.reshape(-1, pi.N); }
+    if(mask&8) { J.append(Ji); J.reshape(-1, Ji.d0, Ji.d1); }
+  }
+}
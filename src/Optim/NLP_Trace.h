@@ -0,0 +1,61 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2020 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#pragma once
+
+#include "NLP.h"
+#include "../Core/util.h"
+
+#include <deque>
+#include <thread>
+#include <condition_variable>
+
+//===========================================================================
+
+/** Streams NLP evaluations (x, costs, phi, J) into a compact binary file instead of growing in-memory arrays.
+ *  Records are encoded into chunks, which a background thread appends to the file. Sparse and row-shifted
+ *  Jacobians are stored as triplets. With ringSize>0 only the last ringSize evaluations are kept in memory
+ *  and written on flush (post-mortem mode without any file IO during the solve).
+ *
+ *  File format: "NLPTRACE" uint32(version), then records:
+ *    uint32(bytes) uint32(eval) uint8(mask: 1=x 2=costs 4=phi 8=J)
+ *    [x, costs, phi: uint32(n) double(n)]
+ *    [J: uint8(0=dense, 1=triplets) uint32(d0) uint32(d1) then double(d0*d1), or uint32(nnz) nnz*(uint32 uint32 double)] */
+struct NLP_TraceStream : NonCopyable {
+  rai::String filename;
+  uint ringSize;   ///< if >0: ring buffer of the last ringSize evaluations, written only on flush
+  uint chunkSize;  ///< bytes collected before a chunk is handed to the writer thread
+  uint records=0;  ///< number of evaluations recorded so far
+
+  NLP_TraceStream(const char* _filename, uint _ringSize=0, uint _chunkSize=1<<20);
+  ~NLP_TraceStream();
+
+  void record(uint eval, const arr& x, const arr& costs, const arr& phi, const arr& J); ///< pass NoArr for untraced quantities
+  void flush(); ///< blocks until all records are in the file
+
+private:
+  std::vector<char> chunk;
+  std::ofstream fil;
+  std::deque<std::vector<char>> queue, ring;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::thread writer;
+  bool stop=false, writing=false;
+  int ringFlushed=-1; ///< records at the last ring flush
+  void loop();
+};
+
+//===========================================================================
+
+/// reads a trace written by NLP_TraceStream into the same layout as the NLP_Traced arrays
+struct NLP_TraceReader {
+  uintA evals;
+  arr x, costs, phi, J;
+
+  NLP_TraceReader(const char* filename);
+};
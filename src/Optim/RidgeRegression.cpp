@@ -128,37 +128,77 @@ DefaultKernelFunction defaultKernelFunction;
 
 //===========================================================================
 
-KernelRidgeRegression::KernelRidgeRegression(const arr& X, const arr& y, KernelFunction& kernel, double lambda, double mu)
-  :X(X), mu(mu), kernel(kernel) {
+/// K(i,j) = kernel.k(A[i], B[j]), with a contiguous-loop fast path for the Gauss DefaultKernelFunction
+static void kernelMatrix(arr& K, KernelFunction& kernel, const arr& A, const arr& B) {
+  uint m=A.d0, n=B.d0, d=A.d1;
+  K.resize(m, n);
+  DefaultKernelFunction* dk = dynamic_cast<DefaultKernelFunction*>(&kernel);
+  if(dk && dk->type==DefaultKernelFunction::Gauss && B.d1==d) {
+    double c=-1./dk->hyperParam1.scalar(), pv=dk->hyperParam2.scalar();
+    for(uint i=0; i<m; i++) {
+      const double* a=A.p+i*d;
+      double* Ki=K.p+i*n;
+      for(uint j=0; j<n; j++) {
+        const double* b=B.p+j*d;
+        double dist=0.;
+        for(uint k=0; k<d; k++) { double t=a[k]-b[k]; dist+=t*t; }
+        Ki[j]=c*dist;
+      }
+      for(uint j=0; j<n; j++) Ki[j] = pv*::exp(Ki[j]);
+    }
+    return;
+  }
+  for(uint i=0; i<m; i++) for(uint j=0; j<n; j++) K.p[i*n+j] = kernel.k(A[i], B[j]);
+}
+
+KernelRidgeRegression::KernelRidgeRegression(const arr& _X, const arr& _y, KernelFunction& kernel, double _lambda, double mu)
+  : lambda(_lambda), mu(mu), kernel(kernel) {
   if(lambda<0.) lambda = rai::getParameter<double>("lambda", 1e-10);
-  uint n=X.d0;
 
-  //-- compute kernel matrix
-  arr kernelMatrix(n, n);
-  for(uint i=0; i<n; i++) for(uint j=0; j<i; j++) {
-      kernelMatrix(i, j) = kernelMatrix(j, i) = kernel.k(X[i], X[j]);
-    }
-  for(uint i=0; i<n; i++) kernelMatrix(i, i) = kernel.k(X[i], X[i]);
+  //-- build the Cholesky factor of the kernel matrix row by row
+  X.resize(0, _X.d1);
+  for(uint i=0; i<_X.d0; i++) append(_X[i], _y(i));
+}
 
-  kernelMatrix_lambda=kernelMatrix;
-  for(uint i=0; i<n; i++) kernelMatrix_lambda(i, i) += lambda;
+void KernelRidgeRegression::append(const arr& x, double _y) {
+  uint n=X.d0;
+  if(!n) X.resize(0, x.N);
+  arr kappa, x1=x;
+  x1.reshape(1, x.N);
+  if(n) kernelMatrix(kappa, kernel, x1, X);
+  kappa.reshape(n);
+  cholesky_appendRow(U, kappa, kernel.k(x, x)+lambda);
+  X.append(x);
+  X.reshape(n+1, x.N);
+  y.append(_y);
+  updateAlpha();
+}
 
-  //-- compute alpha
-  alpha = lapack_Ainv_b_sym(kernelMatrix_lambda, y-mu);
+void KernelRidgeRegression::setMu(double _mu) {
+  mu = _mu;
+  updateAlpha();
+}
+
+void KernelRidgeRegression::updateAlpha() {
+  if(!y.N) { alpha.clear(); sigmaSqr=0.; return; }
+  alpha = y-mu;
+  solve_upperTriangular(alpha, U, true);
+  solve_upperTriangular(alpha, U);
 
-  sigmaSqr = sumOfSqr(kernelMatrix*alpha-y)/double(y.N/*-beta.N*/); //beta.N are the degrees of freedom that we substract (=1 for const model)
+  //kernelMatrix*alpha = y-mu-lambda*alpha
+  sigmaSqr = sumOfSqr(mu+lambda*alpha)/double(y.N/*-beta.N*/); //beta.N are the degrees of freedom that we substract (=1 for const model)
 }
 
 arr KernelRidgeRegression::evaluate(const arr& Z, arr& bayesSigma2) {
-  arr kappa(Z.d0, X.d0);
-  for(uint i=0; i<Z.d0; i++) for(uint j=0; j<X.d0; j++) kappa(i, j) = kernel.k(Z[i], X[j]);
+  arr kappa;
+  kernelMatrix(kappa, kernel, Z, X);
   if(!!bayesSigma2) {
-    if(!invKernelMatrix_lambda.N) invKernelMatrix_lambda = inverse_SymPosDef(kernelMatrix_lambda);
-    bayesSigma2.resize(Z.d0);
-    for(uint i=0; i<Z.d0; i++) {
-      bayesSigma2(i) = kernel.k(Z[i], Z[i]);
-      bayesSigma2(i) -= scalarProduct(kappa[i], invKernelMatrix_lambda*kappa[i]);
-    }
+    //V = U^{-T} kappa^T for all queries at once
+    arr V = ~kappa;
+    solve_upperTriangular(V, U, true);
+    bayesSigma2.resize(Z.d0).setZero();
+    for(uint j=0; j<V.d0; j++) { const double* Vj=V.p+j*Z.d0; for(uint i=0; i<Z.d0; i++) bayesSigma2.p[i] += Vj[i]*Vj[i]; }
+    for(uint i=0; i<Z.d0; i++) bayesSigma2(i) = priorVar*(kernel.k(Z[i], Z[i]) - bayesSigma2(i));
   }
   return mu + kappa * alpha;
 }
@@ -180,19 +220,21 @@ double KernelRidgeRegression::evaluate(const arr& x, arr& g, arr& H, double plus
   }
 
   if(plusSigma) {
-//    arr gx, Hx;
-//    fx += plusSigma * ;
-////    if(!!g) g += plusSigma*(gx + g2);
-////    if(!!H) H += plusSigma*(gx + g2);
-
-    if(!invKernelMatrix_lambda.N) invKernelMatrix_lambda = inverse_SymPosDef(kernelMatrix_lambda);
-
-    arr Kinv_k = invKernelMatrix_lambda*kappa;
+    //K^{-1} via the Cholesky factor: v = U^{-T} kappa, Kinv_k = U^{-1} v
+    arr v = kappa;
+    solve_upperTriangular(v, U, true);
+    arr Kinv_k = v;
+    solve_upperTriangular(Kinv_k, U);
     arr J_Kinv_k = ~Jkappa*Kinv_k;
-    double k_Kinv_k = kernel.k(x, x) - scalarProduct(kappa, Kinv_k);
-    fx += plusSigma * ::sqrt(k_Kinv_k);
-    if(!!g) g -= (plusSigma/sqrt(k_Kinv_k)) * J_Kinv_k;
-    if(!!H) H -= (plusSigma/(k_Kinv_k*sqrt(k_Kinv_k))) * (J_Kinv_k^J_Kinv_k) + (plusSigma/sqrt(k_Kinv_k)) * (~Jkappa*invKernelMatrix_lambda*Jkappa + ~Kinv_k*Hkappa);
+    double k_Kinv_k = kernel.k(x, x) - sumOfSqr(v);
+    double s = ::sqrt(priorVar);
+    fx += plusSigma * s * ::sqrt(k_Kinv_k);
+    if(!!g) g -= (s*plusSigma/sqrt(k_Kinv_k)) * J_Kinv_k;
+    if(!!H) {
+      arr VJ = Jkappa;
+      solve_upperTriangular(VJ, U, true);
+      H -= (s*plusSigma/(k_Kinv_k*sqrt(k_Kinv_k))) * (J_Kinv_k^J_Kinv_k) + (s*plusSigma/sqrt(k_Kinv_k)) * (~VJ*VJ + ~Kinv_k*Hkappa);
+    }
   }
 
   return fx;
@@ -45,17 +45,24 @@ extern DefaultKernelFunction defaultKernelFunction;
 
 struct KernelRidgeRegression {
   arr X; ///< stored data (to compute kappa for queries)
-  arr kernelMatrix_lambda; ///< X X^T + lambda I
-  arr invKernelMatrix_lambda; ///< (X X^T + lambda I)^-1
-  arr alpha; ///< (X X^T + lambda I)^-1 y
+  arr y; ///< stored targets
+  arr U; ///< upper Cholesky factor: X X^T + lambda I = U^T U
+  arr alpha; ///< (X X^T + lambda I)^-1 (y-mu)
+  double lambda;
   double sigmaSqr; ///< mean squared error on training data; estimate of noise
   double mu; ///< fixed global bias (default=0)
+  double priorVar=1.; ///< multiplies the variances -- same as scaling both the kernel and lambda (which leaves the mean unchanged); lambda itself is not changed, no refactoring needed
   KernelFunction& kernel;
   KernelRidgeRegression(const arr& X, const arr& y, KernelFunction& kernel=defaultKernelFunction, double lambda=-1, double mu=0.);
-  arr evaluate(const arr& X, arr& bayesSigma2=NoArr); ///< returns f(x) and \s^2(x) for a set of points X
+  void append(const arr& x, double y); ///< add a datum: rank-one extension of the Cholesky factor, O(n^2)
+  void setMu(double _mu); ///< change the bias, O(n^2)
+  arr evaluate(const arr& X, arr& bayesSigma2=NoArr); ///< returns f(x) and \s^2(x) for a set of points X (batched)
 
   double evaluate(const arr& x, arr& df_x, arr& H, double plusSigma, bool onlySigma); ///< returns f(x) + coeff*\sigma(x) and its gradient and Hessian
   ScalarFunction getF(double plusSigma);
+
+private:
+  void updateAlpha();
 };
 
 struct KernelLogisticRegression {
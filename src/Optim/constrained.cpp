@@ -73,13 +73,19 @@ OptConstrained::OptConstrained(arr& _x, arr& _dual, const shared_ptr<NLP>& P, ra
     if(lo.N || up.N) newton.setBounds(lo, up);
   }
 
+  if(opt.lbfgsMemory>0) newton.setLBFGS(opt.lbfgsMemory);
+  else if(opt.matrixFree){
+    L.hessianFactor=true;
+    newton.setMatrixFree();
+  }
+
   if(opt.constrainedMethod==rai::logBarrier){
     L.useLB=true;
   }
 
   newton.options.verbose = rai::MAX(opt.verbose-1, 0);
 
-  if(opt.verbose>0) cout <<"====nlp==== method:" <<MethodName[opt.constrainedMethod] <<" bounded: " <<(opt.boundedNewton?"yes":"no") <<endl;
+  if(opt.verbose>0) cout <<"====nlp==== method:" <<MethodName[opt.constrainedMethod] <<" bounded: " <<(opt.boundedNewton?"yes":"no") <<(opt.lbfgsMemory>0?" inner: L-BFGS":"") <<endl;
 
   if(logFile) {
     (*logFile) <<"{ optConstraint: " <<its <<", mu: " <<L.mu <<", nu: " <<L.mu <<", L_x: " <<newton.fx <<", errors: ["<<L.get_costs() <<", " <<L.get_sumOfGviolations() <<", " <<L.get_sumOfHviolations() <<"], lambda: " <<L.lambda <<" }," <<endl;
@@ -202,7 +208,11 @@ bool OptConstrained::ministep(){
 
   //upate Lagrange parameters
   double L_x_before = newton.fx;
-  L.autoUpdate(opt, &newton.fx, newton.gx, newton.Hx);
+  {
+    rai::ProfileScope prof("OptConstrained", "dualUpdate");
+    L.autoUpdate(opt, &newton.fx, newton.gx, (newton.lbfgsMemory?NoArr:newton.Hx));
+  }
+  if(newton.lbfgsMemory) newton.setLBFGS(newton.lbfgsMemory); //the Lagrangian changed: drop the curvature pairs
   if(opt.maxLambda>0.){
     clip(L.lambda, -opt.maxLambda, opt.maxLambda);
   }
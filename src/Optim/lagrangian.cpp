@@ -38,6 +38,9 @@ LagrangianProblem::LagrangianProblem(const shared_ptr<NLP>& P, const rai::OptOpt
   mu=opt.muInit;
   muLB=opt.muLBInit;
 
+  lazyMargin=opt.lazyIneqMargin;
+  if(opt.lazyIneqRecheck>0) lazyRecheck=opt.lazyIneqRecheck;
+
   if(!!lambdaInit) lambda = lambdaInit;
 
   featureTypes.clear();
@@ -56,14 +59,38 @@ LagrangianProblem::LagrangianProblem(const shared_ptr<NLP>& P, const rai::OptOpt
 
 }
 
-void LagrangianProblem::evaluate(arr& phi, arr& J, const arr& _x) {
-  //-- evaluate constrained problem and buffer
-  if(_x!=x) {
-    x=_x;
+void LagrangianProblem::evaluateP(const arr& _x) {
+  if(_x==x) return; //we evaluated this before - use buffered values; the meta F is still recomputed as (dual) parameters might have changed
+  x=_x;
+  rai::ProfileScope prof("Lagrangian", "evaluateP");
+
+  //-- hint P which inequalities are far from active (based on the previous evaluation)
+  bool anyLazy=false;
+  if(lazyMargin>=0. && !useLB && phi_x.N==P->featureTypes.N && (lazyCount++)%lazyRecheck) {
+    lazy.resize(phi_x.N) = false;
+    for(uint i=0; i<phi_x.N; i++) {
+      if(P->featureTypes.p[i]==OT_ineq && phi_x.p[i]<-lazyMargin && !(lambda.N && lambda.p[i]>0.)) { lazy.p[i]=true; anyLazy=true; }
+    }
+  }
+
+  if(!anyLazy) {
+    P->evaluate(phi_x, J_x, x);
+  } else {
+    P->setLazyFeatures(lazy);
     P->evaluate(phi_x, J_x, x);
-    P->getFHessian(H_x, x);
-  } else { //we evaluated this before - use buffered values; the meta F is still recomputed as (dual) parameters might have changed
+    P->setLazyFeatures({});
+    //a lazy inequality became active -> its Jacobian row is missing -> re-evaluate fully
+    for(uint i=0; i<phi_x.N; i++) if(lazy.p[i] && phi_x.p[i]>0.) {
+      P->evaluate(phi_x, J_x, x);
+      break;
+    }
   }
+  P->getFHessian(H_x, x);
+}
+
+void LagrangianProblem::evaluate(arr& phi, arr& J, const arr& _x) {
+  //-- evaluate constrained problem and buffer
+  evaluateP(_x);
 
   CHECK(x.N, "zero-dim optimization variables!");
   CHECK_EQ(phi_x.N, J_x.d0, "Jacobian size inconsistent");
@@ -139,12 +166,7 @@ double LagrangianProblem::lagrangian(arr& dL, arr& HL, const arr& _x) {
   return eval_scalar(dL, HL, _x);
 #else
   //-- evaluate constrained problem and buffer
-  if(_x!=x) {
-    x=_x;
-    P->evaluate(phi_x, J_x, x);
-    P->getFHessian(H_x, x);
-  } else { //we evaluated this before - use buffered values; the meta F is still recomputed as (dual) parameters might have changed
-  }
+  evaluateP(_x);
 
   CHECK(x.N, "zero-dim optimization variables!");
   if(!isSparseMatrix(J_x)) {
@@ -195,6 +217,7 @@ double LagrangianProblem::lagrangian(arr& dL, arr& HL, const arr& _x) {
   }
 
   if(!!HL) { //L hessian: Most terms are of the form   "J^T  diag(coeffs)  J"
+    rai::ProfileScope prof("Lagrangian", "hessian");
     arr coeff=zeros(phi_x.N);
     for(uint i=0; i<phi_x.N; i++) {
       ObjectiveType ot = P->featureTypes.p[i];
@@ -216,13 +239,18 @@ double LagrangianProblem::lagrangian(arr& dL, arr& HL, const arr& _x) {
       arr sqrtCoeff = sqrt(coeff);
       tmp.rowShifted().rowWiseMult(sqrtCoeff);
     }
-    HL = comp_At_A(tmp); //Gauss-Newton type!
+    if(hessianFactor) { //matrix-free: only return the factor
+      CHECK(!H_x.N, "the matrix-free Gauss-Newton factor can't represent explicit f-Hessians");
+      HL = tmp;
+    } else {
+      HL = comp_At_A(tmp); //Gauss-Newton type!
+
+      if(H_x.N) { //For f-terms, the Hessian must be given explicitly, and is not \propto J^T J
+        HL += H_x;
+      }
 
-    if(H_x.N) { //For f-terms, the Hessian must be given explicitly, and is not \propto J^T J
-      HL += H_x;
+      if(!HL.special) HL.reshape(x.N, x.N);
     }
-
-    if(!HL.special) HL.reshape(x.N, x.N);
   }
 
   if(logFile)(*logFile) <<"{ lagrangianQuery: True, errors: [" <<get_costs() <<", " <<get_sumOfGviolations() <<", " <<get_sumOfHviolations() <<"] }," <<endl;
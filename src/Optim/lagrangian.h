@@ -27,6 +27,13 @@ struct LagrangianProblem : ScalarFunction, NLP {
   double mu;         ///< penalty parameter for inequalities g and equalities h
   arr lambda;        ///< lagrange multipliers for inequalities g and equalities h
   bool useLB;        ///< interpret ALL ineq as LG instead of penalty
+  bool hessianFactor=false; ///< return the Gauss-Newton factor R (with HL=R^T R) instead of HL (for matrix-free Newton)
+
+  //-- lazy Jacobians: inequalities far from active (g<-lazyMargin, lambda=0) are hinted to P, which may skip their Jacobian rows
+  double lazyMargin=-1.; ///< <0 disables lazy evaluation
+  uint lazyRecheck=10;   ///< every so many evaluations, all Jacobians are evaluated
+  uint lazyCount=0;
+  boolA lazy;            ///< the hint given to P in the last evaluation
 
   //-- buffers to avoid re-evaluating points
   arr x;               ///< point where P was last evaluated
@@ -57,6 +64,9 @@ struct LagrangianProblem : ScalarFunction, NLP {
   void aulaUpdate(const rai::OptOptions& opt, bool anyTimeVariant, double lambdaStepsize=1., double* L_x=nullptr, arr& dL_x=NoArr, arr& HL_x=NoArr);
   void autoUpdate(const rai::OptOptions& opt, double* L_x=nullptr, arr& dL_x=NoArr, arr& HL_x=NoArr);
 
+  //private: evaluate P at x (if not buffered), using lazy hints
+  void evaluateP(const arr& _x);
+
   //private: used gpenalty function
   double gpenalty(double g);
   double gpenalty_d(double g);
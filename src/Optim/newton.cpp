@@ -9,6 +9,7 @@
 #include "newton.h"
 
 #include <iomanip>
+#include <math.h>
 
 //#define NewtonLazyLineSearchMode
 
@@ -43,12 +44,17 @@ void OptNewton::reinit(const arr& _x) {
 //  boundClip(x, bounds_lo, bounds_up);
   boundCheck(x, bounds_lo, bounds_up);
   timeEval -= rai::cpuTime();
+  {
+    rai::ProfileScope prof("OptNewton", "eval");
 #ifdef NewtonLazyLineSearchMode
-  fx = f(NoArr, NoArr, x);  evals++;
+    fx = f(NoArr, NoArr, x);  evals++;
 #else
-  fx = f(gx, Hx, x);  evals++;
+    fx = f(gx, (lbfgsMemory?NoArr:Hx), x);  evals++;
 #endif
+  }
   timeEval += rai::cpuTime();
+  lbfgs_s.clear();
+  lbfgs_y.clear();
 
   //startup verbose
   if(options.verbose>1) cout <<"----newton---- initial point f(x):" <<fx <<" alpha:" <<alpha <<" beta:" <<beta <<endl;
@@ -75,7 +81,7 @@ OptNewton::StopCriterion OptNewton::step() {
 
 #ifdef NewtonLazyLineSearchMode
   timeEval -= rai::cpuTime();
-  fx = f(gx, Hx, x);  //evals++;
+  fx = f(gx, (lbfgsMemory?NoArr:Hx), x);  //evals++;
   timeEval += rai::cpuTime();
 #endif
 
@@ -85,11 +91,17 @@ OptNewton::StopCriterion OptNewton::step() {
   if(!(fx==fx)) HALT("you're calling a newton step with initial function value = NAN");
 
   timeNewton -= rai::cpuTime();
+  rai::ProfileScope profDirection("OptNewton", "direction");
+
+  //-- L-BFGS or matrix-free (PCG) directions; otherwise the Newton direction below
+  if(lbfgsMemory) Delta = getLBFGSDirection();
+  else if(matrixFree) Delta = getPCGDirection();
 
   //-- check active bounds, and decorrelate Hessian
-  arr R=Hx;
+  arr R;
+  if(!Delta.N) R=Hx;
 #if 1
-  {
+  if(!Delta.N) {
     intA boundActive; //analogy to dual parameters for bounds: -1: lower active; +1: upper active
     uint nActiveBounds=0;
     if(!boundActive.N) boundActive.resize(x.N).setZero();
@@ -130,7 +142,7 @@ OptNewton::StopCriterion OptNewton::step() {
   double diag = 0.;
   if(sigmin<beta) diag = beta-sigmin;
 #endif
-  if(beta) { //Levenberg Marquardt damping
+  if(beta && !Delta.N) { //Levenberg Marquardt damping
     if(!isSpecial(R)) {
       for(uint i=0; i<R.d0; i++) R(i, i) += beta;
     } else if(isRowShifted(R)) {
@@ -139,7 +151,7 @@ OptNewton::StopCriterion OptNewton::step() {
       for(uint i=0; i<R.d0; i++) R.sparse().addEntry(i, i) = beta;
     } else NIY;
   }
-  {
+  if(!Delta.N) {
     bool inversionFailed=false;
     try {
       if(!rootFinding) {
@@ -190,8 +202,10 @@ OptNewton::StopCriterion OptNewton::step() {
   }
 
   timeNewton += rai::cpuTime();
+  profDirection.end();
 
   //-- line search along Delta
+  rai::ProfileScope profLineSearch("OptNewton", "lineSearch");
   uint lineSearchSteps=0;
   for(;;lineSearchSteps++) {
     if(alpha>1.) alpha=1.;
@@ -201,11 +215,14 @@ OptNewton::StopCriterion OptNewton::step() {
     if(options.verbose>5) cout <<"  y:" <<y;
     boundClip(y, bounds_lo, bounds_up);
     timeEval -= rai::cpuTime();
+    {
+      rai::ProfileScope prof("OptNewton", "eval");
 #ifdef NewtonLazyLineSearchMode
-    fy = f(NoArr, NoArr, y);  evals++;
+      fy = f(NoArr, NoArr, y);  evals++;
 #else
-    fy = f(gy, Hy, y);  evals++;
+      fy = f(gy, (lbfgsMemory?NoArr:Hy), y);  evals++;
 #endif
+    }
     timeEval += rai::cpuTime();
     if(options.verbose>1) cout <<"  evals:" <<std::setw(4) <<evals <<"  f(y):" <<std::setw(11) <<fy <<std::flush;
     if(simpleLog) {
@@ -224,6 +241,7 @@ OptNewton::StopCriterion OptNewton::step() {
       }
       if(options.stopFTolerance<0. && fx-fy<options.stopFTolerance) numTinyFSteps++; else numTinyFSteps=0;
       if(absMax(y-x)<1e-2*options.stopTolerance) numTinyXSteps++; else numTinyXSteps=0;
+      if(lbfgsMemory) addLBFGSPair(y-x, gy-gx);
       x = y;
       fx = fy;
 #ifdef NewtonLazyLineSearchMode
@@ -299,6 +317,149 @@ OptNewton& OptNewton::setBounds(const arr& _bounds_lo, const arr& _bounds_up){
   return *this;
 }
 
+OptNewton& OptNewton::setLBFGS(uint memory){
+  lbfgsMemory = memory;
+  lbfgs_s.clear();
+  lbfgs_y.clear();
+  return *this;
+}
+
+/// diagonal of A^T A, for dense, sparse and row-shifted A
+arr diag_AtA(const arr& A){
+  arr d = zeros(A.d1);
+  if(isSparseMatrix(A)) {
+    const rai::SparseMatrix& S = A.sparse();
+    for(uint k=0; k<S.elems.d0; k++) d.p[S.elems.p[2*k+1]] += rai::sqr(A.p[k]);
+  } else if(isRowShifted(A)) {
+    const rai::RowShifted& S = A.rowShifted();
+    for(uint i=0; i<A.d0; i++) {
+      double* Zp = A.p + i*S.rowSize;
+      for(uint j=0; j<S.rowLen.p[i]; j++) d.p[S.rowShift.p[i]+j] += rai::sqr(Zp[j]);
+    }
+  } else {
+    CHECK(!isSpecial(A), "");
+    for(uint i=0; i<A.d0; i++) for(uint j=0; j<A.d1; j++) d.p[j] += rai::sqr(A.p[i*A.d1+j]);
+  }
+  return d;
+}
+
+arr OptNewton::getPCGDirection(){
+  CHECK(!rootFinding, "matrix-free steps assume a Gauss-Newton factor");
+  CHECK_EQ(Hx.d1, x.N, "in matrixFree mode f needs to return the Gauss-Newton factor R (with H=R^T R) as Hessian");
+
+  //-- bound-active variables are decorrelated (as for the explicit Hessian)
+  boolA active(x.N);
+  active = false;
+  if(bounds_lo.N && bounds_up.N) {
+    for(uint i=0; i<x.N; i++) if(bounds_up(i)>bounds_lo(i)) {
+      if(x(i)>=bounds_up(i)-1e-10 || x(i)<=bounds_lo(i)+1e-10) active(i) = true;
+    }
+  }
+
+  //-- Jacobi preconditioner: the damped diagonal of H
+  arr diag = diag_AtA(Hx);
+  diag += beta;
+  for(double& d:diag) if(d<=0.) d=1.;
+
+  auto H_times = [this, &active, &diag](const arr& v) -> arr {
+    arr w = v;
+    for(uint i=0; i<x.N; i++) if(active.p[i]) w.p[i]=0.;
+    arr Hv = comp_At_x(Hx, comp_A_x(Hx, w));
+    Hv.reshape(x.N);
+    for(uint i=0; i<x.N; i++) {
+      if(active.p[i]) Hv.p[i] = diag.p[i]*v.p[i];
+      else Hv.p[i] += beta*v.p[i];
+    }
+    return Hv;
+  };
+
+  //-- PCG with forcing tolerance eta |g|, eta = min(.5, sqrt|g|)
+  double gnorm = length(gx);
+  double tol = rai::MIN(.5, ::sqrt(gnorm)) * gnorm;
+  arr Delta = zeros(x.N);
+  arr r = -gx;
+  arr z = r/diag;
+  arr p = z;
+  double rz = scalarProduct(r, z);
+  for(pcgIters=0; pcgIters<(int)x.N; pcgIters++) {
+    if(length(r)<=tol) break;
+    arr Hp = H_times(p);
+    double pHp = scalarProduct(p, Hp);
+    if(pHp<=0.) break;
+    double a = rz/pHp;
+    Delta += a*p;
+    r -= a*Hp;
+    z = r/diag;
+    double rz_new = scalarProduct(r, z);
+    p *= rz_new/rz;
+    p += z;
+    rz = rz_new;
+  }
+  if(options.verbose>1) cout <<"  pcg:" <<std::setw(3) <<pcgIters;
+
+  if(!pcgIters || scalarProduct(Delta, gx)>=0.) {
+    if(options.verbose>0) cout <<"** PCG failed ... using gradient descent direction" <<endl;
+    Delta = gx * (-options.maxStep/length(gx));
+  }
+  return Delta;
+}
+
+arr OptNewton::getLBFGSDirection(){
+  //-- variables at a bound with the gradient pushing outwards are fixed (projected L-BFGS)
+  arr g = gx;
+  boolA fixed(x.N);
+  fixed = false;
+  if(bounds_lo.N && bounds_up.N) {
+    for(uint i=0; i<x.N; i++) if(bounds_up.elem(i)>bounds_lo.elem(i)) {
+      if(x.elem(i)>=bounds_up.elem(i)-1e-10 && g.elem(i)<0.) fixed.elem(i)=true;
+      if(x.elem(i)<=bounds_lo.elem(i)+1e-10 && g.elem(i)>0.) fixed.elem(i)=true;
+    }
+  }
+  for(uint i=0; i<x.N; i++) if(fixed.elem(i)) g.elem(i)=0.;
+
+  //-- two-loop recursion
+  uint m = lbfgs_s.d0;
+  arr a(m), rho(m);
+  arr r = g;
+  for(uint k=m; k--;) {
+    rho(k) = 1./scalarProduct(lbfgs_y[k], lbfgs_s[k]);
+    a(k) = rho(k) * scalarProduct(lbfgs_s[k], r);
+    r -= a(k) * lbfgs_y[k];
+  }
+  if(m) r *= scalarProduct(lbfgs_s[m-1], lbfgs_y[m-1]) / sumOfSqr(lbfgs_y[m-1]);
+  for(uint k=0; k<m; k++) {
+    double b = rho(k) * scalarProduct(lbfgs_y[k], r);
+    r += (a(k)-b) * lbfgs_s[k];
+  }
+  for(uint i=0; i<x.N; i++) if(fixed.elem(i)) r.elem(i)=0.;
+
+  //-- fall back to the (projected) gradient if this is not a descent direction
+  if(scalarProduct(r, gx)<=0.) {
+    if(options.verbose>0 && m) cout <<"** L-BFGS direction is not descending ... resetting memory" <<endl;
+    lbfgs_s.clear();
+    lbfgs_y.clear();
+    m = 0;
+  }
+  //-- without curvature pairs, scale the gradient step as the Newton fallback does
+  if(!m) {
+    double len = length(g);
+    r = g;
+    if(len>0. && options.maxStep>0.) r *= options.maxStep/len;
+  }
+  return -r;
+}
+
+void OptNewton::addLBFGSPair(const arr& s, const arr& y){
+  double sy = scalarProduct(s, y);
+  if(sy<=1e-10*length(s)*length(y)) return; //skip pairs that would break positive definiteness
+  lbfgs_s.append(s);  lbfgs_s.reshape(-1, x.N);
+  lbfgs_y.append(y);  lbfgs_y.reshape(-1, x.N);
+  if(lbfgs_s.d0>lbfgsMemory) {
+    lbfgs_s.delRows(0);
+    lbfgs_y.delRows(0);
+  }
+}
+
 OptNewton::StopCriterion OptNewton::run(uint maxIt) {
   numTinyFSteps=numTinyXSteps=0;
   for(uint i=0; i<maxIt; i++) {
@@ -23,6 +23,8 @@ struct OptNewton {
   OptNewton(arr& x, const ScalarFunction& f, rai::OptOptions options=NOOPT, ostream* _logFile=0);
   ~OptNewton();
   OptNewton& setBounds(const arr& _bounds_lo, const arr& _bounds_up);
+  OptNewton& setLBFGS(uint memory=10); ///< use limited-memory quasi-Newton (L-BFGS) directions instead of Hessians: f is never queried for H
+  OptNewton& setMatrixFree(bool _matrixFree=true){ matrixFree=_matrixFree; return *this; } ///< f returns a Gauss-Newton factor R (with H=R^T R) instead of H; steps are computed with PCG
   void reinit(const arr& _x);
 
   StopCriterion step();
@@ -38,4 +40,17 @@ public:
   bool rootFinding=false;
   ostream* logFile=nullptr, *simpleLog=nullptr;
   double timeNewton=0., timeEval=0.;
+
+  //-- matrix-free mode
+  bool matrixFree=false; ///< Hx holds the Gauss-Newton factor R (H=R^T R), which is only used in products
+  int pcgIters=0;        ///< PCG iterations of the last step (for reporting)
+
+  //-- L-BFGS mode
+  uint lbfgsMemory=0;    ///< number of stored correction pairs; 0: standard Newton steps
+  arr lbfgs_s, lbfgs_y;  ///< correction pairs (x and gradient differences), one per row
+
+private:
+  arr getPCGDirection();
+  arr getLBFGSDirection();
+  void addLBFGSPair(const arr& s, const arr& y);
 };
@@ -32,6 +32,10 @@ struct OptOptions {
   RAI_PARAM("opt/", double, stepDec, .5)
   RAI_PARAM("opt/", double, wolfe, .01)
   RAI_PARAM("opt/", bool,   boundedNewton, true)
+  RAI_PARAM("opt/", int,    lbfgsMemory, 0)
+  RAI_PARAM("opt/", bool,   matrixFree, false)
+  RAI_PARAM("opt/", double, lazyIneqMargin, -1.)
+  RAI_PARAM("opt/", int,    lazyIneqRecheck, 10)
   RAI_PARAM("opt/", double, muInit, 1.)
   RAI_PARAM("opt/", double, muInc, 5.)
   RAI_PARAM("opt/", double, muMax, 1e4)
@@ -52,6 +52,12 @@ double Conv_NLP_ScalarProblem::scalar(arr& g, arr& H, const arr& x){
       arr sqrtCoeff = sqrt(coeff);
       tmp.sparse().rowWiseMult(sqrtCoeff);
     }
+    if(hessianFactor) { //matrix-free: only return the factor
+      CHECK(!hasF, "the matrix-free Gauss-Newton factor can't represent explicit f-Hessians");
+      H = tmp;
+      return f;
+    }
+
     H = comp_At_A(tmp); //Gauss-Newton type!
 
     if(hasF) { //For f-terms, the Hessian must be given explicitly, and is not \propto J^T J
@@ -41,6 +41,7 @@ struct Conv_ScalarProblem_NLP : NLP {
 
 struct Conv_NLP_ScalarProblem : ScalarFunction {
   std::shared_ptr<NLP> P;
+  bool hessianFactor=false; ///< return the Gauss-Newton factor R (with H=R^T R) instead of H (for matrix-free Newton)
 
   Conv_NLP_ScalarProblem(std::shared_ptr<NLP> _P) : P(_P) {
     ScalarFunction::operator=([this](arr& g, arr& H, const arr& x) -> double {
@@ -48,7 +48,7 @@ shared_ptr<QueryResult> ConfigurationProblem::query(const arr& x){
   C.setJointState(x);
   if(computeAllCollisions){
     //C.stepSwift();
-    C.stepFcl();
+    C.stepBroadphase();
     for(rai::Proxy& p:C.proxies) p.ensure_coll();
   }else if(collisionPairs.N){
     C.proxies.resize(collisionPairs.d0);
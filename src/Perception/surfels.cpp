@@ -11,6 +11,8 @@
 #include "kinect2pointCloud.h"
 
 #include <math.h>
+#include <thread>
+#include <functional>
 
 void glDrawSurfels(void* classP, OpenGL&) { ((Surfels*)classP)->glDraw(false); }
 void glDrawSurfelIndices(void* classP, OpenGL&) { ((Surfels*)classP)->glDraw(true); }
@@ -128,3 +130,181 @@ void Surfels::pointCloud2Surfels(const arr& pts, const arr& cols, OpenGL& gl) {
   }
   mx.unlock();
 }
+
+//===========================================================================
+
+void SurfelStatistics::eig(float* lambda, float& nx, float& ny, float& nz) {
+  //covariance
+  double mx=x/n, my=y/n, mz=z/n;
+  double a00=xx/n-mx*mx, a11=yy/n-my*my, a22=zz/n-mz*mz;
+  double a01=xy/n-mx*my, a02=xz/n-mx*mz, a12=yz/n-my*mz;
+
+  //eigenvalues (trigonometric solution of the characteristic cubic)
+  double e1, e2, e3;
+  double p1 = a01*a01 + a02*a02 + a12*a12;
+  double q = (a00+a11+a22)/3.;
+  if(p1<1e-30) { //diagonal
+    double d[3]={a00, a11, a22};
+    std::sort(d, d+3);
+    e1=d[2]; e2=d[1]; e3=d[0];
+  } else {
+    double p2 = (a00-q)*(a00-q) + (a11-q)*(a11-q) + (a22-q)*(a22-q) + 2.*p1;
+    double p = sqrt(p2/6.);
+    double b00=(a00-q)/p, b11=(a11-q)/p, b22=(a22-q)/p, b01=a01/p, b02=a02/p, b12=a12/p;
+    double r = .5*(b00*(b11*b22-b12*b12) - b01*(b01*b22-b12*b02) + b02*(b01*b12-b11*b02));
+    r = rai::MAX(-1., rai::MIN(1., r));
+    double phi = acos(r)/3.;
+    e1 = q + 2.*p*cos(phi);
+    e3 = q + 2.*p*cos(phi + 2.*RAI_PI/3.);
+    e2 = 3.*q - e1 - e3;
+  }
+  lambda[0]=e1; lambda[1]=e2; lambda[2]=e3;
+
+  //eigenvector of the smallest: orthogonal to the rows of (A - e3 I) -> largest cross product of two rows
+  double r0[3]={a00-e3, a01, a02}, r1[3]={a01, a11-e3, a12}, r2[3]={a02, a12, a22-e3};
+  double c[3][3]={
+    {r0[1]*r1[2]-r0[2]*r1[1], r0[2]*r1[0]-r0[0]*r1[2], r0[0]*r1[1]-r0[1]*r1[0]},
+    {r0[1]*r2[2]-r0[2]*r2[1], r0[2]*r2[0]-r0[0]*r2[2], r0[0]*r2[1]-r0[1]*r2[0]},
+    {r1[1]*r2[2]-r1[2]*r2[1], r1[2]*r2[0]-r1[0]*r2[2], r1[0]*r2[1]-r1[1]*r2[0]}};
+  uint best=0;
+  double l[3];
+  for(uint i=0; i<3; i++) { l[i]=c[i][0]*c[i][0]+c[i][1]*c[i][1]+c[i][2]*c[i][2]; if(l[i]>l[best]) best=i; }
+  if(l[best]<1e-30) { nx=0.f; ny=0.f; nz=1.f; return; } //degenerate (e.g. a single point)
+  double s=1./sqrt(l[best]);
+  nx=c[best][0]*s; ny=c[best][1]*s; nz=c[best][2]*s;
+}
+
+//===========================================================================
+
+uint64_t SurfelMap::key(double x, double y, double z) const {
+  //21 bits per axis (two's complement), i.e. +-1e6 voxels
+  uint64_t ix = (uint64_t)(int64_t)floor(x/voxelSize) & 0x1fffff;
+  uint64_t iy = (uint64_t)(int64_t)floor(y/voxelSize) & 0x1fffff;
+  uint64_t iz = (uint64_t)(int64_t)floor(z/voxelSize) & 0x1fffff;
+  return ix<<42 | iy<<21 | iz;
+}
+
+void SurfelMap::corner(uint64_t k, double& x, double& y, double& z) const {
+  auto sext = [](uint64_t i) { i &= 0x1fffff; return (int64_t)(i & 0x100000 ? i | ~uint64_t(0x1fffff) : i); };
+  x = voxelSize*sext(k>>42);
+  y = voxelSize*sext(k>>21);
+  z = voxelSize*sext(k);
+}
+
+void SurfelMap::clear() {
+  D.clear();  keys.clear();  lastSeen.clear();  norms.clear();
+  voxels.clear();
+  frame=0;
+}
+
+void SurfelMap::remove(uint s) {
+  uint last=D.N-1;
+  voxels.erase(keys(s));
+  if(s!=last) {
+    D(s)=D(last);  keys(s)=keys(last);  lastSeen(s)=lastSeen(last);  norms[s]=norms[last];
+    voxels[keys(s)]=s;
+  }
+  D.resizeCopy(last);  keys.resizeCopy(last);  lastSeen.resizeCopy(last);  norms.resizeCopy(last, 3);
+}
+
+void SurfelMap::integrate(const arr& pts, const arr& cols, const arr& viewPoint) {
+  CHECK(pts.nd==2 && pts.d1==3, "");
+  if(!!cols) CHECK_EQ(cols.d0, pts.d0, "");
+  frame++;
+
+  //-- decay
+  if(decay<1.f) for(SurfelStatistics& s:D) s.discount(decay);
+
+  //-- keys, and partition of the points by owner thread (thread t owns the keys with hash%T==t)
+  uint T = threads ? threads : rai::MAX(1u, std::thread::hardware_concurrency());
+  if(T>1 && pts.d0<1000*T) T = rai::MAX(1u, pts.d0/1000);
+  rai::Array<uint64_t> pkeys(pts.d0);
+  std::vector<std::vector<uintA>> part(T, std::vector<uintA>(T)); //part[chunk][owner]: point indices (ascending)
+  auto computeKeys = [&](uint t) {
+    std::hash<uint64_t> hash;
+    for(uint i=t*pts.d0/T; i<(t+1)*pts.d0/T; i++) {
+      const double* p=&pts(i, 0);
+      if(!std::isfinite(p[0]) || !std::isfinite(p[1]) || !std::isfinite(p[2])) continue;
+      pkeys(i) = key(p[0], p[1], p[2]);
+      part[t][hash(pkeys(i))%T].append(i);
+    }
+  };
+
+  //-- accumulate per voxel (parallel over owners)
+  struct NewStats { uint first; uint64_t k; SurfelStatistics* s; };
+  std::vector<std::unordered_map<uint64_t, std::pair<uint, SurfelStatistics>>> local(T); //key -> (first point index, stats)
+  auto accumulate = [&](uint t) {
+    for(uint c=0; c<T; c++) for(uint i:part[c][t]) {
+      uint64_t k=pkeys(i);
+      double cx, cy, cz;
+      corner(k, cx, cy, cz);
+      auto& e = local[t].emplace(k, std::make_pair(i, SurfelStatistics())).first->second;
+      const double* p=&pts(i, 0);
+      if(!!cols) e.second.add(p[0]-cx, p[1]-cy, p[2]-cz, cols(i, 0), cols(i, 1), cols(i, 2));
+      else e.second.add(p[0]-cx, p[1]-cy, p[2]-cz, 0.f, 0.f, 0.f);
+    }
+  };
+  auto run = [&](std::function<void(uint)> f) {
+    std::vector<std::thread> pool;
+    for(uint t=1; t<T; t++) pool.emplace_back(f, t);
+    f(0);
+    for(std::thread& th:pool) th.join();
+  };
+  run(computeKeys);
+  run(accumulate);
+
+  //-- merge into the map (in order of first occurrence -> independent of T): association by voxel key
+  std::vector<NewStats> touched;
+  for(uint t=0; t<T; t++) for(auto& e:local[t]) touched.push_back({e.second.first, e.first, &e.second.second});
+  std::sort(touched.begin(), touched.end(), [](const NewStats& a, const NewStats& b) { return a.first<b.first; });
+  for(const NewStats& e:touched) {
+    uint64_t k=e.k;
+    auto it = voxels.find(k);
+    uint s;
+    if(it==voxels.end()) {
+      s = D.N;
+      voxels[k] = s;
+      D.append(SurfelStatistics());
+      keys.append(k);
+      lastSeen.append(frame);
+      norms.append(arr{0., 0., 0.});
+      norms.reshape(D.N, 3);
+    } else s = it->second;
+    D(s).add(*e.s);
+    lastSeen(s) = frame;
+
+    //update the normal, keeping its orientation (new surfels: towards the view point)
+    float n[3];
+    D(s).norm(n[0], n[1], n[2]);
+    double cx, cy, cz, mx, my, mz;
+    corner(k, cx, cy, cz);
+    mx = cx + D(s).x/D(s).n;  my = cy + D(s).y/D(s).n;  mz = cz + D(s).z/D(s).n;
+    double* ns = &norms(s, 0);
+    double dir = ns[0]*n[0] + ns[1]*n[1] + ns[2]*n[2];
+    if(!dir && !!viewPoint) dir = (viewPoint(0)-mx)*n[0] + (viewPoint(1)-my)*n[1] + (viewPoint(2)-mz)*n[2];
+    if(dir<0.) { n[0]=-n[0]; n[1]=-n[1]; n[2]=-n[2]; }
+    ns[0]=n[0]; ns[1]=n[1]; ns[2]=n[2];
+  }
+
+  //-- remove stale surfels
+  if(maxAge) for(uint s=D.N; s--;) if(frame-lastSeen(s)>maxAge) remove(s);
+}
+
+void SurfelMap::getSurfels(arr& pos, arr& norm, arr& col, arr& rad) {
+  pos.clear();  norm.clear();  col.clear();  rad.clear();
+  for(uint s=0; s<D.N; s++) {
+    SurfelStatistics& d=D(s);
+    if(d.n<minCount) continue;
+    double cx, cy, cz;
+    corner(keys(s), cx, cy, cz);
+    float lambda[3], nx, ny, nz, r, g, b;
+    d.eig(lambda, nx, ny, nz);
+    if(lambda[1]<4.f*lambda[2]) continue; //not planar (e.g. a sliver of surface cut by the voxel): normal undefined
+    d.meanRGB(r, g, b);
+    pos.append({cx+d.x/d.n, cy+d.y/d.n, cz+d.z/d.n});
+    norm.append(norms[s]);
+    col.append({r, g, b});
+    rad.append(rai::MIN(voxelSize, 2.*sqrt(rai::MAX(lambda[0], 0.f))));
+  }
+  pos.reshape(-1, 3);  norm.reshape(-1, 3);  col.reshape(-1, 3);
+}
@@ -11,8 +11,10 @@
 #include "../Core/array.h"
 #include "../Gui/opengl.h"
 
+#include <unordered_map>
+
 struct SurfelStatistics {
-  float n, x, y, z, xx, xy, xz, yy, yz, zz, nx, ny, nz, r, g, b;
+  double n, x, y, z, xx, xy, xz, yy, yz, zz, nx, ny, nz, r, g, b; //double: the covariance is a difference of sums
   float rad;
   SurfelStatistics():n(0), x(0), y(0), z(0), xx(0), xy(0), xz(0), yy(0), yz(0), zz(0), nx(0), ny(0), nz(0), r(0), g(0), b(0) {}
   void add(float X, float Y, float Z, float R, float G, float B) {
@@ -22,19 +24,17 @@ struct SurfelStatistics {
     xy+=X*Y; xz+=X*Z; yz+=Y*Z;
     r+=R; g+=G; b+=B;
   }
+  void add(const SurfelStatistics& s) {
+    n+=s.n;
+    x+=s.x; y+=s.y; z+=s.z;
+    xx+=s.xx; yy+=s.yy; zz+=s.zz;
+    xy+=s.xy; xz+=s.xz; yz+=s.yz;
+    r+=s.r; g+=s.g; b+=s.b;
+  }
   void mean(float& mu_x, float& mu_y, float& mu_z) { mu_x=x/n; mu_y=y/n; mu_z=z/n; }
   void meanRGB(float& R, float& G, float& B) { R=r/n; G=g/n; B=b/n; }
-  void norm(float& nx, float& ny, float& nz) {
-    arr XX(3, 3), mu(3);
-    mu(0)=x/n; mu(1)=y/n; mu(2)=z/n;
-    XX(0, 0)=xx; XX(1, 1)=yy; XX(2, 2)=zz;
-    XX(0, 1)=XX(1, 0)=xy; XX(0, 2)=XX(2, 0)=xz; XX(1, 2)=XX(2, 1)=yz;
-    XX/=(double)n;
-    XX-=mu*~mu;
-    arr U, D, tV;
-    svd(U, D, tV, XX); tV=~tV;
-    nx = tV(1, 0);  ny = tV(1, 1);  nz = tV(1, 2); //last row of tV
-  }
+  void norm(float& nx, float& ny, float& nz) { float lambda[3]; eig(lambda, nx, ny, nz); }
+  void eig(float* lambda, float& nx, float& ny, float& nz); ///< closed-form eigenvalues (descending) of the covariance; n = eigenvector of the smallest
 
   void discount(float a) { n*=a; x*=a; y*=a; z*=a; xx*=a; xy*=a; xz*=a; yy*=a; yz*=a; zz*=a; r*=a; g*=a; b*=a; }
 
@@ -57,5 +57,34 @@ struct Surfels {
   void pointCloud2Surfels(const arr& pts, const arr& cols, OpenGL& gl);
 };
 
+/** Headless CPU surfel fusion, keyed by a spatial voxel hash: each voxel holds at most one surfel, so a point is
+ *  associated in O(1) by its voxel key. Statistics are accumulated relative to the voxel corner.
+ *  Clouds are integrated in parallel (threads own disjoint key sets; the result is independent of the thread count). */
+struct SurfelMap {
+  double voxelSize=.02;
+  float decay=.95;    ///< discount of all statistics per integrate (forgets old measurements)
+  uint maxAge=100;    ///< surfels not seen for this many integrate calls are removed (0: never)
+  float minCount=10.; ///< surfels with fewer (discounted) points are not output
+  uint threads=0;     ///< 0: hardware concurrency
+
+  rai::Array<SurfelStatistics> D;
+  rai::Array<uint64_t> keys;  ///< voxel key of each surfel
+  uintA lastSeen;
+  arr norms;                  ///< current (oriented) normal of each surfel
+  uint frame=0;
+
+  uint N() const { return D.N; }
+  void clear();
+  void integrate(const arr& pts, const arr& cols=NoArr, const arr& viewPoint=NoArr); ///< pts, cols: (n,3); viewPoint: to orient new normals
+  void getSurfels(arr& pos, arr& norm, arr& col, arr& rad);
+  void getSurfels(Surfels& S){ getSurfels(S.pos, S.norm, S.col, S.rad); }
+
+private:
+  std::unordered_map<uint64_t, uint> voxels;  ///< voxel key -> surfel index
+  uint64_t key(double x, double y, double z) const;
+  void corner(uint64_t k, double& x, double& y, double& z) const;
+  void remove(uint s);
+};
+
 void glDrawSurfels(void* classP);
 void glDrawSurfelIndices(void* classP);
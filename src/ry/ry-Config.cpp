@@ -288,7 +288,8 @@ To get really precise distances and penetrations use the FS.distance feature wit
       )
 
   .def("getTotalPenetration", &rai::Configuration::getTotalPenetration,
-       "returns the sum of all penetrations")
+       "returns the sum of all penetrations (of only one time slice, if slice>=0)",
+       pybind11::arg("slice")=-1)
 
   .def("view",  &rai::Configuration::view,
        "open a view window for the configuration",
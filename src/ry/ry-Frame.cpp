@@ -73,7 +73,7 @@ void init_Frame(pybind11::module& m) {
       return graph2dict(*self->ats);
      }, "get frame attributes")
 
-    .def_readwrite("name", &rai::Frame::name )
+    .def_property("name", [](shared_ptr<rai::Frame>& self){ return self->name; }, [](shared_ptr<rai::Frame>& self, const rai::String& name){ self->setName(name); })
 
     .def("getPosition", &rai::Frame::getPosition )
     .def("getQuaternion", &rai::Frame::getQuaternion )
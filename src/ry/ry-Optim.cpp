@@ -175,6 +175,7 @@ void init_Optim(pybind11::module& m) {
       .def("setSolver", &NLP_Solver::setSolver)
 
       .def("setTracing", &NLP_Solver::setTracing)
+      .def("setTraceStream", &NLP_Solver::setTraceStream, "", pybind11::arg("filename"), pybind11::arg("ringSize")=0)
       .def("solve", &NLP_Solver::solve, "", pybind11::arg("resampleInitialization")=-1)
 
       .def("getTrace_x", &NLP_Solver::getTrace_x)
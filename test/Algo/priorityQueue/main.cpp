@@ -0,0 +1,111 @@
+#include <Core/util.h>
+#include <Algo/priorityQueue.h>
+
+//===========================================================================
+
+//the order of the former sorted-array implementation: insertInSorted with a <= comparison
+static bool oldCmp(const PriorityQueueEntry<int>& a, const PriorityQueueEntry<int>& b) { return a.f_prio <= b.f_prio; }
+
+void testOrder(bool FIFOifEqual){
+  PriorityQueue<int> Q;
+  rai::Array<PriorityQueueEntry<int>> ref;
+  ref.memMove = 1;
+
+  for(uint k=0; k<2000; k++){
+    if(ref.N && rnd.uni()<.4){
+      int x = Q.pop();
+      CHECK_EQ(x, ref.first().x, "pop order differs from the sorted-array queue");
+      ref.remove(0);
+    } else {
+      double f = rnd(5); //many equal priorities
+      Q.add(f, k, FIFOifEqual);
+      PriorityQueueEntry<int> e = {f, (int)k};
+      ref.insertInSorted(e, oldCmp, FIFOifEqual);
+    }
+  }
+  while(ref.N){
+    CHECK_EQ(Q.pop(), ref.first().x, "");
+    ref.remove(0);
+  }
+  CHECK_EQ(Q.N, 0, "");
+}
+
+void TEST(TieBreaking){
+  testOrder(true);
+  testOrder(false);
+}
+
+//===========================================================================
+
+void TEST(Handles){
+  PriorityQueue<int> Q;
+  uintA h(10);
+  for(uint i=0; i<10; i++) h(i) = Q.add(double(i), i);
+
+  //decrease- and increase-key
+  Q.update(h(7), -1.);
+  CHECK_EQ(Q.top(), 7, "");
+  Q.update(h(7), 100.);
+  CHECK_EQ(Q.top(), 0, "");
+
+  //erase
+  Q.erase(h(0));
+  Q.erase(h(5));
+  CHECK(!Q.contains(h(0)), "");
+  CHECK(!Q.contains(h(5)), "");
+  CHECK(Q.contains(h(1)), "");
+  CHECK_EQ(Q.N, 8, "");
+
+  intA order;
+  while(Q.N) order.append(Q.pop());
+  CHECK_EQ(order, intA({1, 2, 3, 4, 6, 8, 9, 7}), "");
+  for(uint i=0; i<10; i++) CHECK(!Q.contains(h(i)), "");
+
+  //random updates and erases against a brute-force reference
+  arr prio(50);
+  boolA in(50);
+  h.resize(50);
+  for(uint i=0; i<50; i++){ prio(i) = rnd.uni(); in(i) = true; h(i) = Q.add(prio(i), i); }
+  for(uint k=0; k<500; k++){
+    uint i = rnd(50);
+    if(!in(i)) continue;
+    if(rnd.uni()<.2){ Q.erase(h(i)); in(i) = false; }
+    else{ prio(i) = rnd.uni(); Q.update(h(i), prio(i)); }
+  }
+  double last = -1.;
+  while(Q.N){
+    int i = Q.pop();
+    CHECK(in(i), "erased element was popped");
+    CHECK_GE(prio(i), last, "");
+    last = prio(i);
+    in(i) = false;
+  }
+  for(uint i=0; i<50; i++) CHECK(!in(i), "element got lost");
+}
+
+//===========================================================================
+
+void TEST(HandleRecycling){
+  //the handle table is bounded by the maximal queue size, not by the number of insertions
+  PriorityQueue<int> Q;
+  for(uint k=0; k<10000; k++){
+    Q.add(rnd.uni(), k);
+    if(Q.N>5) Q.pop();
+  }
+  CHECK_LE(Q.handlePos.N, 6, "");
+  CHECK_EQ(Q.handlePos.N, Q.N + Q.freeHandles.N, "");
+}
+
+//===========================================================================
+
+int MAIN(int argc,char** argv){
+  rai::initCmdLine(argc,argv);
+
+  rnd.seed(0);
+
+  testTieBreaking();
+  testHandles();
+  testHandleRecycling();
+
+  return 0;
+}
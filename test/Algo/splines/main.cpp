@@ -95,6 +95,46 @@ void TEST(Speed){
 
 //==============================================================================
 
+void TEST(Evaluator){
+  //compiled evaluator vs. direct spline evaluation
+  for(uint deg=0;deg<=4;deg++){
+    rai::BSpline S;
+    S.set(deg, randn(7,3), integral(rand(7)+.1));
+    rai::SplineEvaluator E;
+    E.compile(S);
+    arr x(3), x0;
+    double err=0.;
+    for(double t=S.begin()-.3;t<S.end()+.3;t+=1e-3){
+      E.eval(x, NoArr, NoArr, t);
+      S.eval(x0, NoArr, NoArr, t);
+      err = rai::MAX(err, maxDiff(x, x0));
+    }
+    cout <<"BSpline degree " <<deg <<" max error: " <<err <<endl;
+    CHECK_ZERO(err, 1e-10, "");
+  }
+
+  //compiled cubic spline: same values and derivatives, also beyond the end (boundary velocity is held)
+  rai::CubicSpline C;
+  C.set(randn(6,3), randn(6,3), integral(rand(6)+.1));
+  rai::SplineEvaluator E;
+  E.compile(C);
+  arr x(3), xDot(3), xDDot(3), x0, xDot0, xDDot0;
+  double err=0.;
+  for(double t=C.begin()-.3;t<C.end()+.3;t+=1e-3){
+    bool inside = (t>=C.begin() && t<=C.end());
+    E.eval(x, xDot, xDDot, t);
+    C.eval(x0, xDot0, (inside?xDDot0:NoArr), t);
+    err = rai::MAX(err, maxDiff(x, x0));
+    err = rai::MAX(err, maxDiff(xDot, xDot0));
+    if(inside) err = rai::MAX(err, maxDiff(xDDot, xDDot0));
+    else CHECK_ZERO(absMax(xDDot), 1e-10, "");
+  }
+  cout <<"CubicSpline max error: " <<err <<endl;
+  CHECK_ZERO(err, 1e-10, "");
+}
+
+//==============================================================================
+
 void TEST(Path){
   arr X(11,1);
   rndUniform(X,-1,1,false);
@@ -194,6 +234,7 @@ int MAIN(int argc,char** argv){
 
   testBasics();
   testBasis();
+  testEvaluator();
 //  testSpeed();
 
 //  testPath();
@@ -1,4 +1,5 @@
 #include <Control/control.h>
+#include <Control/SecMPC.h>
 
 #include <Kin/viewer.h>
 #include <Kin/F_pose.h>
@@ -45,6 +46,113 @@ void testMinimal(){
 
 //===========================================================================
 
+void testReactiveQP(){
+  rai::Configuration C;
+  C.addFile("scene.g");
+
+  double tau=.01;
+
+  CtrlSet CS;
+  CS.addControlObjective(2, 1e-2*sqrt(tau), C);
+  CS.addControlObjective(1, 1e-1*sqrt(tau), C);
+  auto pos = CS.addObjective(make_feature(FS_poseDiff, {"gripper", "target"}, C, {1e0}), OT_sos, .1);
+
+  CtrlSolver ctrl(C, tau, 2);
+  ctrl.useQP = true;
+
+  double time=0.;
+  uint ticks=0;
+  for(uint t=0;t<1000;t++){
+    ctrl.set(CS);
+    arr q = C.getJointState();
+    ctrl.update(q, {}, C);
+    time -= rai::cpuTime();
+    arr q_new = ctrl.solve();
+    time += rai::cpuTime();
+    ticks++;
+
+    //velocity bounds are respected
+    CHECK_LE(absMax(q_new-q), ctrl.maxVel*tau+1e-10, "");
+    C.setJointState(q_new);
+
+    C.view(false, STRING("t:" <<t));
+    if(pos->status>AS_running) break;
+  }
+  //the grounding is kept across ticks
+  CHECK_EQ(ctrl.qp.grounded.N, 3, "");
+  cout <<"avg QP tick time: " <<time/ticks <<"sec" <<endl;
+}
+
+//===========================================================================
+
+void testReactiveQPvsKOMO(){
+  //with loose velocity/acceleration bounds, the QP and the full KOMO solve should drive the robot to the same place
+  arr pos[2];
+  for(uint useQP=0;useQP<2;useQP++){
+    rai::Configuration C;
+    C.addFile("scene.g");
+
+    double tau=.01;
+
+    CtrlSet CS;
+    CS.addControlObjective(2, 1e-2*sqrt(tau), C);
+    CS.addControlObjective(1, 1e-1*sqrt(tau), C);
+    CS.addObjective(make_feature(FS_positionDiff, {"gripper", "target"}, C, {1e0}), OT_sos, .1);
+    CS.addObjective(make_feature(FS_position, {"gripper"}, C, arr({1,3},{0.,1.,0.}), {0.,.5,0.}), OT_ineq);
+
+    CtrlSolver ctrl(C, tau, 2);
+    ctrl.useQP = useQP;
+    ctrl.maxVel = ctrl.maxAcc = 1e3;
+
+    for(uint t=0;t<1000;t++){
+      ctrl.set(CS);
+      ctrl.update(C.getJointState(), {}, C);
+      C.setJointState(ctrl.solve());
+      C.view(false, STRING((useQP?"QP":"KOMO") <<" t:" <<t));
+    }
+    pos[useQP] = C["gripper"]->getPosition();
+    cout <<(useQP?"QP":"KOMO") <<" final gripper position: " <<pos[useQP] <<endl;
+
+    //the (elastic) inequality holds
+    CHECK_LE(pos[useQP](1), .5+1e-3, "");
+  }
+  CHECK_LE(length(pos[1]-pos[0]), 1e-2, "QP and KOMO controllers diverge");
+}
+
+//===========================================================================
+
+void testCtrlSetFeasibility(){
+  //feasibility of a CtrlSet with an order-1 objective is checked at the current slice of the controller's path
+  rai::Configuration C;
+  C.addFile("scene.g");
+
+  double tau=.01;
+
+  CtrlSet CS;
+  CS.addControlObjective(2, 1e-2*sqrt(tau), C);
+  CS.addControlObjective(1, 1e-1*sqrt(tau), C);
+  CS.addObjective(make_feature(FS_positionDiff, {"gripper", "target"}, C, {1e0}), OT_sos, .1);
+
+  CtrlSet rest; //the gripper does not move
+  rest.addObjective(make_feature(FS_position, {"gripper"}, C, {1e0}, NoArr, 1), OT_eq);
+
+  CtrlSolver ctrl(C, tau, 2);
+  ctrl.set(CS);
+  ctrl.update(C.getJointState(), {}, C);
+  CHECK(rest.canBeInitiated(ctrl.komo.pathConfig), "the gripper starts at rest");
+
+  uint moving=0;
+  for(uint t=0;t<100;t++){
+    ctrl.set(CS);
+    ctrl.update(C.getJointState(), {}, C);
+    C.setJointState(ctrl.solve());
+    if(!rest.isConverged(ctrl.komo.pathConfig)) moving++;
+  }
+  CHECK(moving>0, "the gripper never moved towards the target");
+}
+
+//===========================================================================
+
 void testGrasp(){
   rai::Configuration C;
   C.addFile("pandas.g");
@@ -151,10 +259,71 @@ void testIneqCarrot(){
 
 //===========================================================================
 
+void testSecMPCThreaded(){
+  rai::Configuration C;
+  C.addFile("scene.g");
+
+  KOMO komo;
+  komo.setConfig(C, false);
+  komo.setTiming(1., 1, 1.);
+  komo.addControlObjective({}, 1, 1e-1);
+  komo.addObjective({1.}, FS_positionDiff, {"gripper", "target"}, OT_eq, {1e1});
+
+  SecMPC mpc(komo, 0, -1, 1e0, 1e0, false);
+  mpc.opt.verbose = 0;
+  SecMPC_Threaded thr(mpc, C);
+
+  //emulate a controller: follow the latest timing spline at 100Hz, until the gripper reaches the target
+  double ctrlTime=0., tau=.01, dist=0.;
+  arr q = C.getJointState(), qDot = zeros(q.N);
+  uint splines=0, shortPaths=0;
+  for(uint t=0;t<1000;t++){
+    thr.setCtrlState(C, q, qDot, q, ctrlTime);
+    rai::wait(tau);
+    ctrlTime += tau;
+
+    rai::CubicSplineCtor sp = thr.getSpline(ctrlTime);
+    if(sp.pts.N){
+      splines++;
+      //a consistent snapshot: one velocity and time per knot, times increasing
+      CHECK_EQ(sp.pts.d1, q.N, "");
+      CHECK_EQ(sp.vels.d0, sp.pts.d0, "");
+      CHECK_EQ(sp.times.N, sp.pts.d0, "");
+      for(uint i=1;i<sp.times.N;i++) CHECK_GE(sp.times(i), sp.times(i-1), "");
+      rai::CubicSpline S;
+      S.set(sp.pts, sp.vels, sp.times);
+      q = S.eval(0.);
+      qDot = S.eval(0., 1);
+      C.setJointState(q);
+    }
+
+    //short paths come without velocities (as in the sequential SecMPC) -- only check their layout
+    rai::CubicSplineCtor sh = thr.getShortPath(ctrlTime);
+    if(sh.pts.N){
+      shortPaths++;
+      CHECK_EQ(sh.pts.d1, q.N, "");
+      CHECK_EQ(sh.times.N, sh.pts.d0, "");
+    }
+    if(!(t%50)) thr.report();
+
+    dist = length(C["gripper"]->getPosition() - C["target"]->getPosition());
+    if(dist<1e-2) break;
+  }
+  CHECK(splines>0, "the timing layer never published a spline");
+  cout <<"short paths: " <<shortPaths <<" final gripper-target distance: " <<dist <<" after " <<ctrlTime <<"sec" <<endl;
+  CHECK_LE(dist, 1e-2, "the threaded SecMPC did not reach the target");
+}
+
+//===========================================================================
+
 int main(int argc,char** argv){
   rai::initCmdLine(argc,argv);
 
   testMinimal();
+  testReactiveQP();
+  testReactiveQPvsKOMO();
+  testCtrlSetFeasibility();
+  testSecMPCThreaded();
 //  testGrasp();
 //  testIneqCarrot();
 
@@ -129,6 +129,45 @@ void timeOpt(){
 
 //===========================================================================
 
+void compareSolvers(){
+  //the banded TimingSolver and the generic NLP_Solver find the same optimum -- unconstrained, and with active velocity/acceleration limits
+  for(uint constrained=0; constrained<2; constrained++){
+    rnd.seed(0);
+    uint K=20, d=7;
+    arr path = randn(K, d);
+    arr x0 = zeros(d), v0 = zeros(d);
+    double maxVel = (constrained ? 1. : -1.), maxAcc = (constrained ? 2. : -1.);
+
+    rai::OptOptions opt;
+    opt.set_verbose(0).set_maxStep(1e0).set_stopTolerance(1e-4).set_damping(1e-2);
+
+    TimingProblem P1(path, {}, x0, v0, 1e0, 1e0, true, false, {}, {}, maxVel, maxAcc);
+    NLP_Solver S;
+    S.setOptions(opt).setProblem(P1.ptr()).setSolver(NLPS_augmentedLag);
+    auto ret1 = S.solve();
+
+    TimingProblem P2(path, {}, x0, v0, 1e0, 1e0, true, false, {}, {}, maxVel, maxAcc);
+    TimingSolver T(P2, opt);
+    auto ret2 = T.solve();
+
+    cout <<(constrained?"constrained":"unconstrained") <<"\n  generic:    " <<*ret1 <<"\n  structured: " <<*ret2 <<endl;
+    if(constrained){
+      CHECK_LE(ret1->ineq, 1e-3, "");
+      CHECK_LE(ret2->ineq, 1e-3, "");
+      //the limits are active at the optimum
+      arr phi;
+      P2.evaluate(phi, NoArr, ret2->x);
+      double gMax=-1e10;
+      for(uint i=0; i<phi.N; i++) if(P2.featureTypes(i)==OT_ineq) gMax = rai::MAX(gMax, phi(i));
+      CHECK_GE(gMax, -1e-3, "no velocity/acceleration limit is active");
+    }
+    CHECK_ZERO(maxDiff(P1.tau, P2.tau), 1e-4, "");
+    CHECK_ZERO(maxDiff(P1.v, P2.v), 1e-4, "");
+  }
+}
+
+//===========================================================================
+
 void waypointHunting(){
   //-- create random waypoints
   uint K=5, d=3;
@@ -219,6 +258,8 @@ int main(int argc,char** argv){
 //  rnd.seed(1);
   rnd.clockSeed();
 
+  compareSolvers();
+
   timeOpt();
 
   waypointHunting();
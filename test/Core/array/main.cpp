@@ -563,6 +563,36 @@ void TEST(MM){
 
 //===========================================================================
 
+void TEST(FixedMM){
+  cout <<"\n*** fixed-size kernels for small matrix products\n";
+  uint n[3]={1, 7, 40};
+  for(uint l=0;l<3;l++){
+    //small dense left factors are dispatched to fixed_MM
+    for(uint M=1;M<=5;M++) for(uint K=1;K<=5;K++){
+      arr A(M,K), B(K,n[l]), C, D(M,n[l]);
+      rndUniform(A,-1,1,false);
+      rndUniform(B,-1,1,false);
+      C = A*B;
+      D.setZero();
+      for(uint i=0;i<M;i++) for(uint j=0;j<n[l];j++) for(uint k=0;k<K;k++) D(i,j) += A(i,k)*B(k,j);
+      CHECK_EQ(C.d0, M, "");
+      CHECK_EQ(C.d1, n[l], "");
+      CHECK_ZERO(maxDiff(C,D), 1e-12, "small matrix product differs from the naive product (" <<M <<'x' <<K <<'x' <<n[l] <<')');
+    }
+
+    //column-wise cross products of (3,n) with a 3-vector, also in place
+    arr A(3,n[l]), v(3), C;
+    rndUniform(A,-1,1,false);
+    rndUniform(v,-1,1,false);
+    C = crossProduct(A, v);
+    for(uint j=0;j<n[l];j++) CHECK_ZERO(maxDiff(C.col(j).reshape(3), crossProduct(A.col(j).reshape(3), v)), 1e-12, "column cross product differs");
+    op_crossProduct(A, A, v);
+    CHECK_ZERO(maxDiff(A, C), 1e-12, "in-place column cross product differs");
+  }
+}
+
+//===========================================================================
+
 void TEST(SVD){
   cout <<"\n*** singular value decomposition\n";
   uint m=300,n=100,r=2,svdr;
@@ -934,6 +964,44 @@ void TEST(EigenValues){
 
 //===========================================================================
 
+void TEST(CholeskyUpdate){
+  //incremental row append/remove of an upper Cholesky factor A=U^T U vs. a full refactorization
+  rnd.seed(0);
+  uint n=12;
+  arr C = randn(2*n, n);
+  arr A = ~C*C + eye(n);
+
+  //grow the factor row by row
+  arr U;
+  for(uint i=0; i<n; i++){
+    arr k(i);
+    for(uint j=0; j<i; j++) k(j) = A(j,i);
+    cholesky_appendRow(U, k, A(i,i));
+  }
+  arr U_full;
+  lapack_cholesky(U_full, A);
+  cout <<"append error=" <<maxDiff(U, U_full) <<endl;
+  CHECK_ZERO(maxDiff(U, U_full), 1e-10, "");
+
+  //triangular solves
+  arr b = randn(n), x=b;
+  solve_upperTriangular(x, U, true);
+  solve_upperTriangular(x, U);
+  CHECK_ZERO(maxDiff(A*x, b), 1e-10, "");
+
+  //remove rows/columns (first, middle, last) and compare with refactorizing the reduced matrix
+  for(uint i:{0u, 5u, n-3}){
+    cholesky_removeRow(U, i);
+    A.delRows(i);
+    A.delColumns(i);
+    lapack_cholesky(U_full, A);
+    cout <<"remove " <<i <<" error=" <<maxDiff(U, U_full) <<endl;
+    CHECK_ZERO(maxDiff(U, U_full), 1e-10, "");
+  }
+}
+
+//===========================================================================
+
 int MAIN(int argc, char **argv){
   rai::initCmdLine(argc, argv);
 
@@ -961,10 +1029,12 @@ int MAIN(int argc, char **argv){
   testSparseMatrix();
   testInverse();
   testMM();
+  testFixedMM();
   testSVD();
   testPCA();
   testTensor();
   testGaussElimintation();
+  testCholeskyUpdate();
   
   cout <<"\n ** total memory still allocated = " <<rai::globalMemoryTotal <<endl;
   //CHECK_ZERO(rai::globalMemoryTotal, 0, "memory not released");
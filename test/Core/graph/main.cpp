@@ -161,6 +161,89 @@ void TEST(Manual){
 
 //===========================================================================
 
+void TEST(Archive){
+  rai::Graph G(FILE("example.g"));
+  rai::Graph& data = G.addSubgraph("data", {G.elem(0)});
+  data.add<arr>("X", rand(100, 3));
+  data.add<floatA>("F", floatA{1.f, 2.f, 3.f});
+  data.add<byteA>("img", byteA(4, 5, 3).setZero());
+  data.add<uint16A>("depth", uint16A(8, 6).setZero());
+  data.add<intA>("empty", {});
+  data.add<rai::NodeL>("refs", {G.elem(1), data.elem(0)});
+
+  G.writeArchive("z.archive");
+
+  rai::Graph H, M;
+  H.readArchive("z.archive");
+  M.readArchive("z.archive", true); //zero-copy views into the mapped file
+
+  //round trip: the text format of the original and the archived graphs must agree
+  rai::String g, h, m;
+  g <<G;  h <<H;  m <<M;
+  CHECK_EQ(g, h, "archive round trip failed");
+  CHECK_EQ(g, m, "mapped archive round trip failed");
+  CHECK(M["data"]->graph()["X"]->as<arr>().isReference, "mapped arrays should be views");
+  CHECK_ZERO(maxDiff(G["data"]->graph()["X"]->as<arr>(), M["data"]->graph()["X"]->as<arr>()), 0., "");
+
+  //the mapping is private: views can be written to, without changing the file
+  M["data"]->graph()["X"]->as<arr>()(0, 0) = -1.;
+  rai::Graph K;
+  K.readArchive("z.archive");
+  CHECK_EQ(K["data"]->graph()["X"]->as<arr>()(0, 0), G["data"]->graph()["X"]->as<arr>()(0, 0), "writing into a mapped view changed the file");
+
+  //array records name their element type portably, not by the compiler's mangled typeid name
+  std::stringstream ss;
+  arr{1., 2.}.writeArchive(ss);
+  std::string rec = ss.str();
+  CHECK_EQ(rec.substr(6, rec[5]), std::string("float64"), "");
+  CHECK_EQ(arr().readArchive(ss), arr({1., 2.}), "");
+  cout <<"archive round trip OK" <<endl;
+}
+
+//===========================================================================
+
+void TEST(KeyIndex){
+  //large graphs are searched via a key index: renaming must keep it consistent
+  rai::Graph G;
+  for(uint i=0;i<100;i++) G.add<uint>(STRING('n' <<i), i);
+  G.elem(10)->setKey("dup");
+  G.elem(50)->setKey("dup");
+  CHECK_EQ(G.findNode("n5"), G.elem(5), "");
+  CHECK_EQ(G.findNode("dup"), G.elem(10), "");
+
+  //rename an earlier node to an existing key
+  G.elem(3)->setKey("dup");
+  CHECK_EQ(G.findNode("dup"), G.elem(3), "");
+  CHECK_EQ(G.findNodes("dup"), rai::NodeL({G.elem(3), G.elem(10), G.elem(50)}), "");
+  CHECK(!G.findNode("n3"), "");
+
+  //rename away
+  G.elem(10)->setKey("n10");
+  CHECK_EQ(G.findNodes("dup"), rai::NodeL({G.elem(3), G.elem(50)}), "");
+  CHECK_EQ(G.findNode("n10"), G.elem(10), "");
+
+  //direct write (bypassing setKey) of the first node with that key
+  G.elem(3)->key = "gone";
+  CHECK_EQ(G.findNode("dup"), G.elem(50), "");
+  CHECK_EQ(G.findNode("gone"), G.elem(3), "");
+  G.elem(60)->key = "direct"; //a direct write to a key that was never indexed
+  CHECK_EQ(G.findNode("direct"), G.elem(60), "");
+  CHECK(!G.findNode("n60"), "");
+
+  //misses and appended nodes
+  CHECK(!G.findNode("n100"), "");
+  G.add<uint>("n100", 100);
+  CHECK_EQ(G.findNode("n100"), G.elem(100), "");
+  CHECK_EQ(G.findNodeOfType(typeid(uint), "n100"), G.elem(100), "");
+
+  //unique keys
+  G.checkUniqueKeys(true);
+  CHECK_EQ(G.findNode("dup"), G.elem(50), "");
+  cout <<"key index OK" <<endl;
+}
+
+//===========================================================================
+
 int MAIN(int argc, char** argv){
   rai::initCmdLine(argc, argv);
 
@@ -170,6 +253,8 @@ int MAIN(int argc, char** argv){
   testRead();
   testInit();
   testDot();
+  testArchive();
+  testKeyIndex();
 
   testManual();
 
@@ -1,5 +1,7 @@
 #include <Core/thread.h>
 
+#include <sys/wait.h>
+
 //===========================================================================
 
 void testMetronome(){
@@ -203,6 +205,146 @@ void TEST(Logging){
 
 //===========================================================================
 
+void TEST(ShmVar){
+  Var_shm::unlink("testImage");
+  ShmVar<floatA> img("testImage", 480*640, 4); //create before forking, so that the reader finds it
+
+  pid_t pid = fork();
+  if(!pid) { //reader process
+    ShmVar<floatA> in("testImage");
+    uint n=0, torn=0;
+    double latency=0.;
+    while(n<100) {
+      int rev = in.waitForRevisionGreaterThan(in.last_read_revision, 1.);
+      if(rev<=in.last_read_revision) break; //timeout
+      auto x = in.get(); //zero-copy
+      if(x->N!=480*640 || x->d0!=480 || x.data.elem(-1)!=x.data.elem(0)) torn++;
+      if(!x.valid()) torn++;
+      latency += rai::clockTime()-x.data_time;
+      n++;
+    }
+    cout <<"reader: " <<n <<" images, " <<torn <<" inconsistent, mean latency " <<1e6*latency/n <<"us" <<endl;
+    exit(n<50 || torn ? 1 : 0);
+  }
+
+  rai::wait(.1);
+  for(uint i=1; i<=100; i++) {
+    auto x = img.set({480, 640}); //zero-copy write
+    x->setUni(float(i));
+    rai::wait(.002);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  CHECK(WIFEXITED(status) && !WEXITSTATUS(status), "shared memory reader failed");
+
+  //a writer that crashes within a write leaves the lock held; re-attaching recovers it since the owner is dead
+  pid = fork();
+  if(!pid) { //crashing writer
+    ShmVar<floatA> out("testImage");
+    out.data->beginWrite();
+    _exit(0);
+  }
+  waitpid(pid, &status, 0);
+  ShmVar<floatA> restarted("testImage", 480*640, 4);
+  int rev = restarted.set(floatA(480, 640).setZero()); //would spin forever on the stale lock
+  CHECK_EQ(rev, 101, "");
+
+  //...and writers that stay attached recover it as well
+  pid = fork();
+  if(!pid) {
+    ShmVar<floatA> out("testImage");
+    out.data->beginWrite();
+    _exit(0);
+  }
+  waitpid(pid, &status, 0);
+  rev = img.set(floatA(480, 640).setZero());
+  CHECK_EQ(rev, 102, "");
+
+  //callbacks are called from a listener thread, which the destructor stops also without a further write
+  {
+    std::atomic<int> calls(0);
+    ShmVar<floatA> listened("testImage");
+    listened.addCallback([&calls](Var_shm*, int) { calls++; });
+    for(uint k=0; k<100 && !calls; k++) { restarted.set(floatA(480, 640).setZero()); rai::wait(.01); }
+    CHECK(calls>0, "the listener missed all writes");
+  }
+  for(uint k=0; k<100; k++) {
+    ShmVar<floatA> listened("testImage");
+    listened.addCallback([](Var_shm*, int) {});
+  }
+  Var_shm::unlink("testImage");
+}
+
+//===========================================================================
+
+struct SeqPayload { uint64_t a[16]; };
+
+void TEST(SeqVar){
+  SeqVar<SeqPayload> v;
+
+  //readers never see torn payloads, and revisions never go back
+  std::atomic<bool> stop(false);
+  std::atomic<uint> torn(0), reads(0);
+  std::vector<std::thread> readers;
+  for(uint t=0; t<3; t++) readers.emplace_back([&]() {
+    SeqVar<SeqPayload> in(nullptr, v);
+    int lastRev=0;
+    while(!stop) {
+      SeqPayload x = in.get();
+      for(uint i=1; i<16; i++) if(x.a[i]!=x.a[0]) { torn++; break; }
+      if(in.last_read_revision<lastRev || x.a[0]!=uint64_t(in.last_read_revision)) torn++;
+      lastRev = in.last_read_revision;
+      reads++;
+    }
+  });
+  for(uint k=1; k<=100000; k++) {
+    auto x = v.set();
+    for(uint i=0; i<16; i++) x->a[i]=k;
+  }
+  stop=true;
+  for(std::thread& th:readers) th.join();
+  cout <<"seqlock: " <<reads <<" reads, " <<torn <<" inconsistent" <<endl;
+  CHECK_EQ(torn, 0, "");
+  CHECK_EQ(v.getRevision(), 100000, "");
+
+  //a writer stalled in the middle of a write (odd sequence) does not block readers: they get the previous revision
+  v.data->seq++;
+  SeqPayload x = v.get();
+  CHECK_EQ(x.a[0], 100000, "");
+  CHECK_EQ(v.last_read_revision, 100000, "");
+  v.data->seq--;
+}
+
+//===========================================================================
+
+struct SlowStepThread : Thread {
+  SlowStepThread(double beat) : Thread("SlowStepThread", beat) {}
+  ~SlowStepThread(){ threadClose(); }
+  void step(){ if(step_count%10==5) rai::wait(.025); } //every 10th step takes 2.5 beats
+};
+
+void TEST(ThreadTiming){
+  SlowStepThread th(.01);
+  th.setAffinity({0});
+  th.setRealtime(10); //falls back to normal scheduling (with a warning) if not permitted
+  th.threadLoop();
+  rai::wait(1.);
+  th.threadStop(true);
+  cout <<th.timingReport() <<endl;
+
+  //every wake-up is binned, and the slow steps show up as overruns
+  Metronome& m = th.metronome;
+  uint n=0;
+  for(uint h:m.jitterHist) n+=h;
+  CHECK_EQ(n, m.tics, "");
+  CHECK_GE(m.tics, 50, "");
+  CHECK_GE(m.overruns, 5, "");
+  CHECK_GE(m.jitterMax, .01, "");
+  th.threadClose();
+}
+
+//===========================================================================
+
 int MAIN(int argc,char** argv){
   rai::initCmdLine(argc, argv);
 
@@ -213,6 +355,9 @@ int MAIN(int argc,char** argv){
   testWay0();
   testWay1();
   testLogging();
+  testShmVar();
+  testSeqVar();
+  testThreadTiming();
 
   return 0;
 }
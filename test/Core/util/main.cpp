@@ -2,6 +2,7 @@
 #include <Core/graph.h>
 #include <math.h>
 #include <iomanip>
+#include <thread>
 
 void TEST(String){
   //-- basic IO
@@ -105,6 +106,28 @@ void TEST(Inotify){
   }
 }
 
+void TEST(Profiler){
+  rai::Profiler& P = rai::profiler();
+  P.clear();
+  P.enabled = true;
+  {
+    rai::String empty;
+    rai::ProfileScope prof(empty.p, "empty"); //an empty rai::String has a null buffer
+  }
+  {
+    rai::ProfileScope prof("test", "allocs");
+    for(uint i=0; i<10; i++) { arr x(100); }
+    //allocations of other threads are not counted in this scope
+    std::thread th([]() { for(uint i=0; i<100; i++) { arr y(100); } });
+    th.join();
+  }
+  P.enabled = false;
+  P.report(cout);
+  CHECK_EQ(P.entries.at("|empty").count, 1, "");
+  CHECK_EQ(P.entries.at("test|allocs").allocs, 10, "");
+  P.clear();
+}
+
 int MAIN(int argc,char** argv){
   rai::initCmdLine(argc,argv);
 
@@ -120,6 +143,7 @@ int MAIN(int argc,char** argv){
   testLogging();
   testException();
   testInotify();
+  testProfiler();
 
   return 0;
 }
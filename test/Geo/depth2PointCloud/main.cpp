@@ -0,0 +1,103 @@
+#include <Geo/depth2PointCloud.h>
+
+//===========================================================================
+
+//a random depth image with invalid pixels (zero, negative, NaN, too far), also at the ends of rows
+static floatA randomDepth(uint H, uint W){
+  floatA depth(H, W);
+  for(float& d:depth){
+    double u = rnd.uni();
+    if(u<.1) d = 0.f;
+    else if(u<.15) d = -1.f;
+    else if(u<.2) d = NAN;
+    else if(u<.25) d = 10.f;
+    else d = .5 + 2.*rnd.uni();
+  }
+  for(uint i=0; i<H; i++) depth(i, W-1) = 0.f;
+  return depth;
+}
+
+void TEST(CompactVsDense){
+  uint H=120, W=160;
+  arr Fxy = {300., 310., 80., 60.};
+  floatA depth = randomDepth(H, W);
+
+  arr dense;
+  depthData2pointCloud(dense, depth, Fxy);
+  dense.reshape(H, W, 3);
+
+  for(uint stride:{1u, 2u}) for(uint threads:{1u, 4u}){
+    DepthConversionOptions opt;
+    opt.stride = stride;
+    opt.maxDepth = 5.;
+    opt.threads = threads;
+
+    arr pts;
+    intA pix;
+    uint n = depthData2pointCloud(pts, depth, Fxy, opt, &pix);
+    CHECK_EQ(pts.d0, n, "");
+    CHECK_EQ(pts.d1, 3, "");
+
+    uint valid=0;
+    int last=-1;
+    for(uint i=0; i<H; i++) for(uint j=0; j<W; j++){
+      float d = depth(i, j);
+      bool ok = (i%stride==0 && j%stride==0 && d>0.f && d<=5.f);
+      if(!ok){ CHECK_EQ(pix(i, j), -1, "dropped pixel (" <<i <<',' <<j <<") has a point"); continue; }
+      valid++;
+      int k = pix(i, j);
+      CHECK_EQ(k, last+1, "points are not in pixel order");
+      last = k;
+      CHECK_ZERO(maxDiff(pts[k], dense(i, j, {})), 1e-12, "compact point differs from the dense conversion");
+    }
+    CHECK_EQ(n, valid, "");
+
+    //float output
+    floatA ptsf;
+    CHECK_EQ(depthData2pointCloud(ptsf, depth, Fxy, opt), n, "");
+    for(uint k=0; k<n; k++) for(uint l=0; l<3; l++) CHECK_ZERO(ptsf(k, l)-pts(k, l), 1e-5, "");
+  }
+}
+
+//===========================================================================
+
+void TEST(Voxels){
+  uint H=120, W=160;
+  arr Fxy = {300., 310., 80., 60.};
+  floatA depth = randomDepth(H, W);
+
+  DepthConversionOptions opt;
+  opt.maxDepth = 5.;
+  opt.voxelSize = .05;
+  opt.threads = 4;
+  arr pts, dense;
+  intA pix;
+  uint n = depthData2pointCloud(pts, depth, Fxy, opt, &pix);
+  depthData2pointCloud(dense, depth, Fxy);
+  dense.reshape(H, W, 3);
+
+  //each kept pixel maps to the point of its voxel; all points are in different voxels
+  auto voxel = [&](const arr& p){ return STRING(floor(p(0)/opt.voxelSize) <<' ' <<floor(p(1)/opt.voxelSize) <<' ' <<floor(p(2)/opt.voxelSize)); };
+  StringA voxels(n);
+  for(uint k=0; k<n; k++) voxels(k) = voxel(pts[k]);
+  for(uint i=0; i<H; i++) for(uint j=0; j<W; j++){
+    int k = pix(i, j);
+    if(k<0) continue;
+    CHECK_LE(k, (int)n-1, "");
+    CHECK_EQ(voxel(dense(i, j, {})), voxels(k), "pixel maps to a point of another voxel");
+  }
+  for(uint k=1; k<n; k++) CHECK(!voxels({0, k-1}).contains(voxels(k)), "two points in the same voxel");
+}
+
+//===========================================================================
+
+int MAIN(int argc,char** argv){
+  rai::initCmdLine(argc,argv);
+
+  rnd.seed(0);
+
+  testCompactVsDense();
+  testVoxels();
+
+  return 0;
+}
@@ -253,6 +253,86 @@ void TEST(Threading) {
 
 //===========================================================================
 
+void TEST(WarmStart) {
+  rai::Configuration C(rai::raiPath("../rai-robotModels/tests/arm.g"));
+
+  KOMO komo;
+  komo.opt.verbose = 0;
+  komo.setConfig(C, false);
+  komo.setTiming(1., 10, 2., 2);
+  komo.addControlObjective({}, 2, 1.);
+  komo.addObjective({1.}, FS_positionDiff, {"endeff", "target"}, OT_eq, {1e2});
+  auto ob = komo.addObjective({.5, 1.}, FS_qItself, {}, OT_ineq, {1e0}, {2.});
+
+  komo.run_prepare(0.);
+  komo.run_warmStart();
+  shared_ptr<NLP> nlp = komo.nlp_warm;
+  CHECK(nlp, "");
+  CHECK_EQ(komo.dual.N, nlp->featureTypes.N, "");
+
+  //unchanged problem: the transcription (and dual) is reused
+  komo.run_warmStart();
+  CHECK_EQ(komo.nlp_warm.get(), nlp.get(), "warm start transcription was rebuilt although the problem did not change");
+
+  //removing an objective drops the transcription
+  komo.removeObjective(ob.get());
+  CHECK(!komo.nlp_warm, "removeObjective must reset the warm start");
+  komo.run_warmStart();
+  CHECK_EQ(komo.dual.N, komo.nlp_warm->featureTypes.N, "");
+
+  //a changed grounding (bypassing the KOMO methods) is detected by the feature layout check
+  nlp = komo.nlp_warm;
+  komo.objs.popLast();
+  komo.run_warmStart();
+  CHECK(komo.nlp_warm.get()!=nlp.get(), "stale warm start transcription reused");
+  CHECK_EQ(komo.dual.N, komo.nlp_warm->featureTypes.N, "");
+}
+
+//===========================================================================
+
+void TEST(LazyJacobians) {
+  //inequalities may be evaluated lazily (in JM_noArr mode): every feature must then return the same values
+  rai::Configuration C(rai::raiPath("../rai-robotModels/tests/arm.g"));
+  for(rai::Frame* f:C.frames) if(f->joint) f->joint->limits = {-2., 2.};
+  StringA one = {"endeff"}, two = {"endeff", "target"}, coll = {"arm7", "obstacle"}, all = {};
+  struct Case { FeatureSymbol fs; StringA frames; int maxOrder; };
+  rai::Array<Case> cases = {
+    {FS_position, one, 2}, {FS_quaternion, one, 2}, {FS_pose, one, 2}, {FS_vectorX, one, 2}, {FS_vectorY, one, 2}, {FS_vectorZ, one, 2},
+    {FS_positionDiff, two, 2}, {FS_positionRel, two, 2}, {FS_quaternionDiff, two, 2}, {FS_quaternionRel, two, 2},
+    {FS_poseDiff, two, 2}, {FS_poseRel, two, 2}, {FS_vectorXDiff, two, 2}, {FS_vectorYDiff, two, 2}, {FS_vectorZDiff, two, 2},
+    {FS_scalarProductXX, two, 1}, {FS_scalarProductXY, two, 1}, {FS_scalarProductXZ, two, 1}, {FS_scalarProductYX, two, 1},
+    {FS_scalarProductYY, two, 1}, {FS_scalarProductYZ, two, 1}, {FS_scalarProductZZ, two, 1}, {FS_gazeAt, two, 0},
+    {FS_distance, coll, 0}, {FS_pairCollision_negScalar, coll, 0}, {FS_pairCollision_vector, coll, 0},
+    {FS_pairCollision_normal, coll, 0}, {FS_pairCollision_p1, coll, 0}, {FS_pairCollision_p2, coll, 0},
+    {FS_accumulatedCollisions, all, 0}, {FS_jointLimits, all, 0}, {FS_qItself, all, 2}
+  };
+
+  for(const Case& c:cases) for(int order=0; order<=c.maxOrder; order++) {
+    KOMO komo;
+    komo.opt.verbose = 0;
+    komo.setConfig(C, true);
+    komo.setTiming(1., 4, 1., 2);
+    komo.addObjective({}, c.fs, c.frames, OT_ineq, {}, {}, order);
+    shared_ptr<NLP> nlp = komo.nlp();
+    arr x = nlp->getInitializationSample();
+    rndGauss(x, .1, true);
+    arr phi, J;
+    nlp->evaluate(phi, J, x);
+
+    auto jacMode = komo.pathConfig.jacMode;
+    boolA lazy(phi.N);
+    lazy = true;
+    nlp->setLazyFeatures(lazy);
+    arr phi_lazy, J_lazy;
+    nlp->evaluate(phi_lazy, J_lazy, x);
+    CHECK_ZERO(maxDiff(phi, phi_lazy), 1e-10, "feature " <<c.fs <<" (order " <<order <<") changed its value when evaluated lazily");
+    CHECK_EQ(komo.pathConfig.jacMode, jacMode, "lazy evaluation must restore the Jacobian mode");
+    CHECK(!komo.featureJacobians.N, "lazy rows must not be stored as Jacobian");
+  }
+}
+
+//===========================================================================
+
 int MAIN(int argc,char** argv){
   rai::initCmdLine(argc,argv);
 
@@ -263,6 +343,8 @@ int MAIN(int argc,char** argv){
   testThin();
   testPR2();
   testThreading();
+  testWarmStart();
+  testLazyJacobians();
 
   return 0;
 }
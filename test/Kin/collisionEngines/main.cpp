@@ -2,6 +2,8 @@
 //#include <Kin/kin_swift.h>
 #include <Gui/opengl.h>
 #include <Kin/frame.h>
+#include <Kin/proxy.h>
+#include <Kin/F_collisions.h>
 
 /*void TEST(Swift) {
   rai::Configuration C("swift_test.g");
@@ -101,10 +103,133 @@ void TEST(CollisionTiming){
   cout <<" query time: " <<rai::timerRead(true) <<"sec" <<endl;
 }
 
+void TEST(Broadphase){
+  rai::Configuration C;
+  uint n=300;
+  for(uint i=0;i<n;i++){
+    rai::Frame *a = C.addFrame(STRING("obj_i"<<i));
+    a->setConvexMesh(.2*rai::Mesh().setRandom().V, {}, .02 + .1*rnd.uni());
+    a->setContact(1);
+  }
+
+  for(uint t=0;t<3;t++){
+    for(rai::Frame *a:C.frames){
+      a->setPose(rai::Transformation().setRandom());
+      a->set_X()->pos.z += 1.;
+      a->set_X()->pos *= 3.;
+    }
+
+    rai::timerStart();
+    C.stepBroadphase();
+    double time = rai::timerRead(true);
+
+    //all penetrating pairs must be among the candidates
+    uint penetrations=0, missed=0;
+    for(uint i=0;i<n;i++) for(uint j=0;j<i;j++){
+      rai::Proxy p;
+      p.a = C.frames(i);  p.b = C.frames(j);
+      p.calc_coll();
+      if(p.d>=0.) continue;
+      penetrations++;
+      bool found=false;
+      for(rai::Proxy& q:C.proxies) if((q.a==p.a && q.b==p.b) || (q.a==p.b && q.b==p.a)){ found=true; break; }
+      if(!found) missed++;
+    }
+    cout <<"broadphase: #candidates: " <<C.proxies.N <<" #penetrations: " <<penetrations <<" time: " <<time <<endl;
+    CHECK(!missed, "broadphase missed " <<missed <<" penetrating pairs");
+
+    //the per-frame proxy index lists exactly the proxies involving each frame
+    uint indexed=0;
+    for(rai::Frame *a:C.frames) for(uint i:C.getProxiesOfFrame(a->ID)){
+      CHECK(C.proxies(i).a==a || C.proxies(i).b==a, "");
+      indexed++;
+    }
+    CHECK_EQ(indexed, 2*C.proxies.N, "");
+  }
+
+  //changing shapes or contact flags (without changing the number of frames) rebuilds the broadphase
+  C.frames(1)->setContact(0);
+  C.frames(0)->setShape(rai::ST_sphere, {100.}); //encloses all others
+  C.stepBroadphase();
+  uint withBig=0;
+  for(rai::Proxy& q:C.proxies){
+    CHECK(q.a!=C.frames(1) && q.b!=C.frames(1), "frame without contact in the broadphase");
+    if(q.a==C.frames(0) || q.b==C.frames(0)) withBig++;
+  }
+  CHECK_EQ(withBig, n-2, "broadphase not rebuilt after a shape change");
+
+  //clear drops the broadphase
+  C.clear();
+  for(uint i=0;i<2;i++) C.addFrame(STRING("box"<<i))->setShape(rai::ST_box, {1., 1., 1.}).setContact(1).setPosition({.5*i, 0., 0.});
+  C.stepBroadphase();
+  CHECK_EQ(C.proxies.N, 1, "");
+}
+
+//the original full scan over all proxies, to compare the indexed F_AccumulatedCollisions against
+double accumulatedCollisions_scan(const FrameL& F, double margin, bool selectAll, bool selectXor){
+  rai::Configuration& C = F.first()->C;
+  double y=0.;
+  for(rai::Proxy& p: C.proxies){
+    bool isSelected;
+    if(selectAll) isSelected = (p.a->ID>=F.first()->ID && p.a->ID<=F.last()->ID) || (p.b->ID>=F.first()->ID && p.b->ID<=F.last()->ID);
+    else isSelected = (!selectXor && (F.contains(p.a) || F.contains(p.b))) || (selectXor && (F.contains(p.a) ^ F.contains(p.b)));
+    if(!isSelected) continue;
+    if(p.d > p.a->shape->radius() + p.b->shape->radius() + .01 + margin) continue;
+    if(!p.collision) p.calc_coll();
+    double d = p.collision->getDistance();
+    if(d<=margin) y += margin-d;
+  }
+  return y;
+}
+
+void TEST(AccumulatedCollisions){
+  rai::Configuration C;
+  uint T=3, n=40;
+  for(uint i=0;i<T*n;i++){
+    rai::Frame *a = C.addFrame(STRING("obj_i"<<i));
+    a->setShape(rai::ST_sphere, {.02 + .1*rnd.uni()});
+    a->setContact(1);
+    rai::Vector x;
+    x.setRandom(.8);
+    a->setPosition(x.getArr());
+  }
+  C.stepBroadphase(.1);
+  C.jacMode = C.JM_dense;
+  cout <<"#proxies: " <<C.proxies.N <<endl;
+
+  auto compare = [&C](const FrameL& F, double margin, bool selectAll, bool selectXor){
+    arr y = F_AccumulatedCollisions(margin, selectAll, selectXor).eval(F);
+    double y_scan = accumulatedCollisions_scan(F, margin, selectAll, selectXor);
+    CHECK_ZERO(y.scalar()-y_scan, 1e-10, "indexed and scanned accumulated collisions differ");
+  };
+
+  for(double margin:{0., .05}){
+    //ID ranges, selected by their first and last frame
+    compare({C.frames(5), C.frames(60)}, margin, true, false);
+    compare(C.frames({0, n-1}), margin, true, false);
+
+    //explicit frame sets (unsorted, with duplicates), inclusive and xor
+    FrameL F;
+    for(uint k=0;k<30;k++) F.append(C.frames(rnd(C.frames.N)));
+    compare(F, margin, false, false);
+    compare(F, margin, false, true);
+
+    //single time slices of a path configuration
+    C.frames.reshape(T, n);
+    for(uint t=0;t<T;t++){
+      FrameL Ft = C.frames[t];
+      compare(Ft, margin, true, false);
+    }
+    C.frames.reshape(T*n);
+  }
+}
+
 int MAIN(int argc, char** argv){
   rai::initCmdLine(argc, argv);
 
   //  testSwift();
+  testBroadphase();
+  testAccumulatedCollisions();
   testFCL();
   testCollisionTiming();
 
@@ -69,7 +69,7 @@ void TEST(ViewerUpdate){
 void TEST(Kinematics){
 
   struct MyFct : VectorFunction{
-    enum Mode {Pos, Vec, Quat} mode;
+    enum Mode {Pos, Vec, Quat, Mat} mode;
     rai::Configuration& C;
     rai::Frame *b;
     rai::Vector &vec;
@@ -82,6 +82,7 @@ void TEST(Kinematics){
           case Pos:    C.kinematicsPos(y,J,b,vec); break;
           case Vec:    C.kinematicsVec(y,J,b,vec); break;
           case Quat:   C.kinematicsQuat(y,J,b); break;
+          case Mat:    C.kinematicsMat(y,J,b); break;
         }
         y.J() = J;
         return y;
@@ -99,9 +100,9 @@ void TEST(Kinematics){
 
   C.calc_indexedActiveJoints();
 
-  C.jacMode = C.JM_sparse;
-
-  for(uint k=0;k<10;k++){
+  //the dense mode uses the fixed-size kernels, the sparse one the generic products
+  for(uint k=0;k<20;k++){
+    C.jacMode = (k%2 ? C.JM_dense : C.JM_sparse);
     rai::Frame *b = C.frames.rndElem();
     rai::Vector vec=0, vec2=0;
     vec.setRandom();
@@ -112,6 +113,7 @@ void TEST(Kinematics){
     cout <<"kinematicsPos:   "; checkJacobian(MyFct(MyFct::Pos  , C, b, vec)(), x, 1e-5);
     cout <<"kinematicsVec:   "; checkJacobian(MyFct(MyFct::Vec  , C, b, vec)(), x, 1e-5);
     cout <<"kinematicsQuat:  "; checkJacobian(MyFct(MyFct::Quat , C, b, vec)(), x, 1e-5);
+    cout <<"kinematicsMat:   "; checkJacobian(MyFct(MyFct::Mat  , C, b, vec)(), x, 1e-5);
 
     //checkJacobian(Convert(T1::f_hess, nullptr), x, 1e-5);
   }
@@ -199,6 +201,103 @@ void TEST(Copy){
   cout <<"** copy operator success" <<endl;
 }
 
+//===========================================================================
+//
+// replicating slices in bulk
+//
+
+void TEST(Slices){
+  rai::Configuration C("kinematicTests.g");
+  uint T=5;
+
+  rai::Configuration P1, P2;
+  P1.addCopies(C.frames, C.otherDofs, T);
+  for(uint t=0;t<T;t++) P2.addCopies(C.frames, C.otherDofs);
+  P1.checkConsistency();
+  CHECK_EQ(P1.frames.d0, T, "");
+  CHECK_EQ(P1.frames.d1, C.frames.N, "");
+
+  //same structure as slice-by-slice copies
+  for(uint i=0;i<P1.frames.N;i++){
+    rai::Frame *a=P1.frames.elem(i), *b=P2.frames.elem(i);
+    CHECK_EQ(a->name, b->name, "");
+    CHECK_EQ((a->parent?(int)a->parent->ID:-1), (b->parent?(int)b->parent->ID:-1), "");
+    CHECK_EQ((a->prev?(int)a->prev->ID:-1), (b->prev?(int)b->prev->ID:-1), "");
+    CHECK_EQ(!a->joint, !b->joint, "");
+    if(a->joint) CHECK_EQ(a->joint->type, b->joint->type, "");
+  }
+  CHECK_EQ(P1.getJointStateDimension(), P2.getJointStateDimension(), "");
+  CHECK_ZERO(maxDiff(P1.getFrameState(), P2.getFrameState()), 1e-10, "");
+
+  //shapes share geometry copy-on-write
+  rai::Frame *s0=0, *s1=0;
+  for(uint i=0;i<C.frames.N;i++) if(P1.frames(0,i)->shape && P1.frames(0,i)->shape->_mesh){ s0=P1.frames(0,i); s1=P1.frames(1,i); break; }
+  CHECK(s0, "");
+  CHECK(s0->_bulk && s0->shape->_bulk, "");
+  CHECK_EQ(s0->shape->_mesh, s1->shape->_mesh, "");
+  const rai::Shape& cs0 = *s0->shape;
+  arr color = cs0.mesh().C;
+  CHECK_EQ(s0->shape->_mesh, s1->shape->_mesh, "const access must not detach");
+  s1->setColor({1.,0.,0.});
+  CHECK(s0->shape->_mesh!=s1->shape->_mesh, "");
+  CHECK_EQ(cs0.mesh().C, color, "");
+  CHECK_EQ(s1->shape->mesh().C, arr({1.,0.,0.}), "");
+
+  //direct writes through the mutable accessors detach as well
+  rai::Frame *s2=P1.frames(2, s0->ID);
+  CHECK_EQ(s0->shape->_mesh, s2->shape->_mesh, "");
+  s2->getShape().mesh().C = arr{0.,1.,0.};
+  CHECK_EQ(cs0.mesh().C, color, "");
+
+  //bulk-placed frames can be deleted individually
+  delete P1.frames.elem(-1);
+  P1.checkConsistency();
+}
+
+void TEST(FrameNames){
+  //large configurations are searched via a name index: renaming must keep it consistent
+  rai::Configuration C;
+  for(uint i=0;i<100;i++) C.addFrame(STRING('f' <<i));
+  C.frames(10)->setName("dup");
+  C.frames(50)->setName("dup");
+  CHECK_EQ(C.getFrame("f5"), C.frames(5), "");
+  CHECK_EQ(C.getFrame("dup"), C.frames(10), "");
+  CHECK_EQ(C.getFrame("dup", true, true), C.frames(50), "");
+
+  //rename an earlier frame to an existing name
+  C.frames(3)->setName("dup");
+  CHECK_EQ(C.getFrame("dup"), C.frames(3), "");
+  CHECK(!C.getFrame("f3", false), "");
+
+  //make names unique: later duplicates are renamed
+  C.checkUniqueNames(true);
+  CHECK_EQ(C.getFrame("dup"), C.frames(3), "");
+  CHECK_EQ(C.getFrame("dup", true, true), C.frames(3), "");
+  CHECK_EQ(C.getFrame(STRING("dup_" <<50)), C.frames(50), "");
+
+  //direct writes (bypassing setName) are found as well
+  C.frames(7)->name = "direct";
+  CHECK_EQ(C.getFrame("direct"), C.frames(7), "");
+  CHECK(!C.getFrame("f7", false), "");
+
+  //prefixes and deletion
+  C.frames(20)->prefixSubtree("pre_");
+  CHECK_EQ(C.getFrame("pre_f20"), C.frames(20), "");
+  CHECK(!C.getFrame("f20", false), "");
+  delete C.frames(5);
+  CHECK(!C.getFrame("f5", false), "");
+  CHECK_EQ(C.getFrame("f6")->ID, 5, "");
+
+  //deleting the last frame only drops its own entry
+  delete C.frames.last();
+  CHECK(!C.getFrame("f99", false), "");
+  CHECK_EQ(C.getFrame("f98"), C.frames.last(), "");
+  C.addFrame("f99");
+  CHECK_EQ(C.getFrame("f99"), C.frames.last(), "");
+  C.clear();
+  CHECK(!C.getFrame("f6", false), "");
+}
+
 //===========================================================================
 //
 // Kinematic speed test
@@ -646,6 +745,8 @@ int MAIN(int argc,char **argv){
 
   testLoadSave();
   testCopy();
+  testSlices();
+  testFrameNames();
   testGraph();
   testPlayStateSequence();
   testViewerUpdate();
@@ -0,0 +1,53 @@
+QUIT
+WAIT
+Terminate
+
+FOL_World{
+  hasWait=false
+  gamma = 1.
+  stepCost = 1.
+  timeCost = 0.
+}
+
+## basic predicates
+block
+table
+clear
+on
+
+## constants
+a
+b
+c
+t
+
+## initial state
+START_STATE {
+  (block a) (block b) (block c) (table t)
+  (on a t) (on b t) (on c t)
+  (clear a) (clear b) (clear c)
+}
+
+REWARD {
+}
+
+### RULES
+
+DecisionRule stack {
+  X, Y, Z
+  { (block X) (clear X) (on X Z) (block Y) (clear Y) }
+  { (on X Z)! (on X Y) (clear Y)! (clear Z) }
+}
+
+DecisionRule unstack {
+  X, Y, T
+  { (block X) (clear X) (on X Y) (block Y) (table T) }
+  { (on X Y)! (on X T) (clear Y) }
+}
+
+### terminal
+
+Rule done {
+  { (on a b) (on b c) }
+  { (QUIT) }
+}
@@ -0,0 +1,78 @@
+#include <Logic/folWorld.h>
+#include <MCTS/solver_PlainMC.h>
+#include <MCTS/solver_marc.h>
+
+//===========================================================================
+
+void TEST(Clone){
+  rai::FOL_World W("blocks.g");
+  W.reset_state();
+  std::shared_ptr<rai::TreeSearchDomain> C = W.clone();
+  C->reset_state();
+
+  //the clone lists the same actions in the same order and yields the same transitions
+  for(uint t=0; t<30 && !W.is_terminal_state(); t++){
+    auto A = W.get_actions();
+    auto B = C->get_actions();
+    CHECK_EQ(A.N, B.N, "");
+    CHECK(A.N, "");
+    for(uint i=0; i<A.N; i++) CHECK_EQ(STRING(*A(i)), STRING(*B(i)), "");
+    uint i = rnd(A.N);
+    CHECK_EQ(W.transition(A(i)).reward, C->transition(B(i)).reward, "");
+    CHECK_EQ(W.is_terminal_state(), C->is_terminal_state(), "");
+  }
+}
+
+//===========================================================================
+
+void TEST(PlainMCDeterminism){
+  rai::FOL_World W("blocks.g");
+  W.reset_state();
+
+  rai::Array<MCStatistics> D[2];
+  for(uint k=0; k<2; k++){
+    PlainMC MC(W);
+    MC.verbose = 0;
+    MC.addRollouts(40, 4, 30, 123);
+    CHECK_EQ(MC.Droot.n, 40, "");
+    D[k] = MC.D;
+  }
+  CHECK_EQ(D[0].N, D[1].N, "");
+  for(uint a=0; a<D[0].N; a++){
+    CHECK_EQ(D[0](a).n, D[1](a).n, "");
+    CHECK_EQ(D[0](a).X, D[1](a).X, "");
+  }
+}
+
+//===========================================================================
+
+void TEST(MCTSDeterminism){
+  rai::FOL_World W("blocks.g");
+
+  arr Q[2];
+  uint nodes[2];
+  for(uint k=0; k<2; k++){
+    MCTS M(W);
+    M.verbose = 0;
+    M.addRollouts(60, 4, 30, 123);
+    CHECK_EQ(M.root.N, 60, "");
+    Q[k] = M.Qfunction();
+    nodes[k] = M.Nnodes();
+  }
+  CHECK_EQ(nodes[0], nodes[1], "");
+  CHECK_ZERO(maxDiff(Q[0], Q[1]), 0., "");
+}
+
+//===========================================================================
+
+int MAIN(int argc,char** argv){
+  rai::initCmdLine(argc,argv);
+
+  rnd.seed(0);
+
+  testClone();
+  testPlainMCDeterminism();
+  testMCTSDeterminism();
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include <Optim/BayesOpt.h>
+#include <Optim/RidgeRegression.h>
+
+#include <math.h>
+
+//===========================================================================
+
+//kernel ridge regression solved from scratch with the dense kernel matrix
+struct DenseKRR {
+  arr X, Kinv, alpha;
+  double mu, priorVar;
+  KernelFunction& kernel;
+  DenseKRR(const arr& _X, const arr& y, KernelFunction& _kernel, double lambda, double _mu, double _priorVar)
+    : X(_X), mu(_mu), priorVar(_priorVar), kernel(_kernel) {
+    arr K(X.d0, X.d0);
+    for(uint i=0; i<X.d0; i++) for(uint j=0; j<X.d0; j++) K(i, j) = kernel.k(X[i], X[j]);
+    K += lambda*eye(X.d0);
+    Kinv = inverse_SymPosDef(K);
+    alpha = Kinv*(y-mu);
+  }
+  double mean(const arr& x) {
+    arr kappa(X.d0);
+    for(uint i=0; i<X.d0; i++) kappa(i) = kernel.k(x, X[i]);
+    return mu + scalarProduct(kappa, alpha);
+  }
+  double var(const arr& x) {
+    arr kappa(X.d0);
+    for(uint i=0; i<X.d0; i++) kappa(i) = kernel.k(x, X[i]);
+    return priorVar*(kernel.k(x, x) - scalarProduct(kappa, Kinv*kappa));
+  }
+  //f(x) + plusSigma*sigma(x) and its gradient (stationary kernel: k(x,x) is constant)
+  double f(arr& g, const arr& x, double plusSigma) {
+    arr kappa(X.d0), J(X.d0, x.N);
+    for(uint i=0; i<X.d0; i++) kappa(i) = kernel.k(x, X[i], J[i].noconst(), NoArr);
+    arr Kinv_k = Kinv*kappa;
+    double s = ::sqrt(priorVar*(kernel.k(x, x) - scalarProduct(kappa, Kinv_k)));
+    if(!!g) g = ~J*alpha - (plusSigma*priorVar/s) * (~J*Kinv_k);
+    return mu + scalarProduct(kappa, alpha) + plusSigma*s;
+  }
+  //Hessian by central differences of the gradient
+  arr H(const arr& x, double plusSigma) {
+    double eps=1e-5;
+    arr H(x.N, x.N), g1, g2;
+    for(uint i=0; i<x.N; i++) {
+      arr x1=x, x2=x;
+      x1(i) += eps;  x2(i) -= eps;
+      f(g1, x1, plusSigma);
+      f(g2, x2, plusSigma);
+      H[i] = (g1-g2)/(2.*eps);
+    }
+    return .5*(H+~H);
+  }
+};
+
+//===========================================================================
+
+void TEST(KernelRidgeRegression){
+  rnd.seed(0);
+  DefaultKernelFunction kernel(DefaultKernelFunction::Gauss);
+  kernel.hyperParam1 = arr{.5};
+  kernel.hyperParam2 = arr{1.};
+  double lambda=1e-3;
+
+  arr X = rand(30, 2);
+  arr y = sin(3.*X.col(0)) + X.col(1);
+
+  //build from a few points, then append the rest and change the bias
+  KernelRidgeRegression f(X({0, 9}), y({0, 9}), kernel, lambda, 0.);
+  for(uint i=10; i<X.d0; i++) f.append(X[i], y(i));
+  double mu = sum(y)/y.N;
+  f.setMu(mu);
+  f.priorVar = 2.;
+
+  DenseKRR D(X, y, kernel, lambda, mu, f.priorVar);
+  CHECK_ZERO(maxDiff(f.alpha, D.alpha), 1e-6, "incremental weights differ from the dense solve");
+
+  //batched mean and variance
+  arr Z = 1.2*rand(50, 2) - .1;
+  arr s2;
+  arr fZ = f.evaluate(Z, s2);
+  for(uint i=0; i<Z.d0; i++) {
+    CHECK_ZERO(fZ(i)-D.mean(Z[i]), 1e-8, "batched mean differs from the dense solve");
+    CHECK_ZERO(s2(i)-D.var(Z[i]), 1e-8, "batched variance differs from the dense solve");
+  }
+
+  //value, gradient and Hessian of the acquisition function
+  for(double plusSigma: {0., 1., -2.}) {
+    for(uint i=0; i<10; i++) {
+      arr x = Z[i], g, H, gD;
+      double fx = f.evaluate(x, g, H, plusSigma, false);
+      CHECK_ZERO(fx-D.f(gD, x, plusSigma), 1e-8, "value differs from the dense solve");
+      CHECK_ZERO(maxDiff(g, gD), 1e-6, "gradient differs from the dense solve");
+      CHECK_ZERO(maxDiff(H, D.H(x, plusSigma)), 1e-4, "Hessian differs from the dense solve");
+    }
+  }
+  cout <<"incremental kernel ridge regression OK" <<endl;
+}
+
+//===========================================================================
+
+void TEST(BayesOpt){
+  rnd.seed(0);
+  //a multi-modal 1D function, so that the smaller length scale eventually wins
+  ScalarFunction fct = [](arr& g, arr& H, const arr& x) -> double {
+    if(!!g) NIY;
+    if(!!H) NIY;
+    return ::sin(12.*x(0)) + .5*x(0)*x(0);
+  };
+
+  rai::setParameter<double>("lambda", 1e-6); //regularize the regressions, so that the dense reference is well-conditioned
+  BayesOpt bo(fct, {-1.}, {1.}, .5, 1.);
+  bo.threads = 4; //parallel acquisition
+  double lengthScale0 = bo.kernel_now->hyperParam1.scalar();
+  uint reductions=0;
+  for(uint t=0; t<40; t++) {
+    double lengthScale = bo.kernel_now->hyperParam1.scalar();
+    bo.step();
+    if(bo.kernel_now->hyperParam1.scalar()<lengthScale) reductions++;
+
+    //both regressions, updated incrementally (and rebuilt after a reduction), agree with a fresh fit on all data
+    double mu = sum(bo.data_y)/bo.data_y.N;
+    for(KernelRidgeRegression* f: {bo.f_now, bo.f_smaller}) {
+      CHECK_EQ(f->X.d0, bo.data_X.d0, "");
+      DenseKRR D(bo.data_X, bo.data_y, f->kernel, f->lambda, mu, bo.priorVar);
+      CHECK_ZERO(f->mu-mu, 1e-10, "");
+      CHECK_ZERO(f->priorVar-bo.priorVar, 1e-10, "");
+      for(double x=-1.; x<=1.; x+=.1) {
+        CHECK_ZERO(f->evaluate(arr{x}, NoArr, NoArr, 0., false)-D.mean(arr{x}), 1e-5, "regression differs from a fresh fit");
+      }
+    }
+    CHECK_ZERO(bo.kernel_smaller->hyperParam1.scalar() - .5*bo.kernel_now->hyperParam1.scalar(), 1e-10, "");
+  }
+  CHECK(reductions>0, "the length scale was never reduced");
+
+  //the parallel acquisition merges the local optima in order: serial runs pick the same points
+  rnd.seed(0);
+  BayesOpt serial(fct, {-1.}, {1.}, .5, 1.);
+  serial.threads = 1;
+  for(uint t=0; t<40; t++) serial.step();
+  CHECK_ZERO(maxDiff(serial.data_X, bo.data_X), 1e-10, "parallel and serial acquisition differ");
+  cout <<"BayesOpt: " <<reductions <<" length scale reductions, from " <<lengthScale0 <<" to " <<bo.kernel_now->hyperParam1.scalar()
+       <<", best f=" <<min(bo.data_y) <<endl;
+}
+
+//===========================================================================
+
+int MAIN(int argc, char** argv){
+  rai::initCmdLine(argc, argv);
+
+  testKernelRidgeRegression();
+  testBayesOpt();
+
+  return 0;
+}
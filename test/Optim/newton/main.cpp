@@ -0,0 +1,125 @@
+#include <Optim/newton.h>
+
+#include <math.h>
+
+//===========================================================================
+
+//a random, well-conditioned quadratic f(x) = 1/2 x^T A x - b^T x
+struct Quadratic {
+  arr A, b;
+  Quadratic(uint n){
+    arr M = randn(n, n);
+    A = ~M*M + double(n)*eye(n);
+    b = randn(n);
+  }
+  ScalarFunction f(){
+    return [this](arr& g, arr& H, const arr& x) -> double {
+      if(!!g) g = A*x - b;
+      if(!!H) H = A;
+      return .5*scalarProduct(x, A*x) - scalarProduct(b, x);
+    };
+  }
+};
+
+//===========================================================================
+
+void TEST(LBFGS){
+  rnd.seed(0);
+  Quadratic Q(20);
+  arr x_opt = lapack_Ainv_b_sym(Q.A, Q.b);
+
+  rai::OptOptions opt;
+  opt.stopTolerance = 1e-8;
+  opt.stopEvals = 10000;
+  opt.stopIters = 10000;
+  opt.verbose = 0;
+
+  arr x = zeros(Q.b.N);
+  OptNewton newton(x, Q.f(), opt);
+  newton.run();
+
+  arr y = zeros(Q.b.N);
+  OptNewton lbfgs(y, Q.f(), opt);
+  lbfgs.setLBFGS(5);
+  lbfgs.run();
+
+  cout <<"Newton: its=" <<newton.its <<" |x-x*|=" <<length(x-x_opt)
+       <<"\nL-BFGS: its=" <<lbfgs.its <<" |x-x*|=" <<length(y-x_opt) <<endl;
+  CHECK_ZERO(length(x-x_opt), 1e-6, "Newton did not converge");
+  CHECK_ZERO(length(y-x_opt), 1e-5, "L-BFGS did not converge to the Newton solution");
+  CHECK(!lbfgs.Hx.N, "L-BFGS must not query Hessians");
+
+  //with bounds: both agree on the projected optimum
+  arr lo = -.05*ones(Q.b.N), up = .05*ones(Q.b.N);
+  x = zeros(Q.b.N);
+  OptNewton newtonB(x, Q.f(), opt);
+  newtonB.setBounds(lo, up).run();
+  y = zeros(Q.b.N);
+  OptNewton lbfgsB(y, Q.f(), opt);
+  lbfgsB.setBounds(lo, up).setLBFGS(5).run();
+  cout <<"bounded: f_Newton=" <<newtonB.fx <<" f_LBFGS=" <<lbfgsB.fx <<" |x-y|=" <<length(x-y) <<endl;
+  CHECK_ZERO(newtonB.fx-lbfgsB.fx, 1e-6, "");
+}
+
+//===========================================================================
+
+void TEST(PCG){
+  //least squares |J x - y|^2 with a sparse J: matrix-free steps get the Gauss-Newton factor R=sqrt(2) J
+  rnd.seed(0);
+  uint n=10;
+  arr J = randn(3*n, n);
+  for(double& a:J) if(rnd.uni()<.5) a=0.;
+  for(uint i=0; i<n; i++) J(i, i) = 1.; //full column rank
+  arr y = 1e-4*randn(3*n);
+  arr Js;
+  Js.sparse().setFromDense(J);
+
+  auto f = [&J, &Js, &y](bool sparse) -> ScalarFunction {
+    return [&J, &Js, &y, sparse](arr& g, arr& H, const arr& x) -> double {
+      arr phi = J*x - y;
+      if(!!g) g = 2.*(~J*phi);
+      if(!!H) { if(sparse) H = ::sqrt(2.)*Js; else H = ::sqrt(2.)*J; }
+      return sumOfSqr(phi);
+    };
+  };
+
+  //Cholesky direction at x=0
+  arr H = 2.*(~J*J);
+  arr g = -2.*(~J*y);
+  arr U;
+  lapack_cholesky(U, H);
+  arr Delta = lapack_Ainv_b_symPosDef_givenCholesky(U, -g);
+
+  rai::OptOptions opt;
+  opt.damping = 0.;
+  opt.maxStep = -1.;
+  opt.stopTolerance = 1e-10;
+  opt.verbose = 0;
+
+  for(bool sparse:{false, true}) {
+    //one step from zero with alpha=1 moves exactly along the PCG direction
+    arr x = zeros(n);
+    OptNewton newton(x, f(sparse), opt);
+    newton.setMatrixFree();
+    newton.step();
+    double eta = rai::MIN(.5, ::sqrt(length(g)));
+    cout <<(sparse?"sparse":"dense") <<" PCG: its=" <<newton.pcgIters <<" |Delta_pcg-Delta_chol|/|Delta_chol|=" <<length(x-Delta)/length(Delta) <<" eta=" <<eta <<endl;
+    CHECK_LE(length(H*x+g), eta*length(g)+1e-12, "PCG direction violates its forcing tolerance");
+    CHECK_LE(length(x-Delta), 10.*eta*length(Delta), "PCG direction differs from the Cholesky direction");
+
+    //the inexact steps converge to the exact solution
+    newton.run();
+    CHECK_ZERO(length(x-Delta), 1e-8, "");
+  }
+}
+
+//===========================================================================
+
+int MAIN(int argc,char** argv){
+  rai::initCmdLine(argc,argv);
+
+  testLBFGS();
+  testPCG();
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include <Optim/NLP_Trace.h>
+#include <Optim/benchmarks.h>
+
+//===========================================================================
+
+void TEST(StreamRoundTrip){
+  //the same evaluations traced in memory and streamed to file
+  shared_ptr<NLP> P = make_shared<NLP_TrivialSquareFunction>(5);
+  NLP_Traced mem(P), str(P);
+  mem.setTracing(true, true, true, true);
+  str.setTracing(true, true, true, true);
+  str.setStream("z.trace.bin");
+
+  arr phi, J;
+  for(uint k=0; k<20; k++){
+    arr x = randn(5);
+    mem.evaluate(phi, J, x);
+    str.evaluate(phi, J, x);
+  }
+
+  str.syncTrace();
+  CHECK_EQ(str.xTrace.d0, 20, "");
+  CHECK_ZERO(maxDiff(str.xTrace, mem.xTrace), 0., "");
+  CHECK_ZERO(maxDiff(str.costTrace, mem.costTrace), 0., "");
+  CHECK_ZERO(maxDiff(str.phiTrace, mem.phiTrace), 0., "");
+  CHECK_ZERO(maxDiff(str.JTrace, mem.JTrace), 0., "");
+
+  //without new records, syncTrace keeps the replayed arrays
+  str.xTrace.clear();
+  str.syncTrace();
+  CHECK_EQ(str.xTrace.N, 0, "");
+  str.evaluate(phi, J, zeros(5));
+  str.syncTrace();
+  CHECK_EQ(str.xTrace.d0, 21, "");
+}
+
+//===========================================================================
+
+void TEST(SparseAndTruncated){
+  arr J = randn(4, 3);
+  J(1, 2) = J(3, 0) = 0.;
+  arr Js;
+  Js.sparse().setFromDense(J);
+
+  {
+    NLP_TraceStream S("z.trace.bin");
+    for(uint k=0; k<3; k++) S.record(k, arr{1., 2., double(k)}, NoArr, arr{double(k)}, Js);
+  }
+  NLP_TraceReader R("z.trace.bin");
+  CHECK_EQ(R.evals.N, 3, "");
+  CHECK_EQ(R.x.d0, 3, "");
+  CHECK_EQ(R.costs.N, 0, "");
+  CHECK_EQ(R.J.nd, 3, "");
+  for(uint k=0; k<3; k++) CHECK_ZERO(maxDiff(R.J[k], J), 0., "");
+
+  //cut the last record in the middle of its Jacobian: the reader drops it in all arrays
+  std::ifstream is("z.trace.bin", std::ios::binary);
+  std::string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  std::ofstream("z.trace.bin", std::ios::binary).write(data.data(), data.size()-20);
+  NLP_TraceReader T("z.trace.bin");
+  CHECK_EQ(T.evals.N, 2, "");
+  CHECK_EQ(T.x.d0, 2, "");
+  CHECK_EQ(T.phi.d0, 2, "");
+  CHECK_EQ(T.J.d0, 2, "");
+  CHECK_ZERO(maxDiff(T.x, R.x({0, 1})), 0., "");
+}
+
+//===========================================================================
+
+void TEST(Ring){
+  {
+    NLP_TraceStream S("z.trace.bin", 3);
+    for(uint k=0; k<10; k++) S.record(k, arr{double(k)}, NoArr, NoArr, NoArr);
+  }
+  NLP_TraceReader R("z.trace.bin");
+  CHECK_EQ(R.evals, uintA({7, 8, 9}), "");
+  CHECK_ZERO(maxDiff(R.x, arr{7., 8., 9.}.reshape(3, 1)), 0., "");
+}
+
+//===========================================================================
+
+int MAIN(int argc,char** argv){
+  rai::initCmdLine(argc,argv);
+
+  rnd.seed(0);
+
+  testStreamRoundTrip();
+  testSparseAndTruncated();
+  testRing();
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <Perception/surfels.h>
+
+//===========================================================================
+
+//adds n points of an anisotropic Gaussian with standard deviations sig (rotated by a random orthonormal R) to s
+static arr addGaussianPoints(SurfelStatistics& s, uint n, const arr& mean, const arr& sig, arr& R){
+  arr Q, d, V;
+  svd(Q, d, V, randn(3, 3));
+  R = Q;
+  arr X = randn(n, 3);
+  for(uint i=0; i<n; i++){
+    for(uint j=0; j<3; j++) X(i, j) *= sig(j);
+    X[i] = mean + R*X[i];
+    s.add(X(i, 0), X(i, 1), X(i, 2), 0.f, 0.f, 0.f);
+  }
+  return X;
+}
+
+void TEST(SurfelEig){
+  for(uint k=0; k<100; k++){
+    SurfelStatistics s;
+    arr R;
+    arr sig = {1e-2, 5e-3, 1e-4};
+    if(k%10==0) sig = {1e-2, 1e-2, 1e-3}; //nearly degenerate largest pair
+    arr X = addGaussianPoints(s, 200, randn(3), sig, R);
+
+    //reference: eigen decomposition of the covariance of the (float) points
+    arr Xf(X.d0, 3);
+    for(uint i=0; i<X.N; i++) Xf.elem(i) = float(X.elem(i));
+    arr mu = sum(Xf, 0)/double(Xf.d0);
+    arr C = ~Xf*Xf/double(Xf.d0) - (mu^mu);
+    arr evals, evecs;
+    lapack_EigenDecomp(C, evals, evecs); //ascending
+
+    float lambda[3], nx, ny, nz;
+    s.eig(lambda, nx, ny, nz);
+    double scale = evals(2);
+    CHECK_ZERO((lambda[0]-evals(2))/scale, 1e-3, "");
+    CHECK_ZERO((lambda[1]-evals(1))/scale, 1e-3, "");
+    CHECK_ZERO((lambda[2]-evals(0))/scale, 1e-3, "");
+    arr n = {nx, ny, nz};
+    CHECK_ZERO(length(n)-1., 1e-5, "");
+    CHECK_ZERO(::fabs(scalarProduct(n, evecs[0]))-1., 1e-3, "normal is not the eigenvector of the smallest eigenvalue");
+  }
+
+  //diagonal covariance
+  SurfelStatistics s;
+  for(int i=-1; i<=1; i+=2) for(int j=-1; j<=1; j+=2){ s.add(2.*i, j, 0., 0.f, 0.f, 0.f); }
+  float lambda[3], nx, ny, nz;
+  s.eig(lambda, nx, ny, nz);
+  CHECK_ZERO(lambda[0]-4., 1e-6, "");
+  CHECK_ZERO(lambda[1]-1., 1e-6, "");
+  CHECK_ZERO(lambda[2], 1e-6, "");
+  CHECK_ZERO(::fabs(nz)-1., 1e-6, "");
+
+  //a single point is degenerate
+  SurfelStatistics p;
+  p.add(1., 2., 3., 0.f, 0.f, 0.f);
+  p.eig(lambda, nx, ny, nz);
+  CHECK_EQ(nz, 1.f, "");
+}
+
+//===========================================================================
+
+//points on the plane z = .3 + .2 x, densely sampled on [0,1]^2
+static arr planePoints(uint n){
+  arr X = rand(n, 3);
+  for(uint i=0; i<n; i++) X(i, 2) = .3 + .2*X(i, 0);
+  return X;
+}
+
+void TEST(SurfelMap){
+  arr X = planePoints(200000);
+  arr viewPoint = {.5, .5, 2.};
+  arr n0 = {-.2, 0., 1.};
+  n0 /= length(n0);
+
+  SurfelMap M;
+  M.voxelSize = .05;
+  M.minCount = 20.;
+  M.threads = 1;
+  M.integrate(X, NoArr, viewPoint);
+
+  arr pos, norm, col, rad;
+  M.getSurfels(pos, norm, col, rad);
+  CHECK_GE(pos.d0, M.N()/2, "most surfels of a plane are planar");
+  for(uint i=0; i<pos.d0; i++){
+    CHECK_ZERO(pos(i, 2) - (.3 + .2*pos(i, 0)), 1e-4, "surfel is not on the plane");
+    CHECK_ZERO(scalarProduct(norm[i], n0)-1., 1e-3, "normal is not the plane normal (oriented towards the view point)");
+    CHECK_LE(rad(i), M.voxelSize, "");
+  }
+
+  //the map does not depend on the thread count
+  SurfelMap M4;
+  M4.voxelSize = M.voxelSize;
+  M4.minCount = M.minCount;
+  M4.threads = 4;
+  M4.integrate(X, NoArr, viewPoint);
+  arr pos4, norm4, col4, rad4;
+  M4.getSurfels(pos4, norm4, col4, rad4);
+  CHECK_EQ(M4.N(), M.N(), "");
+  CHECK_ZERO(maxDiff(pos4, pos), 1e-12, "");
+  CHECK_ZERO(maxDiff(norm4, norm), 1e-12, "");
+
+  //a second cloud of the same plane is fused into the same surfels, keeping the normals' orientation
+  uint N = M.N();
+  M.integrate(planePoints(200000), NoArr, -viewPoint);
+  CHECK_EQ(M.N(), N, "");
+  M.getSurfels(pos, norm, col, rad);
+  for(uint i=0; i<pos.d0; i++) CHECK_ZERO(scalarProduct(norm[i], n0)-1., 1e-3, "");
+
+  //surfels not seen for maxAge frames are removed
+  M.maxAge = 2;
+  arr Y = planePoints(1000);
+  Y += 10.;
+  for(uint k=0; k<3; k++) M.integrate(Y, NoArr, viewPoint);
+  SurfelMap MY;
+  MY.voxelSize = M.voxelSize;
+  MY.integrate(Y);
+  CHECK_EQ(M.N(), MY.N(), "only the surfels of the new cloud should remain");
+}
+
+//===========================================================================
+
+int MAIN(int argc,char** argv){
+  rai::initCmdLine(argc,argv);
+
+  rnd.seed(0);
+
+  testSurfelEig();
+  testSurfelMap();
+
+  return 0;
+}